@@ -1352,6 +1352,118 @@ namespace ngbla
   }
 
 
+
+  /* ******************** Schur complement in SIMD lanes ******************** */
+
+  SIMD<double> CalcSchurComplement (SliceMatrix<SIMD<double>> a, size_t nouter, bool inverse)
+  {
+    constexpr size_t BS = 4;
+    size_t n = a.Height();
+    SIMD<double> minpiv(1.0);
+    SIMD<double> dinv[BS][BS], tmp[BS];
+
+    // block Gauss-Jordan, the pivot blocks are taken from the end
+    for (size_t k1 = n; k1 > nouter; )
+      {
+        size_t k0 = (k1 >= nouter+BS) ? k1-BS : nouter;
+        size_t bs = k1-k0;
+        // the not yet eliminated rows and columns, and the eliminated ones for the inverse
+        IntRange rest[2] = { IntRange(0,k0), inverse ? IntRange(k1,n) : IntRange(n,n) };
+
+        for (size_t q = 0; q < bs; q++)
+          {
+            tmp[q] = SIMD<double>(0.0);
+            for (size_t j = 0; j < (inverse ? n : k1); j++)
+              tmp[q] = IfPos (fabs(a(k0+q,j))-tmp[q], fabs(a(k0+q,j)), tmp[q]);
+            for (size_t r = 0; r < bs; r++)
+              dinv[q][r] = a(k0+q,k0+r);
+          }
+
+        for (size_t p = 0; p < bs; p++)
+          {
+            SIMD<double> piv = dinv[p][p];
+            SIMD<double> rel = fabs(piv) / tmp[p];
+            // a NaN from a zero row survives
+            minpiv = IfPos (rel-minpiv, minpiv, rel);
+            SIMD<double> inv = 1.0 / piv;
+            for (size_t i = 0; i < bs; i++)
+              if (i != p)
+                {
+                  SIMD<double> f = dinv[i][p] * inv;
+                  for (size_t j = 0; j < bs; j++)
+                    if (j != p)
+                      dinv[i][j] -= f * dinv[p][j];
+                  dinv[i][p] = -f;
+                }
+            for (size_t j = 0; j < bs; j++)
+              dinv[p][j] *= inv;
+            dinv[p][p] = inv;
+          }
+
+        // rows of the pivot block: R = D^{-1} C
+        for (IntRange rj : rest)
+          for (size_t j : rj)
+            {
+              for (size_t q = 0; q < bs; q++)
+                tmp[q] = a(k0+q,j);
+              for (size_t q = 0; q < bs; q++)
+                {
+                  SIMD<double> sum(0.0);
+                  for (size_t r = 0; r < bs; r++)
+                    sum += dinv[q][r] * tmp[r];
+                  a(k0+q,j) = sum;
+                }
+            }
+
+        // A -= B R
+        for (IntRange ri : rest)
+          for (size_t i : ri)
+            for (IntRange rj : rest)
+              {
+                SIMD<double> * pa = &a(i,0);
+                if (bs == BS)
+                  {
+                    SIMD<double> f0 = a(i,k0), f1 = a(i,k0+1), f2 = a(i,k0+2), f3 = a(i,k0+3);
+                    SIMD<double> * pu0 = &a(k0,0), * pu1 = &a(k0+1,0), * pu2 = &a(k0+2,0), * pu3 = &a(k0+3,0);
+                    for (size_t j : rj)
+                      pa[j] -= f0 * pu0[j] + f1 * pu1[j] + f2 * pu2[j] + f3 * pu3[j];
+                  }
+                else
+                  for (size_t q = 0; q < bs; q++)
+                    {
+                      SIMD<double> f = a(i,k0+q);
+                      SIMD<double> * pu = &a(k0+q,0);
+                      for (size_t j : rj)
+                        pa[j] -= f * pu[j];
+                    }
+              }
+
+        if (inverse)
+          {
+            // columns of the pivot block: -B D^{-1}
+            for (IntRange ri : rest)
+              for (size_t i : ri)
+                {
+                  for (size_t q = 0; q < bs; q++)
+                    tmp[q] = a(i,k0+q);
+                  for (size_t q = 0; q < bs; q++)
+                    {
+                      SIMD<double> sum(0.0);
+                      for (size_t r = 0; r < bs; r++)
+                        sum -= tmp[r] * dinv[r][q];
+                      a(i,k0+q) = sum;
+                    }
+                }
+            for (size_t q = 0; q < bs; q++)
+              for (size_t r = 0; r < bs; r++)
+                a(k0+q,k0+r) = dinv[q][r];
+          }
+        k1 = k0;
+      }
+    return minpiv;
+  }
+
+
   
 
   /**************** timings *********************** */
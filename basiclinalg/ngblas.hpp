@@ -78,6 +78,18 @@ namespace ngbla
                 SliceVector<Complex> diag,
                 SliceMatrix<Complex> b, SliceMatrix<Complex> c);
 
+  /*
+    Schur complements of SIMD<double>::Size() matrices at once, one
+    matrix per lane: a = [A B; C D], D starting at row and column nouter,
+    is eliminated without pivoting and A is overwritten by A - B D^{-1} C.
+    With inverse, the remaining blocks become D^{-1}, -B D^{-1} and
+    D^{-1} C, otherwise they are garbage. Returns per lane the smallest
+    pivot relative to the largest entry of its row, small or NaN lanes
+    need pivoting.
+  */
+  extern NGS_DLL_HEADER
+  SIMD<double> CalcSchurComplement (SliceMatrix<SIMD<double>> a, size_t nouter, bool inverse = false);
+
   template <typename T>
   void SubADBt (SliceMatrix<T,ColMajor> a,
                 SliceVector<T> diag,
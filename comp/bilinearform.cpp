@@ -45,6 +45,151 @@ namespace ngcomp
 
 
 
+  /*
+    Volume element matrices waiting for static condensation. Elements
+    with the same local inner dofs (same type and order) are collected,
+    one element per SIMD lane, and condensed together without pivoting.
+    Lanes with a relative pivot below pivtol are condensed again with
+    LAPACK. Without pivoting the growth is bounded by 1/pivtol only, so
+    a small pivtol is safe for spd forms only.
+
+    After Condense, the outer block of every element matrix holds the
+    Schur complement A - B D^{-1} C. With inverse, the other blocks hold
+    D^{-1}, -B D^{-1} and D^{-1} C.
+  */
+  template <typename SCAL>
+  class StatCondBatch
+  {
+  public:
+    static constexpr size_t SW = SIMD<double>::Size();
+    Array<int> idofs, odofs;
+    Array<int> dnums[SW];
+    size_t elnrs[SW];
+    Matrix<SCAL> elmats[SW];
+    size_t cnt = 0;
+
+    bool Fits (size_t size, FlatArray<int> aidofs) const
+    {
+      return cnt == 0 || (elmats[0].Height() == size && idofs == aidofs);
+    }
+
+    void Add (FlatArray<int> adnums, size_t elnr, FlatMatrix<SCAL> elmat,
+              FlatArray<int> aidofs, FlatArray<int> aodofs)
+    {
+      if (cnt == 0)
+        {
+          idofs = aidofs;
+          odofs = aodofs;
+        }
+      dnums[cnt] = adnums;
+      elnrs[cnt] = elnr;
+      elmats[cnt].SetSize (elmat.Height(), elmat.Width());
+      elmats[cnt] = elmat;
+      cnt++;
+    }
+
+    bool Full () const { return cnt == SW; }
+
+    void Condense (bool inverse, double pivtol, LocalHeap & lh)
+    {
+      for (size_t l = 0; l < cnt; l++)
+        CondenseLapack (elmats[l], inverse, lh);
+    }
+
+    void CondenseLapack (FlatMatrix<SCAL> elmat, bool inverse, LocalHeap & lh) const
+    {
+      HeapReset hr(lh);
+      FlatMatrix<SCAL> 
+        a = elmat.Rows(odofs).Cols(odofs) | lh,
+        b = elmat.Rows(odofs).Cols(idofs) | lh,
+        c = Trans(elmat.Rows(idofs).Cols(odofs)) | lh,
+        d = elmat.Rows(idofs).Cols(idofs) | lh;
+      if (!inverse)
+        {
+          LapackAInvBt (d, b);
+          LapackMultAddABt (b, c, -1, a);
+          elmat.Rows(odofs).Cols(odofs) = a;
+          return;
+        }
+
+      LapackInverse (d);
+      FlatMatrix<SCAL> dc(idofs.Size(), odofs.Size(), lh);
+      FlatMatrix<SCAL> bd(odofs.Size(), idofs.Size(), lh);
+      dc = d * Trans(c) | Lapack;
+      bd = b * d | Lapack;
+      a -= b * dc | Lapack;
+      elmat.Rows(odofs).Cols(odofs) = a;
+      elmat.Rows(idofs).Cols(idofs) = d;
+      elmat.Rows(idofs).Cols(odofs) = dc;
+      elmat.Rows(odofs).Cols(idofs) = -bd;
+    }
+  };
+
+  template <>
+  void StatCondBatch<double> :: Condense (bool inverse, double pivtol, LocalHeap & lh)
+  {
+    static Timer t("static condensation, SIMD", 2);
+    ThreadRegionTimer reg (t, TaskManager::GetThreadId());
+    HeapReset hr(lh);
+
+    // outer dofs first, unused lanes repeat the first element
+    size_t no = odofs.Size(), n = no+idofs.Size();
+    FlatArray<int> perm(n, lh);
+    perm.Range(0,no) = odofs;
+    perm.Range(no,n) = idofs;
+    FlatMatrix<SIMD<double>> mat(n, n, lh);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        mat(i,j) = SIMD<double> ([&] (int l)
+                                 { return elmats[size_t(l) < cnt ? l : 0](perm[i], perm[j]); });
+
+    SIMD<double> piv = CalcSchurComplement (mat, no, inverse);
+
+    size_t nset = inverse ? n : no;
+    for (size_t l = 0; l < cnt; l++)
+      if (piv[l] > pivtol)
+        {
+          for (size_t i = 0; i < nset; i++)
+            for (size_t j = 0; j < nset; j++)
+              elmats[l](perm[i], perm[j]) = mat(i,j)[l];
+        }
+      else
+        CondenseLapack (elmats[l], inverse, lh);
+  }
+
+
+  // global dof numbers of the inner and the external dofs of a condensed
+  // element, expanded by the dimension, hidden inner dofs are -1
+  static void GetCondensedDofNrs (const FESpace & fes, int elnr, int dim,
+                                  Array<int> & idnums, Array<int> & ednums)
+  {
+    ArrayMem<int,100> idnums1, ednums1, hdnums1;
+    fes.GetDofNrs(elnr,idnums1,CONDENSATABLE_DOF);
+    fes.GetDofNrs(elnr,ednums1,EXTERNAL_DOF);
+    fes.GetDofNrs(elnr,hdnums1,HIDDEN_DOF);
+    int count = 0;
+    for (auto dof : hdnums1)
+      {
+        while (idnums1[count] != dof)
+          count++;
+        idnums1[count] = -1;
+      }
+
+    idnums.SetSize0(); 
+    ednums.SetSize0();
+    for (size_t j = 0; j < idnums1.Size(); j++)
+      if (idnums1[j] != -1)
+        idnums += dim*IntRange(idnums1[j], idnums1[j]+1);
+      else
+        for (size_t k = 0; k < dim; k++)
+          idnums += -1;
+    for (size_t j = 0; j < ednums1.Size(); j++)
+      ednums += dim * IntRange(ednums1[j], ednums1[j]+1);
+  }
+
+
+
+
 
 
 
@@ -92,6 +237,7 @@ namespace ngcomp
     spd = flags.GetDefineFlag ("spd");
     if (spd) symmetric = true;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());
+    nocoloring = flags.GetDefineFlag ("nocoloring");
   }
 
 
@@ -142,6 +288,7 @@ namespace ngcomp
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());    
+    nocoloring = flags.GetDefineFlag ("nocoloring");
   }
 
 
@@ -919,8 +1066,59 @@ namespace ngcomp
                           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
                       }
                     
-                    IterateElements
-                      (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
+                    // element matrices of equal type are condensed together in SIMD lanes.
+                    // This bypasses the Cholesky based CalcSchur used for spd forms below.
+                    // Elimination without pivoting is stable for spd forms, other forms
+                    // fall back to LAPACK already for moderately small pivots
+                    bool batch_condense = is_same<SCAL,double>::value && vb == VOL && eliminate_internal &&
+                      !store_inner && !(linearform && !keep_internal) && !printelmat && !elmat_ev;
+                    Array<StatCondBatch<SCAL>> statcond_batches(batch_condense ? TaskManager::GetNumThreads() : 0);
+
+                    auto flush_statcond = [&] (StatCondBatch<SCAL> & batch, LocalHeap & lh)
+                      {
+                        if (!batch.cnt) return;
+                        batch.Condense (keep_internal, spd ? 1e-10 : 1e-3, lh);
+                        for (size_t l = 0; l < batch.cnt; l++)
+                          {
+                            HeapReset hr(lh);
+                            FlatArray<int> dnums = batch.dnums[l];
+                            FlatMatrix<SCAL> elmat = batch.elmats[l];
+                            ElementId ei(VOL, batch.elnrs[l]);
+                            if (keep_internal)
+                              {
+                                int dim = elmat.Height() / dnums.Size();
+                                auto & idofs = batch.idofs;
+                                auto & odofs = batch.odofs;
+                                Array<int> idnums(elmat.Height(), lh), ednums(elmat.Height(), lh);
+                                GetCondensedDofNrs (*fespace, ei.Nr(), dim, idnums, ednums);
+
+                                FlatMatrix<SCAL> he(idofs.Size(), odofs.Size(), lh);
+                                FlatMatrix<SCAL> dinv(idofs.Size(), lh);
+                                he = -elmat.Rows(idofs).Cols(odofs);
+                                dinv = elmat.Rows(idofs).Cols(idofs);
+                                harmonicext ->AddElementMatrix(ei.Nr(),idnums,ednums,he);
+                                if (!symmetric)
+                                  {
+                                    FlatMatrix<SCAL> het(odofs.Size(), idofs.Size(), lh);
+                                    het = elmat.Rows(odofs).Cols(idofs);
+                                    static_cast<ElementByElementMatrix<SCAL>*>(harmonicexttrans.get())
+                                      ->AddElementMatrix(ei.Nr(),ednums,idnums,het);
+                                  }
+                                innersolve ->AddElementMatrix(ei.Nr(),idnums,idnums,dinv);
+                              }
+                            AddElementMatrix (dnums, dnums, elmat, ei, lh);
+                            for (auto pre : preconditioners)
+                              pre -> AddElementMatrix (dnums, elmat, ei, lh);
+                            if (check_unused)
+                              for (auto d : dnums)
+                                if (d != -1) useddof[d] = true;
+                          }
+                        batch.cnt = 0;
+                      };
+
+                    // preconditioners and the condensed rhs are not thread-safe
+                    bool use_coloring = !nocoloring || preconditioners.Size() || linearform;
+                    auto assemble_element = [&] (FESpace::Element el, LocalHeap & lh)
                        {
                          if (elmat_ev && vb == VOL) 
                            *testout << " Assemble Element " << el.Nr() << endl;  
@@ -1070,6 +1268,19 @@ namespace ngcomp
                                      (*testout) << "idofs = " << endl << idofs << endl;
                                      (*testout) << "odofs = " << endl << odofs << endl;
                                    }
+
+                                 if (batch_condense)
+                                   {
+                                     auto & batch = statcond_batches[TaskManager::GetThreadId()];
+                                     if (!batch.Fits (size, idofs))
+                                       flush_statcond (batch, lh);
+                                     for (int k = 0; k < idofs1.Size(); k++)
+                                       dnums[idofs1[k]] = -1;
+                                     batch.Add (dnums, el.Nr(), sum_elmat, idofs, odofs);
+                                     if (batch.Full())
+                                       flush_statcond (batch, lh);
+                                     return;
+                                   }
                                  
                                  FlatMatrix<SCAL> 
                                    a = sum_elmat.Rows(odofs).Cols(odofs) | lh,
@@ -1093,32 +1304,8 @@ namespace ngcomp
                                    }
                                  else
                                    {
-                                     Array<int> idnums1(dnums.Size(), lh), 
-                                       ednums1(dnums.Size(), lh),
-                                       hdnums1(dnums.Size(), lh);
-                                     fespace->GetDofNrs(el.Nr(),idnums1,CONDENSATABLE_DOF);
-                                     fespace->GetDofNrs(el.Nr(),ednums1,EXTERNAL_DOF);
-                                     fespace->GetDofNrs(el.Nr(),hdnums1,HIDDEN_DOF);
-                                     int count = 0;
-                                     for (auto dof : hdnums1)
-                                     {
-                                       while (idnums1[count] != dof)
-                                         count++;
-                                       idnums1[count] = -1;
-                                     }
-                                     
-                                     Array<int> idnums(dim*idnums1.Size(), lh);
-                                     Array<int> ednums(dim*ednums1.Size(), lh);
-                                     idnums.SetSize0(); 
-                                     ednums.SetSize0();
-                                     for (size_t j = 0; j < idnums1.Size(); j++)
-                                       if (idnums1[j] != -1)
-                                         idnums += dim*IntRange(idnums1[j], idnums1[j]+1);
-                                       else
-                                         for (size_t k = 0; k < dim; k++)
-                                           idnums += -1;
-                                     for (size_t j = 0; j < ednums1.Size(); j++)
-                                       ednums += dim * IntRange(ednums1[j], ednums1[j]+1);
+                                     Array<int> idnums(dim*dnums.Size(), lh), ednums(dim*dnums.Size(), lh);
+                                     GetCondensedDofNrs (*fespace, el.Nr(), dim, idnums, ednums);
                                      
                                      if (store_inner)
                                        innermatrix ->AddElementMatrix(el.Nr(),idnums,idnums,d);
@@ -1159,7 +1346,7 @@ namespace ngcomp
                                      a += b * he | Lapack;
                                      
                                      if (spd)
-                                       { // more stable ? 
+                                       { // more stable ? (not used by batch_condense)
                                          FlatMatrix<SCAL> schur(odofs.Size(), lh);
                                          CalcSchur (sum_elmat, schur, odofs, idofs);
                                          a = schur;
@@ -1218,7 +1405,16 @@ namespace ngcomp
                                if (d != -1) useddof[d] = true;
                            }
                          // timer3_VB[vb].Stop();
-                       });
+                       };
+                    auto finish = [&] (LocalHeap & lh)
+                      {
+                        if (batch_condense)
+                          flush_statcond (statcond_batches[TaskManager::GetThreadId()], lh);
+                      };
+                    if (use_coloring)
+                      IterateElements (*fespace, vb, clh, assemble_element, finish);
+                    else
+                      IterateElementsNoColoring (*fespace, vb, clh, assemble_element, finish);
                     progress.Done();
                     
                     /*
@@ -4343,7 +4539,7 @@ namespace ngcomp
                     ElementId id,
                     LocalHeap & lh) 
   {
-    mymatrix -> TMATRIX::AddElementMatrix (dnums1, dnums2, elmat, this->fespace->HasAtomicDofs());
+    mymatrix -> TMATRIX::AddElementMatrix (dnums1, dnums2, elmat, this->nocoloring || this->fespace->HasAtomicDofs());
   }
 
 
@@ -4451,7 +4647,7 @@ namespace ngcomp
                     ElementId id, 
                     LocalHeap & lh) 
   {
-    mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->fespace->HasAtomicDofs());
+    mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->nocoloring || this->fespace->HasAtomicDofs());
   }
 
 
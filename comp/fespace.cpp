@@ -313,6 +313,9 @@ lot of new non-zero entries in the matrix!\n" << endl;
       delete specialelements[i]; 
     specialelements.SetSize(0);
 
+    // element orders may change
+    ReferenceShapeCache::Invalidate();
+
     ma->UpdateBuffers();  // is free if netgen-mesh did not change
     int dim = ma->GetDimension();
     
@@ -1369,6 +1372,15 @@ lot of new non-zero entries in the matrix!\n" << endl;
 			VorB vb, 
 			LocalHeap & clh, 
 			const function<void(FESpace::Element,LocalHeap&)> & func)
+  {
+    IterateElements (fes, vb, clh, func, [] (LocalHeap & lh) { ; });
+  }
+
+  void IterateElements (const FESpace & fes, 
+			VorB vb, 
+			LocalHeap & clh, 
+			const function<void(FESpace::Element,LocalHeap&)> & func,
+			const function<void(LocalHeap&)> & finish)
   {
     static mutex copyex_mutex;
     const Table<int> & element_coloring = fes.ElementColoring(vb);
@@ -1394,6 +1406,7 @@ lot of new non-zero entries in the matrix!\n" << endl;
                       
                       func (move(el), lh);
                     }
+                  finish (lh);
 
                   ProgressOutput::SumUpLocal();
                 } );
@@ -1433,6 +1446,17 @@ lot of new non-zero entries in the matrix!\n" << endl;
 	    catch (...)
 	      { ; }
           }
+
+        try
+          {
+            finish (lh);
+          }
+        catch (const Exception & e)
+          {
+            lock_guard<mutex> guard(copyex_mutex);
+            if (!ex)
+              ex = new Exception (e);
+          }
       // cout << "lh, used size = " << lh.UsedSize() << endl;
     });
     
@@ -1443,6 +1467,53 @@ lot of new non-zero entries in the matrix!\n" << endl;
   }
   
 
+  void IterateElementsNoColoring (const FESpace & fes, 
+                                  VorB vb, 
+                                  LocalHeap & clh, 
+                                  const function<void(FESpace::Element,LocalHeap&)> & func)
+  {
+    IterateElementsNoColoring (fes, vb, clh, func, [] (LocalHeap & lh) { ; });
+  }
+
+  void IterateElementsNoColoring (const FESpace & fes, 
+                                  VorB vb, 
+                                  LocalHeap & clh, 
+                                  const function<void(FESpace::Element,LocalHeap&)> & func,
+                                  const function<void(LocalHeap&)> & finish)
+  {
+    // elements in mesh order, threads take contiguous chunks
+    size_t ne = fes.GetMeshAccess()->GetNE(vb);
+    SharedLoop2 sl(Range(ne));
+
+    auto loop = [&] (LocalHeap & lh)
+      {
+        ArrayMem<int,100> temp_dnums;
+        for (size_t nr : sl)
+          {
+            ElementId ei(vb, nr);
+            if (!fes.DefinedOn(ei)) continue;
+            HeapReset hr(lh);
+            FESpace::Element el(fes, ei, temp_dnums, lh);
+            func (move(el), lh);
+          }
+        finish (lh);
+      };
+
+    if (task_manager)
+      {
+        task_manager -> CreateJob
+          ( [&] (const TaskInfo & ti) 
+            {
+              LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+              loop (lh);
+              ProgressOutput::SumUpLocal();
+            } );
+      }
+    else
+      loop (clh);
+  }
+  
+
   // Aendern, Bremse!!!
   template < int S, class T >
   void FESpace :: TransformVec (int elnr, VorB vb,
@@ -850,6 +850,23 @@ ANY                  1 1 1 1 | 15
 			       VorB vb, 
 			       LocalHeap & clh, 
 			       const function<void(FESpace::Element,LocalHeap&)> & func);
+  /// finish is called by every task after its last element of a color
+  extern NGS_DLL_HEADER void IterateElements (const FESpace & fes,
+                                              VorB vb, 
+                                              LocalHeap & clh, 
+                                              const function<void(FESpace::Element,LocalHeap&)> & func,
+                                              const function<void(LocalHeap&)> & finish);
+  /// elements in mesh order, no coloring: func must add thread-safe
+  extern NGS_DLL_HEADER void IterateElementsNoColoring (const FESpace & fes,
+                                                        VorB vb, 
+                                                        LocalHeap & clh, 
+                                                        const function<void(FESpace::Element,LocalHeap&)> & func);
+  /// finish is called by every task after its last element
+  extern NGS_DLL_HEADER void IterateElementsNoColoring (const FESpace & fes,
+                                                        VorB vb, 
+                                                        LocalHeap & clh, 
+                                                        const function<void(FESpace::Element,LocalHeap&)> & func,
+                                                        const function<void(LocalHeap&)> & finish);
   /*
   template <typename TFUNC>
   inline void IterateElements (const FESpace & fes, 
@@ -101,6 +101,13 @@ namespace ngcomp
     if (archive.Input()) Update();
     for (int i = 0; i < vec.Size(); i++)
       {
+        if (archive.Mapped() && MyMPI_GetNTasks() == 1)
+          {
+            // whole vector as one bulk section, restored without copy
+            vec[i] -> DoArchive (archive);
+            continue;
+          }
+
         FlatVector<double> fv = vec[i] -> FVDouble();
 
 	/*
@@ -778,6 +785,415 @@ namespace ngcomp
 
 
 
+  /*
+    Checkpoint file, independent of the number of processes:
+
+      header  : CheckpointHeader
+      records : one CheckpointRecord per node carrying dofs
+      values  : dof values, node by node
+
+    Nodes are identified by node type and sorted global vertex numbers.
+    Every process writes records and values of its master nodes as one
+    block, the offsets count the master dofs of lower ranks as
+    ParallelDofs::EnumerateGlobally does (but in 64 bit). For restart, the
+    records are collected in a table distributed by hash value of the
+    key, such that no process holds global data.
+   */
+  struct CheckpointHeader
+  {
+    char magic[8];
+    size_t nrecords;
+    size_t ndof;
+    size_t dim;
+    size_t scalsize;
+  };
+
+  struct CheckpointRecord
+  {
+    INT<9> key;
+    int ndof;
+    size_t first;
+  };
+
+  static const char checkpoint_magic[8] = { 'N', 'G', 'S', 'C', 'K', 'P', 'T', '1' };
+
+  static INT<9> CheckpointKey (const MeshAccess & ma, NodeId node, Array<int> & pnums)
+  {
+    switch (node.GetType())
+      {
+      case NT_VERTEX: pnums.SetSize(1); pnums[0] = node.GetNr(); break;
+      case NT_EDGE: pnums = ma.GetEdgePNums (node.GetNr()); break;
+      case NT_FACE: pnums = ma.GetFacePNums (node.GetNr()); break;
+      case NT_CELL: pnums = ma.GetElVertices (ElementId(VOL, node.GetNr())); break;
+      default:
+        __assume(false);
+      }
+
+    bool global = MyMPI_GetNTasks (ma.GetCommunicator()) > 1;
+    INT<9> key = -1;
+    key[0] = node.GetType();
+    for (int j = 0; j < pnums.Size(); j++)
+      key[j+1] = global ? ma.GetGlobalNodeNum (NodeId(NT_VERTEX, pnums[j])) : pnums[j];
+    BubbleSort (FlatArray<int> (pnums.Size(), &key[1]));
+    return key;
+  }
+
+  static void CheckCheckpointHeader (const CheckpointHeader & header, size_t dim,
+                                     size_t scalsize, const string & filename)
+  {
+    if (memcmp (header.magic, checkpoint_magic, sizeof(checkpoint_magic)) != 0)
+      throw Exception ("LoadCheckpoint: " + filename + " is not a checkpoint file");
+    if (header.dim != dim || header.scalsize != scalsize)
+      throw Exception ("LoadCheckpoint: " + filename + " does not match the finite element space");
+  }
+
+  // dofs not attached to a mesh node (e.g. of a NumberSpace) have no key,
+  // the nodes must carry all (master) dofs of the space
+  static void CheckCheckpointDofs (const FESpace & fes, const MeshAccess & ma,
+                                   size_t nodedofs, const string & where)
+  {
+    shared_ptr<ParallelDofs> par = fes.GetParallelDofs();
+    size_t ndof = 0;
+    for (size_t d = 0; d < fes.GetNDof(); d++)
+      if (!par || par->IsMasterDof(d)) ndof++;
+
+    MPI_Comm comm = ma.GetCommunicator();
+    size_t nbad = MyMPI_AllReduce (size_t(nodedofs != ndof), MPI_SUM, comm);
+    if (nbad)
+      {
+        ndof = MyMPI_AllReduce (ndof, MPI_SUM, comm);
+        nodedofs = MyMPI_AllReduce (nodedofs, MPI_SUM, comm);
+        throw Exception (where + ": only " + ToString(nodedofs) + " of " + ToString(ndof)
+                         + " dofs are attached to mesh nodes");
+      }
+  }
+
+  template <typename T>
+  static T * DataPtr (FlatArray<T> a) { return a.Size() ? &a[0] : nullptr; }
+
+#ifdef PARALLEL
+  // send table row p to process p, receive row p from process p
+  template <typename T>
+  static Table<T> ExchangeTable (const Table<T> & send, MPI_Comm comm)
+  {
+    int ntasks = MyMPI_GetNTasks(comm);
+    Array<int> sendcnt(ntasks), recvcnt(ntasks), senddispl(ntasks), recvdispl(ntasks);
+    for (int p = 0; p < ntasks; p++)
+      sendcnt[p] = send[p].Size();
+    MPI_Alltoall (&sendcnt[0], 1, MPI_INT, &recvcnt[0], 1, MPI_INT, comm);
+
+    Table<T> recv(recvcnt);
+    for (int p = 0; p < ntasks; p++)
+      {
+        senddispl[p] = send.IndexArray()[p];
+        recvdispl[p] = recv.IndexArray()[p];
+      }
+
+    MPI_Datatype type;
+    MPI_Type_contiguous (sizeof(T), MPI_BYTE, &type);
+    MPI_Type_commit (&type);
+    MPI_Alltoallv (DataPtr(send.AsArray()), &sendcnt[0], &senddispl[0], type,
+                   DataPtr(recv.AsArray()), &recvcnt[0], &recvdispl[0], type, comm);
+    MPI_Type_free (&type);
+    return recv;
+  }
+#endif
+
+
+  template <class SCAL>
+  void S_GridFunction<SCAL> :: SaveCheckpoint (string filename) const
+  {
+    static Timer t("GridFunction::SaveCheckpoint");
+    RegionTimer reg(t);
+
+    const FESpace & fes = *GetFESpace();
+    shared_ptr<ParallelDofs> par = fes.GetParallelDofs();
+    size_t dim = fes.GetDimension();
+    if (par) GetVector().Cumulate();
+
+    Array<CheckpointRecord> records;
+    Array<SCAL> values;
+    Array<DofId> dnums;
+    Array<int> pnums;
+    for (NODE_TYPE nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
+      for (size_t i = 0; i < ma->GetNNodes(nt); i++)
+        {
+          fes.GetDofNrs (NodeId(nt, i), dnums);
+          if (dnums.Size() == 0) continue;
+          if (par && !par->IsMasterDof (dnums[0])) continue;
+
+          CheckpointRecord rec;
+          rec.key = CheckpointKey (*ma, NodeId(nt, i), pnums);
+          rec.ndof = dnums.Size();
+          rec.first = values.Size() / dim;
+          records.Append (rec);
+
+          Vector<SCAL> elvec(dnums.Size()*dim);
+          GetElementVector (dnums, elvec);
+          for (auto val : elvec)
+            values.Append (val);
+        }
+    CheckCheckpointDofs (fes, *ma, values.Size() / dim, "SaveCheckpoint");
+
+    CheckpointHeader header;
+    memcpy (header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+    header.dim = dim;
+    header.scalsize = sizeof(SCAL);
+    size_t nrec = records.Size();
+    size_t ndof = values.Size() / dim;
+
+#ifdef PARALLEL
+    MPI_Comm comm = ma->GetCommunicator();
+    size_t first_rec = 0, first_dof = 0;
+    MPI_Exscan (&nrec, &first_rec, 1, MyGetMPIType<size_t>(), MPI_SUM, comm);
+    MPI_Exscan (&ndof, &first_dof, 1, MyGetMPIType<size_t>(), MPI_SUM, comm);
+    if (MyMPI_GetId(comm) == 0)
+      first_rec = first_dof = 0;     // undefined on rank 0
+    header.nrecords = MyMPI_AllReduce (nrec, MPI_SUM, comm);
+    header.ndof = MyMPI_AllReduce (ndof, MPI_SUM, comm);
+    for (auto & rec : records)
+      rec.first += first_dof;
+
+    MPI_File fh;
+    if (MPI_File_open (comm, const_cast<char*> (filename.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                       MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+      throw Exception ("SaveCheckpoint: cannot open file " + filename);
+    MPI_File_set_size (fh, 0);
+
+    MPI_Datatype rectype, doftype;
+    MPI_Type_contiguous (sizeof(CheckpointRecord), MPI_BYTE, &rectype);
+    MPI_Type_contiguous (dim*sizeof(SCAL), MPI_BYTE, &doftype);
+    MPI_Type_commit (&rectype);
+    MPI_Type_commit (&doftype);
+
+    if (MyMPI_GetId(comm) == 0)
+      MPI_File_write_at (fh, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_Offset recoffset = sizeof(header) + first_rec * sizeof(CheckpointRecord);
+    MPI_Offset valoffset = sizeof(header) + header.nrecords * sizeof(CheckpointRecord)
+      + first_dof * dim * sizeof(SCAL);
+    MPI_File_write_at_all (fh, recoffset, DataPtr<CheckpointRecord>(records), nrec, rectype, MPI_STATUS_IGNORE);
+    MPI_File_write_at_all (fh, valoffset, DataPtr<SCAL>(values), ndof, doftype, MPI_STATUS_IGNORE);
+
+    MPI_Type_free (&rectype);
+    MPI_Type_free (&doftype);
+    MPI_File_close (&fh);
+#else
+    header.nrecords = nrec;
+    header.ndof = ndof;
+    ofstream out(filename, ios::binary);
+    if (!out)
+      throw Exception ("SaveCheckpoint: cannot open file " + filename);
+    out.write (reinterpret_cast<char*> (&header), sizeof(header));
+    out.write (reinterpret_cast<char*> (DataPtr<CheckpointRecord>(records)), nrec*sizeof(CheckpointRecord));
+    out.write (reinterpret_cast<char*> (DataPtr<SCAL>(values)), values.Size()*sizeof(SCAL));
+#endif
+  }
+
+
+  template <class SCAL>
+  void S_GridFunction<SCAL> :: LoadCheckpoint (string filename)
+  {
+    static Timer t("GridFunction::LoadCheckpoint");
+    RegionTimer reg(t);
+
+    const FESpace & fes = *GetFESpace();
+    shared_ptr<ParallelDofs> par = fes.GetParallelDofs();
+    size_t dim = fes.GetDimension();
+
+    // the nodes to restore, and where they are found in the file
+    Array<NodeId> nodes;
+    Array<INT<9>> keys;
+    Array<DofId> dnums;
+    Array<int> pnums;
+    size_t nodedofs = 0;
+    for (NODE_TYPE nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
+      for (size_t i = 0; i < ma->GetNNodes(nt); i++)
+        {
+          fes.GetDofNrs (NodeId(nt, i), dnums);
+          if (dnums.Size() == 0) continue;
+          if (par && !par->IsMasterDof (dnums[0])) continue;
+          nodes.Append (NodeId(nt, i));
+          keys.Append (CheckpointKey (*ma, NodeId(nt, i), pnums));
+          nodedofs += dnums.Size();
+        }
+    CheckCheckpointDofs (fes, *ma, nodedofs, "LoadCheckpoint");
+    Array<CheckpointRecord> found(nodes.Size());
+    CheckpointHeader header;
+
+#ifdef PARALLEL
+    MPI_Comm comm = ma->GetCommunicator();
+    int ntasks = MyMPI_GetNTasks(comm);
+    int id = MyMPI_GetId(comm);
+
+    MPI_File fh;
+    if (MPI_File_open (comm, const_cast<char*> (filename.c_str()), MPI_MODE_RDONLY,
+                       MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+      throw Exception ("LoadCheckpoint: cannot open file " + filename);
+    MPI_File_read_at_all (fh, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+    CheckCheckpointHeader (header, dim, sizeof(SCAL), filename);
+
+    MPI_Datatype rectype;
+    MPI_Type_contiguous (sizeof(CheckpointRecord), MPI_BYTE, &rectype);
+    MPI_Type_commit (&rectype);
+
+    // every process reads an equal share of the records ...
+    size_t rbegin = header.nrecords * id / ntasks;
+    size_t rend = header.nrecords * (id+1) / ntasks;
+    Array<CheckpointRecord> filerecs(rend-rbegin);
+    MPI_File_read_at_all (fh, sizeof(header) + rbegin * sizeof(CheckpointRecord),
+                          DataPtr<CheckpointRecord>(filerecs), filerecs.Size(), rectype, MPI_STATUS_IGNORE);
+    MPI_Type_free (&rectype);
+
+    // ... and passes them to the process owning the key
+    auto home = [ntasks] (const INT<9> & key) { return int(HashValue (key, ntasks)); };
+
+    TableCreator<CheckpointRecord> creator_recs(ntasks);
+    for ( ; !creator_recs.Done(); creator_recs++)
+      for (auto & rec : filerecs)
+        creator_recs.Add (home(rec.key), rec);
+    Table<CheckpointRecord> myrecs = ExchangeTable (creator_recs.MoveTable(), comm);
+
+    ClosedHashTable<INT<9>, size_t> dict(2*myrecs.AsArray().Size()+1);
+    for (size_t i = 0; i < myrecs.AsArray().Size(); i++)
+      dict[myrecs.AsArray()[i].key] = i;
+
+    // ask the owners for my nodes
+    TableCreator<INT<9>> creator_keys(ntasks);
+    for ( ; !creator_keys.Done(); creator_keys++)
+      for (auto & key : keys)
+        creator_keys.Add (home(key), key);
+    Table<INT<9>> asked = ExchangeTable (creator_keys.MoveTable(), comm);
+
+    Array<int> nasked(ntasks);
+    for (int p = 0; p < ntasks; p++)
+      nasked[p] = asked[p].Size();
+    Table<CheckpointRecord> answers(nasked);
+    for (int p = 0; p < ntasks; p++)
+      for (size_t j = 0; j < asked[p].Size(); j++)
+        {
+          size_t pos = dict.Position (asked[p][j]);
+          if (pos != size_t(-1))
+            {
+              size_t nr;
+              dict.GetData (pos, nr);
+              answers[p][j] = myrecs.AsArray()[nr];
+            }
+          else
+            answers[p][j].ndof = -1;
+        }
+    Table<CheckpointRecord> replies = ExchangeTable (answers, comm);
+
+    Array<int> cnt(ntasks);
+    cnt = 0;
+    for (size_t k = 0; k < keys.Size(); k++)
+      {
+        int p = home(keys[k]);
+        found[k] = replies[p][cnt[p]++];
+      }
+#else
+    ifstream in(filename, ios::binary);
+    if (!in)
+      throw Exception ("LoadCheckpoint: cannot open file " + filename);
+    in.read (reinterpret_cast<char*> (&header), sizeof(header));
+    CheckCheckpointHeader (header, dim, sizeof(SCAL), filename);
+
+    Array<CheckpointRecord> filerecs(header.nrecords);
+    in.read (reinterpret_cast<char*> (DataPtr<CheckpointRecord>(filerecs)), filerecs.Size()*sizeof(CheckpointRecord));
+    ClosedHashTable<INT<9>, size_t> dict(2*filerecs.Size()+1);
+    for (size_t i = 0; i < filerecs.Size(); i++)
+      dict[filerecs[i].key] = i;
+
+    for (size_t k = 0; k < keys.Size(); k++)
+      {
+        size_t pos = dict.Position (keys[k]);
+        if (pos != size_t(-1))
+          {
+            size_t nr;
+            dict.GetData (pos, nr);
+            found[k] = filerecs[nr];
+          }
+        else
+          found[k].ndof = -1;
+      }
+#endif
+
+    size_t nmissing = 0, nvalues = 0;
+    for (size_t k = 0; k < nodes.Size(); k++)
+      {
+        fes.GetDofNrs (nodes[k], dnums);
+        if (found[k].ndof != int(dnums.Size()))
+          nmissing++;
+        nvalues += dnums.Size() * dim;
+      }
+    nmissing = MyMPI_AllReduce (nmissing, MPI_SUM, ma->GetCommunicator());
+    if (nmissing)
+      {
+#ifdef PARALLEL
+        MPI_File_close (&fh);
+#endif
+        throw Exception ("LoadCheckpoint: " + ToString(nmissing) + " nodes of the mesh not found in " + filename);
+      }
+
+    // read values in file order
+    Array<size_t> firsts(nodes.Size());
+    Array<int> index(nodes.Size());
+    for (size_t k = 0; k < nodes.Size(); k++)
+      {
+        firsts[k] = found[k].first;
+        index[k] = k;
+      }
+    QuickSortI (firsts, index);
+
+    size_t valoffset = sizeof(header) + header.nrecords * sizeof(CheckpointRecord);
+    size_t dofsize = dim * sizeof(SCAL);
+    Array<SCAL> values(nvalues);
+
+#ifdef PARALLEL
+    Array<int> blocklen(nodes.Size());
+    Array<MPI_Aint> displ(nodes.Size());
+    for (size_t i = 0; i < nodes.Size(); i++)
+      {
+        blocklen[i] = found[index[i]].ndof * dofsize;
+        displ[i] = found[index[i]].first * dofsize;
+      }
+    MPI_Datatype filetype, scaltype;
+    MPI_Type_create_hindexed (nodes.Size(), DataPtr<int>(blocklen), DataPtr<MPI_Aint>(displ),
+                              MPI_BYTE, &filetype);
+    MPI_Type_contiguous (sizeof(SCAL), MPI_BYTE, &scaltype);
+    MPI_Type_commit (&filetype);
+    MPI_Type_commit (&scaltype);
+    MPI_File_set_view (fh, valoffset, MPI_BYTE, filetype, const_cast<char*> ("native"), MPI_INFO_NULL);
+    MPI_File_read_all (fh, DataPtr<SCAL>(values), nvalues, scaltype, MPI_STATUS_IGNORE);
+    MPI_Type_free (&filetype);
+    MPI_Type_free (&scaltype);
+    MPI_File_close (&fh);
+#else
+    for (size_t i = 0, cnt = 0; i < nodes.Size(); i++)
+      {
+        in.seekg (valoffset + found[index[i]].first * dofsize);
+        in.read (reinterpret_cast<char*> (&values[cnt]), found[index[i]].ndof * dofsize);
+        cnt += found[index[i]].ndof * dim;
+      }
+#endif
+
+    if (par)
+      {
+        GetVector() = 0.0;
+        GetVector().SetParallelStatus (DISTRIBUTED);
+      }
+    for (size_t i = 0, cnt = 0; i < nodes.Size(); i++)
+      {
+        fes.GetDofNrs (nodes[index[i]], dnums);
+        FlatVector<SCAL> elvec(dnums.Size()*dim, &values[cnt]);
+        SetElementVector (dnums, elvec);
+        cnt += elvec.Size();
+      }
+    if (par)
+      GetVector().Cumulate();
+  }
+
+
+
   template <class SCAL>
   S_ComponentGridFunction<SCAL> :: 
   S_ComponentGridFunction (const S_GridFunction<SCAL> & agf_parent, int acomp)
@@ -250,6 +250,11 @@ namespace ngcomp
 
     virtual void Load (istream & ist) = 0;
     virtual void Save (ostream & ost) const = 0;
+
+    /// checkpoint file, written and read collectively by all processes
+    virtual void SaveCheckpoint (string filename) const = 0;
+    /// restart, possibly with a different number of processes
+    virtual void LoadCheckpoint (string filename) = 0;
   };
 
 
@@ -279,6 +284,9 @@ namespace ngcomp
     virtual void Load (istream & ist);
     virtual void Save (ostream & ost) const;
 
+    virtual void SaveCheckpoint (string filename) const;
+    virtual void LoadCheckpoint (string filename);
+
   private:
     template <int N, NODE_TYPE NT> void LoadNodeType (istream & ist);
 
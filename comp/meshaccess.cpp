@@ -166,6 +166,13 @@ namespace ngcomp
       // static Timer t("eltrans::multipointjacobian"); RegionTimer reg(t);
       SIMD_MappedIntegrationRule<DIMS,DIMR> & mir = 
 	static_cast<SIMD_MappedIntegrationRule<DIMS,DIMR> &> (bmir);
+
+      GeometryCache * cache = mesh->GetGeometryCache();
+      GeometryCache::TKEY key(VB(), elnr, size_t(&ir[0]), ir.Size());
+      if (cache && ir.Size())
+        if (auto geom = cache->Get(key))
+          if (LoadGeometry (*geom, ir, mir))
+            return;
       
       mesh->mesh.MultiElementTransformation <DIMS,DIMR>
         (elnr, ir.Size(),
@@ -175,6 +182,54 @@ namespace ngcomp
       
       for (int i = 0; i < ir.Size(); i++)
         mir[i].Compute();
+
+      if (cache && ir.Size())
+        cache->Set (key, StoreGeometry (ir, mir));
+    }
+
+  private:
+    // rows: reference coordinates, point, Jacobian (row-wise)
+    enum { NGEOM = DIMS + DIMR + DIMR*DIMS };
+
+    static shared_ptr<Matrix<SIMD<double>>>
+    StoreGeometry (const SIMD_IntegrationRule & ir,
+                   const SIMD_MappedIntegrationRule<DIMS,DIMR> & mir)
+    {
+      auto geom = make_shared<Matrix<SIMD<double>>> (NGEOM, ir.Size());
+      for (size_t i = 0; i < ir.Size(); i++)
+        {
+          for (int j = 0; j < DIMS; j++)
+            (*geom)(j, i) = ir[i](j);
+          for (int j = 0; j < DIMR; j++)
+            (*geom)(DIMS+j, i) = mir[i].Point()(j);
+          for (int j = 0; j < DIMR; j++)
+            for (int k = 0; k < DIMS; k++)
+              (*geom)(DIMS+DIMR+j*DIMS+k, i) = mir[i].Jacobian()(j,k);
+        }
+      return geom;
+    }
+
+    // integration rules living on the LocalHeap may reuse an address,
+    // so the reference points are compared before the entry is used
+    static bool LoadGeometry (const Matrix<SIMD<double>> & geom,
+                              const SIMD_IntegrationRule & ir,
+                              SIMD_MappedIntegrationRule<DIMS,DIMR> & mir)
+    {
+      for (size_t i = 0; i < ir.Size(); i++)
+        for (int j = 0; j < DIMS; j++)
+          for (size_t k = 0; k < SIMD<double>::Size(); k++)
+            if (geom(j, i)[k] != ir[i](j)[k]) return false;
+
+      for (size_t i = 0; i < ir.Size(); i++)
+        {
+          for (int j = 0; j < DIMR; j++)
+            mir[i].Point()(j) = geom(DIMS+j, i);
+          for (int j = 0; j < DIMR; j++)
+            for (int k = 0; k < DIMS; k++)
+              mir[i].Jacobian()(j,k) = geom(DIMS+DIMR+j*DIMS+k, i);
+          mir[i].Compute();
+        }
+      return true;
     }
 
   };
@@ -732,6 +787,66 @@ namespace ngcomp
   }
 
 
+  GeometryCache :: GeometryCache (size_t abudget)
+    : budget(abudget), used(0)
+  {
+    for (auto & t : table)
+      t = ClosedHashTable<TKEY, shared_ptr<Matrix<SIMD<double>>>> (64);
+  }
+
+  shared_ptr<Matrix<SIMD<double>>> GeometryCache :: Get (const TKEY & key)
+  {
+    size_t shard = key[1] % NSHARDS;
+    MyLock lock(mutex[shard]);
+    if (!table[shard].Used (key)) return nullptr;
+    return table[shard].Get (key);
+  }
+
+  void GeometryCache :: Set (const TKEY & key, shared_ptr<Matrix<SIMD<double>>> data)
+  {
+    size_t bytes = data->Height()*data->Width()*sizeof(SIMD<double>);
+    size_t shard = key[1] % NSHARDS;
+    MyLock lock(mutex[shard]);
+    size_t old = 0;
+    if (table[shard].Used (key))
+      {
+        auto & olddata = *table[shard].Get (key);
+        old = olddata.Height()*olddata.Width()*sizeof(SIMD<double>);
+      }
+    if (bytes > old)
+      {
+        // reserve in one atomic step, other shards insert concurrently
+        size_t grow = bytes - old;
+        if (used.fetch_add (grow) + grow > budget)
+          {
+            used -= grow;
+            return;
+          }
+      }
+    else
+      used -= old - bytes;
+    table[shard].Set (key, data);
+  }
+
+  void GeometryCache :: Invalidate ()
+  {
+    for (size_t i = 0; i < NSHARDS; i++)
+      {
+        MyLock lock(mutex[i]);
+        table[i] = ClosedHashTable<TKEY, shared_ptr<Matrix<SIMD<double>>>> (64);
+      }
+    used = 0;
+  }
+
+  void MeshAccess :: SetGeometryCache (size_t budget)
+  {
+    if (budget)
+      geometry_cache = make_shared<GeometryCache> (budget);
+    else
+      geometry_cache = nullptr;
+  }
+
+
   void MeshAccess :: LoadMesh (const string & filename)
   {
     static Timer t("MeshAccess::LoadMesh"); RegionTimer reg(t);
@@ -823,6 +938,8 @@ namespace ngcomp
     mesh_timestamp = netgen_mesh_timestamp;
     
     timestamp = NGS_Object::GetNextTimeStamp();
+    geometry_timestamp = timestamp;
+    if (geometry_cache) geometry_cache->Invalidate();
     
 
     dim = mesh.GetDimension();
@@ -1779,6 +1896,8 @@ namespace ngcomp
   void MeshAccess :: Curve (int order)
   {
     mesh.Curve(order);
+    geometry_timestamp = NGS_Object::GetNextTimeStamp();
+    if (geometry_cache) geometry_cache->Invalidate();
   } 
   
   int MeshAccess :: GetNPairsPeriodicVertices () const 
@@ -191,6 +191,36 @@ namespace ngcomp
 
   class GridFunction;
 
+  /**
+     Mapped points and Jacobians of curved elements, evaluated on SIMD
+     integration rules. Entries are stored in SoA layout: one row per
+     reference coordinate, point coordinate and Jacobian entry, one
+     column per SIMD integration point. Entries beyond the memory
+     budget are not cached.
+   */
+  class NGS_DLL_HEADER GeometryCache
+  {
+  public:
+    typedef INT<4,size_t> TKEY;    // vb, elnr, rule, size
+  private:
+    enum { NSHARDS = 64 };
+    MyMutex mutex[NSHARDS];
+    ClosedHashTable<TKEY, shared_ptr<Matrix<SIMD<double>>>> table[NSHARDS];
+    size_t budget;
+    atomic<size_t> used;
+  public:
+    GeometryCache (size_t abudget);
+
+    size_t Budget() const { return budget; }
+    size_t Used() const { return used; }
+
+    /// returns nullptr if not cached
+    shared_ptr<Matrix<SIMD<double>>> Get (const TKEY & key);
+    /// ignored if budget is exhausted
+    void Set (const TKEY & key, shared_ptr<Matrix<SIMD<double>>> data);
+    void Invalidate ();
+  };
+
   class NGS_DLL_HEADER MeshAccess : public BaseStatusHandler
   {
     netgen::Ngx_Mesh mesh;
@@ -228,10 +258,15 @@ namespace ngcomp
 
     int mesh_timestamp = -1; // timestamp of Netgen-mesh
     size_t timestamp = 0;
+    /// changes also if only the element geometry changes (Curve)
+    size_t geometry_timestamp = 0;
     
     /// for ALE
     shared_ptr<GridFunction> deformation;  
 
+    /// geometry of curved elements, shared by copies
+    shared_ptr<GeometryCache> geometry_cache;
+
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
     
@@ -623,6 +658,7 @@ namespace ngcomp
     }
 
     auto GetTimeStamp() const { return timestamp; }
+    auto GetGeometryTimeStamp() const { return geometry_timestamp; }
     
     void SetRefinementFlag (ElementId id, bool ref)
     {
@@ -644,6 +680,10 @@ namespace ngcomp
       return deformation;
     }
 
+    /// cache geometry of curved elements, up to budget bytes (0 disables)
+    void SetGeometryCache (size_t budget);
+    GeometryCache * GetGeometryCache () const { return geometry_cache.get(); }
+
     void SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr);
     /*
     {
@@ -258,6 +258,10 @@ namespace ngcomp
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev")
+      {
+	sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	if (!lfconstraint)
@@ -355,6 +359,10 @@ namespace ngcomp
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev")
+      {
+	sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	// if (!lfconstraint)
@@ -829,6 +837,192 @@ namespace ngcomp
 
 
 
+  // ****************************** AMGPreconditioner *******************************
+
+
+  /**
+     Smoothed aggregation AMG.
+     The dofs on one mesh node form an AMG node. The near-nullspace is set
+     on the vertex dofs: constants for every component, or the rigid body
+     modes with the flag -rigidbodymodes (needs dim components per vertex).
+  */
+  class AMGPreconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<SmoothedAggregationAMG> amg;
+    bool rigidbodymodes;
+
+  public:
+    AMGPreconditioner (const PDE & pde, const Flags & aflags,
+                       const string aname = "amgprecond")
+      : Preconditioner (&pde,aflags,aname)
+    {
+      bfa = pde.GetBilinearForm (flags.GetStringFlag ("bilinearform", NULL));
+      rigidbodymodes = flags.GetDefineFlag ("rigidbodymodes");
+    }
+
+    AMGPreconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                       const string aname = "amgprecond")
+      : Preconditioner (abfa,aflags,aname), bfa(abfa)
+    {
+      rigidbodymodes = flags.GetDefineFlag ("rigidbodymodes");
+    }
+
+    virtual bool IsComplex() const { return false; }
+
+    virtual void FinalizeLevel (const BaseMatrix * mat)
+    {
+      static Timer t("AMGPreconditioner::FinalizeLevel"); RegionTimer reg(t);
+      cout << IM(3) << "Update AMG Preconditioner" << endl;
+      timestamp = bfa->GetTimeStamp();
+
+      shared_ptr<BaseMatrix> amat = bfa->GetMatrixPtr();
+#ifdef PARALLEL
+      if (dynamic_pointer_cast<ParallelMatrix> (amat))
+        amat = dynamic_pointer_cast<ParallelMatrix> (amat)->GetMatrix();
+#endif
+      auto spmat = dynamic_pointer_cast<BaseSparseMatrix> (amat);
+      if (!spmat || spmat->IsComplex())
+        throw Exception ("AMGPreconditioner: needs a real sparse matrix");
+
+      amg = make_shared<SmoothedAggregationAMG>
+        (spmat, bfa->GetFESpace()->GetFreeDofs(bfa->UsesEliminateInternal()));
+      amg->SetMaxLevels (int (flags.GetNumFlag ("maxlevels", 10)));
+      amg->SetCoarseSize (size_t (flags.GetNumFlag ("coarsesize", 500)));
+      amg->SetThreshold (flags.GetNumFlag ("threshold", 0.08));
+      amg->SetSmoothingSteps (int (flags.GetNumFlag ("smoothingsteps", 1)));
+      amg->SetChebyshev (int (flags.GetNumFlag ("chebyshevdegree", 2)),
+                         flags.GetNumFlag ("chebyshevratio", 30));
+      SetNodes ();
+      amg->Setup();
+    }
+
+    virtual void Update ()
+    {
+      if (GetTimeStamp() < bfa->GetTimeStamp())
+        FinalizeLevel (&bfa->GetMatrix());
+      if (test) Test();
+    }
+
+    virtual void CleanUpLevel ()
+    {
+      amg = nullptr;
+    }
+
+    virtual const BaseMatrix & GetMatrix() const
+    {
+      if (!amg)
+        ThrowPreconditionerNotReady();
+      return *amg;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const
+    {
+      return bfa->GetMatrix();
+    }
+
+    virtual const char * ClassName() const
+    { return "AMG Preconditioner"; }
+
+  private:
+    void SetNodes ()
+    {
+      auto fes = bfa->GetFESpace();
+      auto ma = fes->GetMeshAccess();
+      size_t es = fes->GetDimension();
+      size_t n = fes->GetNDof() * es;
+      int dim = ma->GetDimension();
+
+      Array<DofId> dnums;
+      auto scalardofs = [&] (NodeId node, Array<int> & sdofs)
+        {
+          fes->GetDofNrs (node, dnums);
+          sdofs.SetSize0();
+          for (auto d : dnums)
+            if (d >= 0)
+              for (size_t k = 0; k < es; k++)
+                sdofs.Append (d*es+k);
+        };
+
+      Array<int> dofnode(n), sdofs;
+      dofnode = -1;
+      int nn = 0;
+      for (auto nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
+        for (auto node : ma->Nodes(nt))
+          {
+            scalardofs (node, sdofs);
+            if (!sdofs.Size()) continue;
+            for (int d : sdofs)
+              dofnode[d] = nn;
+            nn++;
+          }
+      amg->SetNodes (dofnode);
+
+      // coefficients of linear functions vanish for higher order dofs
+      int ncomp = 0;
+      for (auto v : ma->Nodes(NT_VERTEX))
+        {
+          scalardofs (v, sdofs);
+          ncomp = max2 (ncomp, int(sdofs.Size()));
+        }
+      if (rigidbodymodes && ncomp != dim)
+        throw Exception ("AMGPreconditioner: rigid body modes need dim components per vertex");
+
+      int nns = rigidbodymodes ? dim*(dim+1)/2 : ncomp;
+      auto nullspace = make_shared<MultiVector> (n, nns);
+      FlatMatrix<double> b = nullspace->Data();
+
+      Vec<3> center = 0.0;
+      auto point = [&] (size_t v)
+        {
+          Vec<3> p = 0.0;
+          if (dim == 2)
+            {
+              Vec<2> p2 = ma->GetPoint<2> (v);
+              p(0) = p2(0); p(1) = p2(1);
+            }
+          else if (dim == 3)
+            p = ma->GetPoint<3> (v);
+          return p;
+        };
+      for (size_t v = 0; v < ma->GetNV(); v++)
+        center += point(v);
+      center /= max2 (size_t(1), size_t(ma->GetNV()));
+
+      for (auto v : ma->Nodes(NT_VERTEX))
+        {
+          scalardofs (v, sdofs);
+          if (!rigidbodymodes)
+            {
+              for (size_t k = 0; k < sdofs.Size(); k++)
+                b(sdofs[k], k) = 1;
+              continue;
+            }
+          if (int(sdofs.Size()) != dim) continue;
+          Vec<3> x = point(v.GetNr()) - center;
+          for (int k = 0; k < dim; k++)
+            b(sdofs[k], k) = 1;
+          if (dim == 2)
+            {
+              b(sdofs[0], 2) = -x(1);
+              b(sdofs[1], 2) = x(0);
+            }
+          else if (dim == 3)
+            {
+              // rotations e_k x x
+              b(sdofs[1], 3) = -x(2); b(sdofs[2], 3) = x(1);
+              b(sdofs[0], 4) = x(2);  b(sdofs[2], 4) = -x(0);
+              b(sdofs[0], 5) = -x(1); b(sdofs[1], 5) = x(0);
+            }
+        }
+      amg->SetNearNullspace (nullspace);
+    }
+  };
+
+
+
+
+
   // ****************************** TwoLevelPreconditioner *******************************
 
 
@@ -1301,6 +1495,7 @@ ComplexPreconditioner :: ComplexPreconditioner (PDE * apde, const Flags & aflags
   RegisterPreconditioner<MGPreconditioner> registerMG("multigrid");
   RegisterPreconditioner<DirectPreconditioner> registerDirect("direct");
   RegisterPreconditioner<LocalPreconditioner> registerlocal("local");
+  RegisterPreconditioner<AMGPreconditioner> registerAMG("saamg");
 
 }
 
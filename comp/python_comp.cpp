@@ -1252,8 +1252,17 @@ used_idnrs : list of int = None
     .def("Update", [](GF& self) { self.Update(); },
          "update vector size to finite element space dimension after mesh refinement")
     
-    .def("Save", [](GF& self, string filename, bool parallel)
+    .def("Save", [](GF& self, string filename, bool parallel, bool mapped)
          {
+           if (mapped)
+             {
+               // every process would access the same file
+               if (MyMPI_GetNTasks() > 1)
+                 throw Exception ("GridFunction.Save: mapped=True is not available in parallel, use SaveCheckpoint");
+               MappedOutArchive ar(filename);
+               self.GetVector().DoArchive(ar);
+               return;
+             }
            ofstream out(filename, ios::binary);
            if (parallel)
              self.Save(out);
@@ -1261,9 +1270,19 @@ used_idnrs : list of int = None
              for (auto d : self.GetVector().FVDouble())
                SaveBin(out, d);
          },
-         py::arg("filename"), py::arg("parallel")=false)
-    .def("Load", [](GF& self, string filename, bool parallel)
+         py::arg("filename"), py::arg("parallel")=false, py::arg("mapped")=false,
+         "mapped: aligned file format which Load(mapped=True) maps into memory without copy")
+    .def("Load", [](GF& self, string filename, bool parallel, bool mapped)
          {
+           if (mapped)
+             {
+               // every process would access the same file
+               if (MyMPI_GetNTasks() > 1)
+                 throw Exception ("GridFunction.Load: mapped=True is not available in parallel, use LoadCheckpoint");
+               MappedInArchive ar(filename);
+               self.GetVector().DoArchive(ar);
+               return;
+             }
            ifstream in(filename, ios::binary);
            if (parallel)
              self.Load(in);
@@ -1271,7 +1290,13 @@ used_idnrs : list of int = None
              for (auto & d : self.GetVector().FVDouble())
                LoadBin(in, d);
          },
-         py::arg("filename"), py::arg("parallel")=false)         
+         py::arg("filename"), py::arg("parallel")=false, py::arg("mapped")=false)
+    .def("SaveCheckpoint", [](GF& self, string filename) { self.SaveCheckpoint(filename); },
+         py::arg("filename"),
+         "collective MPI-IO checkpoint, every process writes its own part of the file")
+    .def("LoadCheckpoint", [](GF& self, string filename) { self.LoadCheckpoint(filename); },
+         py::arg("filename"),
+         "restart from SaveCheckpoint, also with a different number of processes")
          
     .def("Set", 
          [](shared_ptr<GF> self, spCF cf,
@@ -1587,7 +1612,10 @@ check_unused : bool
                      "  of the matrix on the finest grid. This is needed to use the multigrid\n"
                      "  preconditioner with a changing bilinearform.",
 		     py::arg("nonsym_storage") = "bool = False\n"
-		     " The full matrix is stored, even if the symmetric flag is set."
+		     " The full matrix is stored, even if the symmetric flag is set.",
+                     py::arg("nocoloring") = "bool = False\n"
+                     "  Assemble elements in mesh order without element coloring.\n"
+                     "  Entries are added to the matrix with atomic operations."
                      );
                 })
 
@@ -1833,7 +1861,14 @@ flags : dict
                     "  Smoother between multigrid levels, available options are:\n"
                     "    'point': Gauss-Seidel-Smoother\n"
                     "    'line':  Anisotropic smoother\n"
-                    "    'block': Block smoother";
+                    "    'block': Block smoother\n"
+                    "    'chebyshev': Chebyshev-Jacobi smoother, parallel without coloring";
+                  mg_flags["chebyshevdegree"] = "int = 3\n"
+                    "  Polynomial degree of the Chebyshev smoother";
+                  mg_flags["chebyshevratio"] = "double = 10\n"
+                    "  Chebyshev smoother damps eigenvalues in [lmax/ratio, lmax]";
+                  mg_flags["lanczossteps"] = "int = 10\n"
+                    "  Lanczos steps to estimate lmax for the Chebyshev smoother";
                   return mg_flags;
                 })
     ;
@@ -2669,7 +2704,8 @@ flags : dict
 
    py::class_<BaseVTKOutput, shared_ptr<BaseVTKOutput>>(m, "VTKOutput")
     .def(py::init([] (shared_ptr<MeshAccess> ma, py::list coefs_list,
-                      py::list names_list, string filename, int subdivision, int only_element)
+                      py::list names_list, string filename, int subdivision, int only_element,
+                      string format, string encoding, bool compress)
          -> shared_ptr<BaseVTKOutput>
          {
            Array<shared_ptr<CoefficientFunction> > coefs
@@ -2678,9 +2714,11 @@ flags : dict
              = makeCArray<string> (names_list);
            shared_ptr<BaseVTKOutput> ret;
            if (ma->GetDimension() == 2)
-             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element,
+                                              format, encoding, compress);
            else
-             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element,
+                                              format, encoding, compress);
            return ret;
          }),
          py::arg("ma"),
@@ -2688,18 +2726,23 @@ flags : dict
          py::arg("names") = py::list(),
          py::arg("filename") = "vtkout",
          py::arg("subdivision") = 0,
-         py::arg("only_element") = -1
+         py::arg("only_element") = -1,
+         py::arg("format") = "vtk",
+         py::arg("encoding") = "raw",
+         py::arg("compress") = false
          )
-     .def("Do", [](shared_ptr<BaseVTKOutput> self)
+     .def("Do", [](shared_ptr<BaseVTKOutput> self, double time)
           { 
-            self->Do(glh);
+            self->Do(glh, nullptr, time);
           },
+          py::arg("time")=-1,
+          "Write output, time >= 0 adds a time step to the .pvd collection (format='vtu')",
           py::call_guard<py::gil_scoped_release>())
-     .def("Do", [](shared_ptr<BaseVTKOutput> self, const BitArray * drawelems)
+     .def("Do", [](shared_ptr<BaseVTKOutput> self, const BitArray * drawelems, double time)
           { 
-            self->Do(glh, drawelems);
+            self->Do(glh, drawelems, time);
           },
-          py::arg("drawelems"),
+          py::arg("drawelems"), py::arg("time")=-1,
           py::call_guard<py::gil_scoped_release>())
      ;
 
@@ -363,6 +363,17 @@ mesh (netgen.Mesh): a mesh generated from Netgen
 
     .def("UnsetDeformation", [](MeshAccess & ma){ ma.SetDeformation(nullptr);})
 
+    .def("SetGeometryCache", &MeshAccess::SetGeometryCache,
+         py::arg("budget"),
+         docu_string("Cache points and Jacobians of curved elements, using up to budget bytes (0 disables)"))
+
+    .def("GeometryCacheUsed", [](MeshAccess & ma) -> size_t
+         {
+           auto cache = ma.GetGeometryCache();
+           return cache ? cache->Used() : 0;
+         },
+         docu_string("Bytes used by the geometry cache"))
+
     .def("SetPML", 
 	 [](MeshAccess & ma,  shared_ptr<PML> apml, py::object definedon)
           {
@@ -5,6 +5,9 @@
 /*********************************************************************/
 
 #include <comp.hpp>
+#ifdef NGS_ZLIB
+#include <zlib.h>
+#endif
 
 namespace ngcomp
 { 
@@ -19,7 +22,10 @@ namespace ngcomp
                 flags.GetStringListFlag ("fieldnames" ),
                 flags.GetStringFlag ("filename","output"),
                 (int) flags.GetNumFlag ( "subdivision", 0),
-                (int) flags.GetNumFlag ( "only_element", -1))
+                (int) flags.GetNumFlag ( "only_element", -1),
+                flags.GetStringFlag ("format","vtk"),
+                flags.GetStringFlag ("encoding","raw"),
+                flags.GetDefineFlag ("compress"))
   {;}
 
 
@@ -27,10 +33,20 @@ namespace ngcomp
   VTKOutput<D>::VTKOutput (shared_ptr<MeshAccess> ama,
                            const Array<shared_ptr<CoefficientFunction>> & a_coefs,
                            const Array<string> & a_field_names,
-                           string a_filename, int a_subdivision, int a_only_element)
+                           string a_filename, int a_subdivision, int a_only_element,
+                           string a_format, string a_encoding, bool a_compress)
     : ma(ama), coefs(a_coefs), fieldnames(a_field_names),
-      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element)
+      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element),
+      format(a_format), encoding(a_encoding), compress(a_compress)
   {
+    if (format != "vtk" && format != "vtu")
+      throw Exception ("VTKOutput: unknown format '"+format+"', use 'vtk' or 'vtu'");
+    if (encoding != "raw" && encoding != "base64")
+      throw Exception ("VTKOutput: unknown encoding '"+encoding+"', use 'raw' or 'base64'");
+#ifndef NGS_ZLIB
+    if (compress)
+      throw Exception ("VTKOutput: compression needs NGSolve built with zlib");
+#endif
     value_field.SetSize(a_coefs.Size());
     for (int i = 0; i < a_coefs.Size(); i++)
       if (fieldnames.Size() > i)
@@ -46,6 +62,9 @@ namespace ngcomp
   {
     points.SetSize(0);
     cells.SetSize(0);
+    celltypes.SetSize(0);
+    geometry_blocks.SetSize(0);
+    geometry_valid = false;
     for (auto field : value_field)
       field->SetSize(0);
   }
@@ -347,42 +366,13 @@ namespace ngcomp
     }
   }
 
-  /// output of cell types (here only simplices)
+  /// output of cell types
   template <int D> 
   void VTKOutput<D>::PrintCellTypes()
   {
     *fileout << "CELL_TYPES " << cells.Size() << endl;
-    int factor = (1<<subdivision)*(1<<subdivision);
-    if (D==3)
-      factor *= (1<<subdivision);
-    for (auto e : ma->Elements(VOL))
-    {
-      switch(ma->GetElType(e))
-      {
-      case ET_TET:
-        for(int i=0; i<factor; i++)
-          *fileout << "10 " << endl; //(void)c;
-        break;
-      case ET_QUAD:
-        for(int i=0; i<factor; i++)
-          *fileout << "9 " << endl;
-        break;
-      case ET_TRIG:
-        for(int i=0; i<factor; i++)
-          *fileout << "5 " << endl;
-        break;
-      case ET_PRISM:
-        for(int i=0; i<factor; i++)
-          *fileout << "13 " << endl;
-        break;
-      case ET_HEX:
-        for(int i=0; i<factor; i++)
-          *fileout << "12 " << endl;
-        break;        
-      default:
-        cout << "VTKOutput Element Type " << ma->GetElType(e) << " not supported!" << endl;
-      }
-    }
+    for (auto t : celltypes)
+      *fileout << int(t) << " " << endl;
     *fileout << "CELL_DATA " << cells.Size() << endl;
     *fileout << "POINT_DATA " << points.Size() << endl;
   }
@@ -404,30 +394,393 @@ namespace ngcomp
     }
     
   }
+
+
+  static string Base64 (const string & in)
+  {
+    static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string out;
+    out.reserve (4*((in.size()+2)/3));
+    size_t i = 0;
+    for ( ; i+2 < in.size(); i += 3)
+      {
+        unsigned int v = (unsigned char)in[i] << 16 | (unsigned char)in[i+1] << 8 | (unsigned char)in[i+2];
+        out += table[(v >> 18) & 63];
+        out += table[(v >> 12) & 63];
+        out += table[(v >> 6) & 63];
+        out += table[v & 63];
+      }
+    if (i < in.size())
+      {
+        unsigned int v = (unsigned char)in[i] << 16;
+        if (i+1 < in.size()) v |= (unsigned char)in[i+1] << 8;
+        out += table[(v >> 18) & 63];
+        out += table[(v >> 12) & 63];
+        out += (i+1 < in.size()) ? table[(v >> 6) & 63] : '=';
+        out += '=';
+      }
+    return out;
+  }
+
+  /// one array of the appended data section, with header as written by vtkXMLWriter
+  static string VTUBlock (const void * data, size_t bytes, bool compress, bool base64)
+  {
+    string header, body;
+    if (!compress)
+      {
+        uint64_t nbytes = bytes;
+        header.assign ((const char*)&nbytes, sizeof(nbytes));
+        body.assign ((const char*)data, bytes);
+      }
+    else
+      {
+#ifdef NGS_ZLIB
+        // header: nblocks, blocksize, size of last block, compressed block sizes
+        const size_t blocksize = 1 << 15;
+        size_t nblocks = (bytes+blocksize-1) / blocksize;
+        Array<string> blocks(nblocks);
+        ParallelFor (nblocks, [&] (size_t i)
+                     {
+                       size_t first = i*blocksize;
+                       uLong len = min2(blocksize, bytes-first);
+                       uLongf complen = compressBound (len);
+                       blocks[i].resize (complen);
+                       compress2 ((Bytef*)&blocks[i][0], &complen,
+                                  (const Bytef*)data+first, len, Z_DEFAULT_COMPRESSION);
+                       blocks[i].resize (complen);
+                     });
+        Array<uint64_t> head(3+nblocks);
+        head[0] = nblocks;
+        head[1] = blocksize;
+        head[2] = (bytes % blocksize || !bytes) ? bytes % blocksize : blocksize;
+        for (size_t i = 0; i < nblocks; i++)
+          {
+            head[3+i] = blocks[i].size();
+            body += blocks[i];
+          }
+        header.assign ((const char*)&head[0], head.Size()*sizeof(uint64_t));
+#else
+        throw Exception ("VTKOutput: compression needs NGSolve built with zlib");
+#endif
+      }
+    if (base64)
+      return Base64 (header) + Base64 (body);
+    return header + body;
+  }
+
+  static string FileBaseName (const string & name)
+  {
+    size_t pos = name.find_last_of ("/\\");
+    return (pos == string::npos) ? name : name.substr (pos+1);
+  }
+
+  /// encoded points, connectivity, offsets and types, kept while the geometry is valid
+  template <int D> 
+  void VTKOutput<D>::EncodeGeometry ()
+  {
+    if (geometry_blocks.Size()) return;
+
+    bool base64 = encoding == "base64";
+    size_t np = points.Size(), nc = cells.Size();
+    auto Encode = [&] (const auto & data)
+      {
+        return VTUBlock (data.Size() ? &data[0] : nullptr,
+                         data.Size()*sizeof(data[0]), compress, base64);
+      };
+
+    Array<float> pts(3*np);
+    ParallelFor (np, [&] (size_t i)
+                 {
+                   for (int j = 0; j < 3; j++)
+                     pts[3*i+j] = (j < D) ? points[i](j) : 0;
+                 });
+
+    Array<int64_t> offsets(nc);
+    size_t nconn = 0;
+    for (size_t i = 0; i < nc; i++)
+      {
+        nconn += cells[i][0];
+        offsets[i] = nconn;
+      }
+    Array<int64_t> connectivity(nconn);
+    ParallelFor (nc, [&] (size_t i)
+                 {
+                   size_t first = offsets[i]-cells[i][0];
+                   for (int j = 0; j < cells[i][0]; j++)
+                     connectivity[first+j] = cells[i][j+1];
+                 });
+
+    geometry_blocks.Append (Encode (pts));
+    geometry_blocks.Append (Encode (connectivity));
+    geometry_blocks.Append (Encode (offsets));
+    geometry_blocks.Append (Encode (celltypes));
+  }
+
+  /// xml part of a vtu file up to the appended data. With steptimes, the
+  /// field arrays of step i are tagged with TimeStep="i", field_offsets
+  /// holds the offsets of all fields of step 0, then of step 1, ...
+  template <int D> 
+  string VTKOutput<D>::VTUHeader (FlatArray<size_t> geometry_offsets, FlatArray<size_t> field_offsets,
+                                  FlatArray<double> steptimes)
+  {
+    ostringstream xml;
+    xml << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\"";
+    if (compress)
+      xml << " compressor=\"vtkZLibDataCompressor\"";
+    xml << ">\n<UnstructuredGrid";
+    if (steptimes.Size())
+      {
+        xml.precision(16);
+        xml << " TimeValues=\"";
+        for (double t : steptimes)
+          xml << "\n" << t;
+        xml << "\"";
+      }
+    xml << ">\n<Piece NumberOfPoints=\"" << points.Size() << "\" NumberOfCells=\"" << cells.Size() << "\">\n"
+        << "<PointData>\n";
+    size_t nsteps = max2(steptimes.Size(), size_t(1));
+    for (size_t step = 0; step < nsteps; step++)
+      for (size_t k = 0; k < value_field.Size(); k++)
+        {
+          xml << "<DataArray type=\"Float32\" Name=\"" << value_field[k]->Name()
+              << "\" NumberOfComponents=\"" << value_field[k]->Dimension() << "\"";
+          if (steptimes.Size())
+            xml << " TimeStep=\"" << step << "\"";
+          xml << " format=\"appended\" offset=\"" << field_offsets[step*value_field.Size()+k] << "\"/>\n";
+        }
+    xml << "</PointData>\n"
+        << "<Points>\n"
+        << "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\""
+        << geometry_offsets[0] << "\"/>\n"
+        << "</Points>\n"
+        << "<Cells>\n"
+        << "<DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\""
+        << geometry_offsets[1] << "\"/>\n"
+        << "<DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\""
+        << geometry_offsets[2] << "\"/>\n"
+        << "<DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""
+        << geometry_offsets[3] << "\"/>\n"
+        << "</Cells>\n"
+        << "</Piece>\n"
+        << "</UnstructuredGrid>\n";
+    return xml.str();
+  }
+
+  /// encoded field arrays of the current output
+  static Array<string> EncodeFields (FlatArray<shared_ptr<ValueField>> value_field, bool compress, bool base64)
+  {
+    Array<string> blocks(value_field.Size());
+    for (size_t k = 0; k < value_field.Size(); k++)
+      {
+        auto field = value_field[k];
+        Array<float> values(field->Size());
+        ParallelFor (values.Size(), [&] (size_t i) { values[i] = (*field)[i]; });
+        blocks[k] = VTUBlock (values.Size() ? &values[0] : nullptr,
+                              values.Size()*sizeof(float), compress, base64);
+      }
+    return blocks;
+  }
+
+  /// XML unstructured grid with appended data
+  template <int D> 
+  void VTKOutput<D>::WriteVTU (const string & vtufilename)
+  {
+    static Timer t("VTKOutput::WriteVTU"); RegionTimer reg(t);
+    EncodeGeometry();
+    Array<string> fieldblocks = EncodeFields (value_field, compress, encoding == "base64");
+
+    Array<const string*> blocks;
+    size_t offset = 0;
+    auto AddBlock = [&] (const string & block)
+      {
+        blocks.Append (&block);
+        offset += block.size();
+        return offset - block.size();
+      };
+    Array<size_t> field_offsets, geometry_offsets;
+    for (auto & block : fieldblocks)
+      field_offsets.Append (AddBlock (block));
+    for (auto & block : geometry_blocks)
+      geometry_offsets.Append (AddBlock (block));
+
+    ofstream out(vtufilename, ios::binary);
+    out << VTUHeader (geometry_offsets, field_offsets, Array<double>())
+        << "<AppendedData encoding=\"" << encoding << "\">\n_";
+    for (auto block : blocks)
+      out.write (block->data(), block->size());
+    out << "\n</AppendedData>\n</VTKFile>\n";
+  }
+
+  /*
+    Adds the current fields as the last time step of series_times to a vtu
+    time series. The geometry is written only with the first step. Later
+    steps append their field arrays to the appended data section and
+    rewrite the xml header in place, which is padded to a reserved size.
+    Only if the header outgrows its reserve the file is copied, with
+    twice the reserve, so writing n steps costs O(n) in total.
+  */
+  template <int D> 
+  void VTKOutput<D>::WriteVTUStep (const string & vtufilename)
+  {
+    static Timer t("VTKOutput::WriteVTUStep"); RegionTimer reg(t);
+    bool first_step = series_times.Size() == 1;
+    string appended = "<AppendedData encoding=\"" + encoding + "\">\n_";
+    string tail = "\n</AppendedData>\n</VTKFile>\n";
+
+    // new data, appended after the data of the previous steps
+    Array<const string*> newblocks;
+    size_t offset = series_datasize;
+    auto AddBlock = [&] (const string & block)
+      {
+        newblocks.Append (&block);
+        offset += block.size();
+        return offset - block.size();
+      };
+    if (first_step)
+      {
+        EncodeGeometry();
+        series_geometry_offsets.SetSize0();
+        series_field_offsets.SetSize0();
+        series_headersize = series_datasize = offset = 0;
+        for (auto & block : geometry_blocks)
+          series_geometry_offsets.Append (AddBlock (block));
+      }
+    Array<string> fieldblocks = EncodeFields (value_field, compress, encoding == "base64");
+    for (auto & block : fieldblocks)
+      series_field_offsets.Append (AddBlock (block));
+
+    string header = VTUHeader (series_geometry_offsets, series_field_offsets, series_times);
+    size_t headersize = header.size() + appended.size();
+    auto PaddedHeader = [&] ()
+      { return header + string(series_headersize-headersize, ' ') + appended; };
+
+    if (headersize > series_headersize)
+      {
+        // copy the data of the previous steps to a file with a larger header
+        string olddata(series_datasize, ' ');
+        if (!first_step)
+          {
+            ifstream in(vtufilename, ios::binary);
+            in.seekg (series_headersize);
+            in.read (&olddata[0], series_datasize);
+            if (!in)
+              throw Exception ("VTKOutput: cannot read time series file " + vtufilename);
+          }
+        series_headersize = 2*headersize;
+        ofstream out(vtufilename, ios::binary);
+        out << PaddedHeader() << olddata;
+        for (auto block : newblocks)
+          out.write (block->data(), block->size());
+        out << tail;
+      }
+    else
+      {
+        // the new arrays and the tail first, the file stays valid until the header lists them
+        fstream out(vtufilename, ios::binary | ios::in | ios::out);
+        out.seekp (series_headersize + series_datasize);
+        for (auto block : newblocks)
+          out.write (block->data(), block->size());
+        out << tail;
+        out.seekp (0);
+        out << PaddedHeader();
+        if (!out)
+          throw Exception ("VTKOutput: cannot write time series file " + vtufilename);
+      }
+    series_datasize = offset;
+  }
+
+  /// parallel XML file, pieces are written by ranks 1 ... ntasks-1
+  template <int D> 
+  void VTKOutput<D>::WritePVTU (const string & pvtufilename, const string & piecename, int ntasks,
+                                FlatArray<double> steptimes)
+  {
+    ofstream out(pvtufilename);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n"
+        << "<PUnstructuredGrid GhostLevel=\"0\"";
+    if (steptimes.Size())
+      {
+        out.precision(16);
+        out << " TimeValues=\"";
+        for (double t : steptimes)
+          out << "\n" << t;
+        out << "\"";
+      }
+    out << ">\n<PPointData>\n";
+    for (auto field : value_field)
+      out << "<PDataArray type=\"Float32\" Name=\"" << field->Name()
+          << "\" NumberOfComponents=\"" << field->Dimension() << "\"/>\n";
+    out << "</PPointData>\n"
+        << "<PPoints>\n"
+        << "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n"
+        << "</PPoints>\n";
+    for (int i = 1; i < ntasks; i++)
+      out << "<Piece Source=\"" << FileBaseName (piecename) << "_" << i << ".vtu\"/>\n";
+    out << "</PUnstructuredGrid>\n"
+        << "</VTKFile>\n";
+  }
+
+  /// collection of all time steps written so far
+  template <int D> 
+  void VTKOutput<D>::WritePVD (const string & pvdfilename)
+  {
+    ofstream out(pvdfilename);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+        << "<Collection>\n";
+    out.precision(16);
+    for (size_t i = 0; i < times.Size(); i++)
+      out << "<DataSet timestep=\"" << times[i] << "\" group=\"\" part=\"0\" file=\""
+          << timefiles[i] << "\"/>\n";
+    out << "</Collection>\n"
+        << "</VTKFile>\n";
+  }
     
 
   template <int D> 
-  void VTKOutput<D>::Do (LocalHeap & lh, const BitArray * drawelems)
+  void VTKOutput<D>::Do (LocalHeap & lh, const BitArray * drawelems, double time)
   {
+    static Timer t("VTKOutput::Do"); RegionTimer reg(t);
+
+    if (time >= 0 && format != "vtu")
+      throw Exception ("VTKOutput: time series need format 'vtu'");
+
     ostringstream filenamefinal;
     filenamefinal << filename;
     if (output_cnt > 0)
       filenamefinal << "_" << output_cnt;
-    filenamefinal << ".vtk";
-    fileout = make_shared<ofstream>(filenamefinal.str());
-    cout << " Writing VTK-Output";
-    if (output_cnt > 0)
-      cout << " ( " << output_cnt << " )";
-    cout << ":" << flush;
+    string basename = filenamefinal.str();
+
+    auto comm = ma->GetCommunicator();
+    int ntasks = MyMPI_GetNTasks(comm);
+    int id = MyMPI_GetId(comm);
+
+    if (format == "vtk")
+      fileout = make_shared<ofstream>(basename + ".vtk");
+    if (id == 0)
+      {
+        cout << " Writing VTK-Output";
+        if (output_cnt > 0)
+          cout << " ( " << output_cnt << " )";
+        cout << ":" << flush;
+      }
     
     output_cnt++;
 
-    ResetArrays();
+    // geometry of the previous output is reused unless the mesh changed or moved
+    bool keep_geometry = geometry_valid && !drawelems && !ma->GetDeformation()
+      && geometry_timestamp == ma->GetGeometryTimeStamp();
+    if (!keep_geometry)
+      {
+        ResetArrays();
+        // the next time step starts a new series file
+        series_base = "";
+      }
 
     Array<IntegrationPoint> ref_vertices_tet(0), ref_vertices_prism(0), ref_vertices_trig(0), ref_vertices_quad(0), ref_vertices_hex(0);
     Array<INT<ELEMENT_MAXPOINTS+1>> ref_tets(0), ref_prisms(0), ref_trigs(0), ref_quads(0), ref_hexes(0);
-    FlatArray<IntegrationPoint> ref_vertices;
-    FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
     /*
     if (D==3)
       FillReferenceData3D(ref_vertices,ref_tets);
@@ -439,90 +792,158 @@ namespace ngcomp
     FillReferenceQuad(ref_vertices_quad,ref_quads);
     FillReferenceTrig(ref_vertices_trig,ref_trigs);
     FillReferenceHex(ref_vertices_hex,ref_hexes);
-      
-    // header:
-    *fileout << "# vtk DataFile Version 3.0" << endl;
-    *fileout << "vtk output" << endl;
-    *fileout << "ASCII" << endl;
-    *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
 
-    int ne = ma->GetNE();
+    auto GetReference = [&] (ELEMENT_TYPE eltype, FlatArray<IntegrationPoint> & ref_vertices,
+                             FlatArray<INT<ELEMENT_MAXPOINTS+1>> & ref_elems) -> unsigned char
+      {
+        switch(eltype)
+          {
+          case ET_TRIG:
+            ref_vertices.Assign(ref_vertices_trig);
+            ref_elems.Assign(ref_trigs);
+            return 5;
+          case ET_QUAD:
+            ref_vertices.Assign(ref_vertices_quad);
+            ref_elems.Assign(ref_quads);
+            return 9;
+          case ET_TET:
+            ref_vertices.Assign(ref_vertices_tet);
+            ref_elems.Assign(ref_tets);
+            return 10;
+          case ET_HEX:
+            ref_vertices.Assign(ref_vertices_hex);
+            ref_elems.Assign(ref_hexes);
+            return 12;
+          case ET_PRISM:
+            ref_vertices.Assign(ref_vertices_prism);
+            ref_elems.Assign(ref_prisms);
+            return 13;
+          default:
+            throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+          }
+      };
 
-    IntRange range = only_element >= 0 ? IntRange(only_element,only_element+1) : IntRange(ne);
-    
-    for ( int elnr : range)
-    {
-      if (drawelems && !(drawelems->Test(elnr)))
-          continue;
-      
-      HeapReset hr(lh);
+    if (!keep_geometry)
+      {
+        int ne = ma->GetNE();
 
-      ElementId ei(VOL, elnr);
-      ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
-      ELEMENT_TYPE eltype = ma->GetElType(ei);
+        IntRange range = only_element >= 0 ? IntRange(only_element,only_element+1) : IntRange(ne);
 
-      switch(eltype)
-      {
-      case ET_TRIG:
-        ref_vertices.Assign(ref_vertices_trig);
-        ref_elems.Assign(ref_trigs);
-        break;
-      case ET_QUAD:
-        ref_vertices.Assign(ref_vertices_quad);
-        ref_elems.Assign(ref_quads);
-        break;
-      case ET_TET:
-        ref_vertices.Assign(ref_vertices_tet);
-        ref_elems.Assign(ref_tets);
-        break;
-      case ET_HEX:
-        ref_vertices.Assign(ref_vertices_hex);
-        ref_elems.Assign(ref_hexes);
-        break;        
-      case ET_PRISM:
-        ref_vertices.Assign(ref_vertices_prism);
-        ref_elems.Assign(ref_prisms);
-        break;
-      default:
-        throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
-      }
+        elnrs.SetSize(0);
+        for ( int elnr : range)
+          if (!drawelems || drawelems->Test(elnr))
+            elnrs.Append (elnr);
 
-      int offset = points.Size();
-      for ( auto ip : ref_vertices)
-      {
-        MappedIntegrationPoint<D,D> mip(ip, eltrans);
-        points.Append(mip.GetPoint());
+        firstpoint.SetSize (elnrs.Size()+1);
+        firstcell.SetSize (elnrs.Size()+1);
+        firstpoint[0] = firstcell[0] = 0;
+        for (size_t i = 0; i < elnrs.Size(); i++)
+          {
+            FlatArray<IntegrationPoint> ref_vertices;
+            FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
+            GetReference (ma->GetElType(ElementId(VOL, elnrs[i])), ref_vertices, ref_elems);
+            firstpoint[i+1] = firstpoint[i] + ref_vertices.Size();
+            firstcell[i+1] = firstcell[i] + ref_elems.Size();
+          }
+
+        points.SetSize (firstpoint.Last());
+        cells.SetSize (firstcell.Last());
+        celltypes.SetSize (firstcell.Last());
       }
-      
-      for (int i = 0; i < coefs.Size(); i++)
+    for (auto field : value_field)
+      field->SetSize (field->Dimension() * firstpoint.Last());
+
+    ParallelForRange
+      (elnrs.Size(), [&] (IntRange r)
+       {
+         LocalHeap slh = lh.Split();
+         for (size_t i : r)
+           {
+             HeapReset hr(slh);
+
+             ElementId ei(VOL, elnrs[i]);
+             ElementTransformation & eltrans = ma->GetTrafo (ei, slh);
+             FlatArray<IntegrationPoint> ref_vertices;
+             FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
+             unsigned char celltype = GetReference (ma->GetElType(ei), ref_vertices, ref_elems);
+
+             IntegrationRule ir(ref_vertices.Size(), &ref_vertices[0]);
+             auto & mir = static_cast<MappedIntegrationRule<D,D>&> (eltrans(ir, slh));
+
+             size_t offset = firstpoint[i];
+             if (!keep_geometry)
+               for (size_t j = 0; j < mir.Size(); j++)
+                 points[offset+j] = mir[j].GetPoint();
+
+             for (int k = 0; k < coefs.Size(); k++)
+               {
+                 const int dim = coefs[k]->Dimension();
+                 FlatMatrix<> values(mir.Size(), dim, slh);
+                 coefs[k]->Evaluate (mir, values);
+                 FlatVector<> field(mir.Size()*dim, &(*value_field[k])[dim*offset]);
+                 field = values.AsVector();
+               }
+
+             if (!keep_geometry)
+               for (size_t j = 0; j < ref_elems.Size(); j++)
+                 {
+                   INT<ELEMENT_MAXPOINTS+1> new_elem = ref_elems[j];
+                   for (int l = 1; l <= new_elem[0]; ++l)
+                     new_elem[l] += offset;
+                   cells[firstcell[i]+j] = new_elem;
+                   celltypes[firstcell[i]+j] = celltype;
+                 }
+           }
+       });
+
+    geometry_valid = !drawelems && !ma->GetDeformation();
+    geometry_timestamp = ma->GetGeometryTimeStamp();
+
+    if (format == "vtk")
       {
-        for ( auto ip : ref_vertices)
-        {
-          MappedIntegrationPoint<D,D> mip(ip, eltrans);
-          const int dim = coefs[i]->Dimension();
-          FlatVector<> tmp(dim,lh);
-          coefs[i]->Evaluate(mip,tmp);
-          for (int d = 0; d < dim; ++d)
-            value_field[i]->Append(tmp(d));
-        }
+        // header:
+        *fileout << "# vtk DataFile Version 3.0" << endl;
+        *fileout << "vtk output" << endl;
+        *fileout << "ASCII" << endl;
+        *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
+
+        PrintPoints();
+        PrintCells();
+        PrintCellTypes();
+        PrintFieldData();
       }
-      
-      for ( auto elem : ref_elems)
+    else if (time >= 0)
       {
-        INT<ELEMENT_MAXPOINTS+1> new_elem = elem;
-        for (int i = 1; i <= new_elem[0]; ++i)
-          new_elem[i] += offset;
-        cells.Append(new_elem);
+        if (series_base == "")
+          {
+            series_base = basename;
+            series_times.SetSize0();
+          }
+        series_times.Append (time);
+        if (ntasks == 1)
+          WriteVTUStep (series_base + ".vtu");
+        else if (id == 0)
+          WritePVTU (series_base + ".pvtu", series_base, ntasks, series_times);
+        else
+          WriteVTUStep (series_base + "_" + ToString(id) + ".vtu");
       }
+    else if (ntasks == 1)
+      WriteVTU (basename + ".vtu");
+    else if (id == 0)
+      WritePVTU (basename + ".pvtu", basename, ntasks, Array<double>());
+    else
+      WriteVTU (basename + "_" + ToString(id) + ".vtu");
 
-    }
-
-    PrintPoints();
-    PrintCells();
-    PrintCellTypes();
-    PrintFieldData();
+    if (time >= 0 && id == 0)
+      {
+        // the steps of one series file are selected by their time value
+        times.Append (time);
+        timefiles.Append (FileBaseName (series_base) + (ntasks > 1 ? ".pvtu" : ".vtu"));
+        WritePVD (filename + ".pvd");
+      }
       
-    cout << " Done." << endl;
+    if (id == 0)
+      cout << " Done." << endl;
   }    
 
   NumProcVTKOutput::NumProcVTKOutput (shared_ptr<PDE> apde, const Flags & flags)
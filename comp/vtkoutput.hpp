@@ -30,7 +30,8 @@ namespace ngcomp
   {
   public:
     virtual ~BaseVTKOutput() { ; }
-    virtual void Do (LocalHeap & lh, const BitArray * drawelems = 0) = 0;
+    /// time >= 0 adds the output as a time step to a vtu time series and a .pvd collection
+    virtual void Do (LocalHeap & lh, const BitArray * drawelems = 0, double time = -1) = 0;
   };
   
   template <int D> 
@@ -44,10 +45,40 @@ namespace ngcomp
     string filename;
     int subdivision;
     int only_element = -1;
+    /// "vtk" (legacy ASCII) or "vtu" (XML, .pvtu with MPI)
+    string format;
+    /// "raw" or "base64" appended data of vtu files
+    string encoding;
+    /// zlib compression of vtu data
+    bool compress;
 
     Array<shared_ptr<ValueField>> value_field;
     Array<Vec<D>> points;
     Array<INT<ELEMENT_MAXPOINTS+1>> cells;
+    Array<unsigned char> celltypes;
+
+    /// geometry is kept between outputs while only the fields change
+    bool geometry_valid = false;
+    size_t geometry_timestamp = 0;
+    Array<int> elnrs;
+    /// points and cells of element elnrs[i] start at firstpoint[i] and firstcell[i]
+    Array<size_t> firstpoint, firstcell;
+    /// encoded vtu blocks of points, connectivity, offsets and types
+    Array<string> geometry_blocks;
+
+    /// time steps of the .pvd collection
+    Array<double> times;
+    Array<string> timefiles;
+
+    /// Time steps with the same geometry go to one vtu file (without extension),
+    /// the geometry is stored once and every step adds its field arrays
+    string series_base;
+    Array<double> series_times;
+    /// offsets of the geometry arrays and of the field arrays of all steps
+    /// in the appended data section of the series file
+    Array<size_t> series_geometry_offsets, series_field_offsets;
+    /// bytes reserved for the xml header, and bytes of appended data
+    size_t series_headersize = 0, series_datasize = 0;
 
     int output_cnt = 0;
     
@@ -59,7 +90,8 @@ namespace ngcomp
                const Flags &,shared_ptr<MeshAccess>);
 
     VTKOutput (shared_ptr<MeshAccess>, const Array<shared_ptr<CoefficientFunction>> &,
-               const Array<string> &, string, int, int);
+               const Array<string> &, string, int, int,
+               string a_format = "vtk", string a_encoding = "raw", bool a_compress = false);
     virtual ~VTKOutput() { ; }
     
     void ResetArrays();
@@ -75,7 +107,16 @@ namespace ngcomp
     void PrintCellTypes();
     void PrintFieldData();    
 
-    virtual void Do (LocalHeap & lh, const BitArray * drawelems = 0);
+    void EncodeGeometry ();
+    string VTUHeader (FlatArray<size_t> geometry_offsets, FlatArray<size_t> field_offsets,
+                      FlatArray<double> steptimes);
+    void WriteVTU (const string & vtufilename);
+    void WriteVTUStep (const string & vtufilename);
+    void WritePVTU (const string & pvtufilename, const string & piecename, int ntasks,
+                    FlatArray<double> steptimes);
+    void WritePVD (const string & pvdfilename);
+
+    virtual void Do (LocalHeap & lh, const BitArray * drawelems = 0, double time = -1);
   };
 
 
@@ -72,6 +72,51 @@ namespace ngfem
     {
       Cast(fel).CalcMappedDShape (mir, mat);      
     }
+
+    static constexpr bool SUPPORT_REFERENCE = true;
+
+    static void GenerateReferenceMatrixSIMDIR (const FiniteElement & fel,
+                                               const SIMD_IntegrationRule & ir,
+                                               BareSliceMatrix<SIMD<double>> refmat,
+                                               LocalHeap & lh)
+    {
+      HeapReset hr(lh);
+      FlatMatrixFixWidth<D> dshape(fel.GetNDof(), lh);
+      for (size_t i = 0; i < ir.Size(); i++)
+        for (size_t k = 0; k < SIMD<double>::Size(); k++)
+          {
+            Cast(fel).CalcDShape (ir[i][k], dshape);
+            for (size_t j = 0; j < fel.GetNDof(); j++)
+              for (int l = 0; l < D; l++)
+                refmat(j*D+l, i)[k] = dshape(j,l);
+          }
+    }
+
+    static void MapReferenceMatrixSIMDIR (const FiniteElement & fel,
+                                          const SIMD_BaseMappedIntegrationRule & bmir,
+                                          BareSliceMatrix<SIMD<double>> refmat,
+                                          BareSliceMatrix<SIMD<double>> mat)
+    {
+      if (bmir.DimSpace() != D)
+        {
+          Cast(fel).CalcMappedDShape (bmir, mat);
+          return;
+        }
+      auto & mir = static_cast<const SIMD_MappedIntegrationRule<D,D>&> (bmir);
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          Mat<D,D,SIMD<double>> jacinv = mir[i].GetJacobianInverse();
+          for (size_t j = 0; j < fel.GetNDof(); j++)
+            {
+              Vec<D,SIMD<double>> hv;
+              for (int l = 0; l < D; l++)
+                hv(l) = refmat(j*D+l, i);
+              Vec<D,SIMD<double>> grad = Trans(jacinv) * hv;
+              for (int l = 0; l < D; l++)
+                mat(j*D+l, i) = grad(l);
+            }
+        }
+    }
     
     ///
     template <typename MIP, class TVX, class TVY>
@@ -325,6 +370,26 @@ namespace ngfem
     {
       Cast(fel).CalcShape (mir.IR(), mat);      
     }
+
+    static constexpr bool SUPPORT_REFERENCE = true;
+
+    static void GenerateReferenceMatrixSIMDIR (const FiniteElement & fel,
+                                               const SIMD_IntegrationRule & ir,
+                                               BareSliceMatrix<SIMD<double>> refmat,
+                                               LocalHeap & lh)
+    {
+      Cast(fel).CalcShape (ir, refmat);
+    }
+
+    static void MapReferenceMatrixSIMDIR (const FiniteElement & fel,
+                                          const SIMD_BaseMappedIntegrationRule & mir,
+                                          BareSliceMatrix<SIMD<double>> refmat,
+                                          BareSliceMatrix<SIMD<double>> mat)
+    {
+      for (size_t j = 0; j < fel.GetNDof(); j++)
+        for (size_t i = 0; i < mir.Size(); i++)
+          mat(j,i) = refmat(j,i);
+    }
    
     template <typename MIP, class TVX, class TVY>
     static void Apply (const FiniteElement & fel, const MIP & mip,
@@ -4,10 +4,14 @@
 #include<l2hofefo.hpp>
 #include<regex>
 
+#ifdef WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
 namespace ngfem
 {
-    atomic<unsigned> Code::id_counter{0};
-
     void Code::AddLinkFlag(string flag)
     {
         if(std::find(std::begin(link_flags), std::end(link_flags), flag) == std::end(link_flags))
@@ -16,63 +20,237 @@ namespace ngfem
 
     string Code::AddPointer(const void *p)
     {
-        string name = "compiled_code_pointer" + ToString(id_counter++); 
+        // numbered within the compile unit, independent of earlier compilations
+        string name = "compiled_code_pointer" + pointer_prefix + ToString(pointer_values.size());
         top += "extern \"C\" void* " + name + ";\n";
-        stringstream s_ptr;
+        // the address is not part of the generated code, such that the
+        // compiled library can be reused from the cache
 #ifdef WIN32
-        s_ptr << "0x";
+        pointer += "__declspec(dllexport) ";
 #endif
-        s_ptr << std::hex << p;
-        pointer += "void *" + name + " = reinterpret_cast<void*>(" + s_ptr.str() + ");\n";
+        pointer += "void *" + name + " = nullptr;\n";
+        pointer_values.push_back (std::make_pair(name, p));
         return name;
     }
 
-    unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags )
+    // 64 bit FNV-1a hash, stable across runs and platforms
+    static string HashString (const string & str)
+    {
+      uint64_t hash = 14695981039346656037ull;
+      for (unsigned char c : str)
+        {
+          hash ^= c;
+          hash *= 1099511628211ull;
+        }
+      stringstream ss;
+      ss << std::hex << setw(16) << setfill('0') << hash;
+      return ss.str();
+    }
+
+    static string GetCompileCacheDir ()
+    {
+      const char * env = getenv("NGS_COMPILE_CACHE");
+      if (env)
+        return (string(env) == "0") ? string("") : string(env);
+#ifdef WIN32
+      const char * home = getenv("LOCALAPPDATA");
+#else
+      const char * home = getenv("HOME");
+#endif
+      if (!home) return "";
+      return string(home) + "/.cache/ngsolve";
+    }
+
+    // create all directories in path
+    static void MakeDirectories (const string & path)
+    {
+      for (size_t pos = 1; pos <= path.size(); pos++)
+        if (pos == path.size() || path[pos] == '/' || path[pos] == '\\')
+          {
+            string dir = path.substr(0, pos);
+#ifdef WIN32
+            _mkdir(dir.c_str());
+#else
+            mkdir(dir.c_str(), 0755);
+#endif
+          }
+    }
+
+    static bool FileExists (const string & filename)
+    {
+      return ifstream(filename).good();
+    }
+
+    // contents of the script found first in PATH, the ngscxx and ngsld
+    // wrappers contain the compiler, the flags and the include and library paths
+    static string ReadScriptInPath (const string & name)
+    {
+      const char * path = getenv("PATH");
+      if (!path) return "";
+#ifdef WIN32
+      char sep = ';';
+#else
+      char sep = ':';
+#endif
+      stringstream dirs(path);
+      string dir;
+      while (getline(dirs, dir, sep))
+        {
+          ifstream script(dir + "/" + name);
+          if (script)
+            {
+              stringstream ss;
+              ss << script.rdbuf();
+              return dir + "/" + name + "\n" + ss.str();
+            }
+        }
+      return "";
+    }
+
+    // -march=native code depends on the cpu it is compiled on
+    static string GetCPUDescription ()
+    {
+#ifdef WIN32
+      const char * id = getenv("PROCESSOR_IDENTIFIER");
+      return id ? id : "";
+#else
+      string descr;
+      ifstream cpuinfo("/proc/cpuinfo");
+      string line;
+      while (getline(cpuinfo, line) && line != "")
+        if (line.compare(0, 10, "model name") == 0 || line.compare(0, 5, "flags") == 0)
+          descr += line + "\n";
+      return descr;
+#endif
+    }
+
+#ifdef WIN32
+    static string CompileCommand (const string & file_prefix)
+    { return "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\""; }
+
+    static string LinkCommand (const string & prefix, const string & object_files,
+                               const std::vector<string> & link_flags)
+    { return "cmd /C \"ngsld.bat /OUT:" + prefix+".dll " + object_files + "\""; }
+#else
+    static string CompileCommand (const string & file_prefix)
+    { return "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o"; }
+
+    static string LinkCommand (const string & prefix, const string & object_files,
+                               const std::vector<string> & link_flags)
+    {
+      string slink = "ngsld -shared " + object_files + " -o " + prefix + ".so -lngstd -lngbla -lngfem";
+      for (auto flag : link_flags)
+        slink += " "+flag;
+      return slink;
+    }
+#endif
+
+    // everything the compiled library depends on: the generated code,
+    // the command lines, the compiler wrappers and the cpu
+    static string CompileCacheKey (const std::vector<string> &codes, const std::vector<string> &link_flags)
+    {
+      string key = ngsolve_version + "\n";
+      for (auto & code : codes)
+        key += code + "\n//-- next file --\n";
+      for (auto & flag : link_flags)
+        key += flag + " ";
+      key += "\n" + CompileCommand("code") + "\n" + LinkCommand("code", "code.o", link_flags) + "\n";
+#ifdef WIN32
+      key += ReadScriptInPath("ngscxx.bat") + ReadScriptInPath("ngsld.bat");
+#else
+      key += ReadScriptInPath("ngscxx") + ReadScriptInPath("ngsld");
+#endif
+      key += GetCPUDescription();
+      return key;
+    }
+
+    unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags,
+                                          const std::vector<std::pair<string,const void*>> &pointer_values)
     {
       static int counter = 0;
       static ngstd::Timer tcompile("CompiledCF::Compile");
       static ngstd::Timer tlink("CompiledCF::Link");
-      string object_files;
-      int i = 0;
-      string prefix = "code" + ToString(counter++);
-      for(string code : codes) {
-        string file_prefix = prefix+"_"+ToString(i++);
-        ofstream codefile(file_prefix+".cpp");
-        codefile << code;
-        codefile.close();
-        cout << IM(3) << "compiling..." << endl;
-        tcompile.Start();
+      static ngstd::Timer tcache("CompiledCF::Cache hit");
 #ifdef WIN32
-        string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
-        object_files += file_prefix+".obj ";
+      string lib_ext = ".dll";
 #else
-        string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
-        object_files += file_prefix+".o ";
+      string lib_ext = ".so";
 #endif
-        int err = system(scompile.c_str());
-        if (err) throw Exception ("problem calling compiler");
-        tcompile.Stop();
-      }
 
-      cout << IM(3) << "linking..." << endl;
-      tlink.Start();
+      string cache_dir = GetCompileCacheDir();
+      string cached_lib;
+      if (cache_dir != "")
+        cached_lib = cache_dir + "/compiled_cf_" + HashString(CompileCacheKey(codes, link_flags)) + lib_ext;
+
+      auto library = make_unique<SharedLibrary>();
+
+      if (cached_lib != "" && FileExists(cached_lib))
+        {
+          tcache.Start();
+          cout << IM(3) << "using cached library " << cached_lib << endl;
+          library->Load(cached_lib);
+          tcache.Stop();
+        }
+      else
+        {
+          string object_files;
+          int i = 0;
+          string prefix = "code" + ToString(counter++);
+          for(string code : codes) {
+            string file_prefix = prefix+"_"+ToString(i++);
+            ofstream codefile(file_prefix+".cpp");
+            codefile << code;
+            codefile.close();
+            cout << IM(3) << "compiling..." << endl;
+            tcompile.Start();
 #ifdef WIN32
-        string slink = "cmd /C \"ngsld.bat /OUT:" + prefix+".dll " + object_files + "\"";
+            object_files += file_prefix+".obj ";
 #else
-        string slink = "ngsld -shared " + object_files + " -o " + prefix + ".so -lngstd -lngbla -lngfem";
-        for (auto flag : link_flags)
-            slink += " "+flag;
+            object_files += file_prefix+".o ";
 #endif
-      int err = system(slink.c_str());
-      if (err) throw Exception ("problem calling linker");      
-      tlink.Stop();
-      cout << IM(3) << "done" << endl;
-      auto library = make_unique<SharedLibrary>();
+            string scompile = CompileCommand (file_prefix);
+            int err = system(scompile.c_str());
+            if (err) throw Exception ("problem calling compiler");
+            tcompile.Stop();
+          }
+
+          cout << IM(3) << "linking..." << endl;
+          tlink.Start();
+          string slink = LinkCommand (prefix, object_files, link_flags);
+          int err = system(slink.c_str());
+          if (err) throw Exception ("problem calling linker");      
+          tlink.Stop();
+          cout << IM(3) << "done" << endl;
+
+          if (cached_lib != "")
+            {
+              // write to a unique name and rename, several processes
+              // may fill the cache at the same time
+              MakeDirectories (cache_dir);
+              string tmp_lib = cached_lib + ".tmp" + ToString(MyMPI_GetId()) + "_"
+                + ToString(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+              bool ok;
+              {
+                ifstream src(prefix+lib_ext, ios::binary);
+                ofstream dst(tmp_lib, ios::binary);
+                ok = src && dst && (dst << src.rdbuf());
+              }
+              if (!ok || std::rename(tmp_lib.c_str(), cached_lib.c_str()) != 0)
+                {
+                  std::remove(tmp_lib.c_str());
+                  cout << IM(3) << "could not write compiled library to cache " << cache_dir << endl;
+                }
+            }
+
 #ifdef WIN32
-      library->Load(prefix+".dll");
+          library->Load(prefix+".dll");
 #else
-      library->Load("./"+prefix+".so");
+          library->Load("./"+prefix+".so");
 #endif
+        }
+
+      for (auto & pv : pointer_values)
+        *library->GetFunction<void**>(pv.first) = const_cast<void*>(pv.second);
       return library;
     }
 
@@ -46,12 +46,15 @@ namespace ngfem
     std::vector<string> link_flags;
 
     string pointer;
+    // values of the pointer variables, set after loading the library
+    std::vector<std::pair<string,const void*>> pointer_values;
+    // distinguishes the pointer names of several Codes in one library
+    string pointer_prefix;
 
     string AddPointer(const void *p );
 
     void AddLinkFlag(string flag);
 
-    static atomic<unsigned> id_counter;
     static string Map( string code, std::map<string,string> variables ) {
       for ( auto mapping : variables ) {
         string oldStr = '{'+mapping.first+'}';
@@ -174,7 +177,11 @@ namespace ngfem
     }
   }
 
-  unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries );
+  // compiled libraries are cached in the directory given by the
+  // environment variable NGS_COMPILE_CACHE (default $HOME/.cache/ngsolve),
+  // NGS_COMPILE_CACHE=0 disables the cache
+  unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries,
+                                        const std::vector<std::pair<string,const void*>> &pointer_values = {} );
   namespace detail {
       string GenerateL2ElementCode(int order);
   }
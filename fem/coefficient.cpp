@@ -3602,6 +3602,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     size_t max_inputsize;
     Array<int> dim;
     int totdim;
+    // in-process evaluation: steps write to re-used temporary slots
+    Array<int> slot_offset;   
+    int slotdim;
     Array<bool> is_complex;
     // Array<Timer*> timers;
     unique_ptr<SharedLibrary> library;
@@ -3656,6 +3659,59 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
          });
       cout << IM(3) << "inputs = " << endl << inputs << endl;
 
+      AllocateSlots();
+    }
+
+    // A temporary is needed only until its last use. Assign the results
+    // to slots re-used by later steps, which keeps the working set of the
+    // in-process evaluation small also for deep trees.
+    void AllocateSlots()
+    {
+      Array<int> last_use(steps.Size());
+      for (size_t i = 0; i < steps.Size(); i++)
+        {
+          last_use[i] = i;
+          for (int j : inputs[i])
+            last_use[j] = i;
+        }
+
+      Array<int> slot_owner, slot_size;
+      Array<int> slot_of_step(steps.Size());
+      for (size_t i = 0; i+1 < steps.Size(); i++)
+        {
+          int slot = -1;
+          for (size_t s = 0; s < slot_owner.Size(); s++)
+            if (last_use[slot_owner[s]] < int(i))
+              {
+                // prefer a slot which is large enough
+                if (slot == -1 || (slot_size[slot] < dim[i] && slot_size[s] > slot_size[slot]))
+                  slot = s;
+                if (slot_size[slot] >= dim[i]) break;
+              }
+          if (slot == -1)
+            {
+              slot = slot_owner.Size();
+              slot_owner.Append (i);
+              slot_size.Append (dim[i]);
+            }
+          slot_owner[slot] = i;
+          slot_size[slot] = max2(slot_size[slot], dim[i]);
+          slot_of_step[i] = slot;
+        }
+
+      Array<int> first(slot_size.Size());
+      slotdim = 0;
+      for (size_t s = 0; s < slot_size.Size(); s++)
+        {
+          first[s] = slotdim;
+          slotdim += slot_size[s];
+        }
+      slot_offset.SetSize (steps.Size());
+      for (size_t i = 0; i+1 < steps.Size(); i++)
+        slot_offset[i] = first[slot_of_step[i]];
+      slot_offset.Last() = -1;   // the last step writes to the result
+      cout << IM(5) << "CompiledCF: " << slot_size.Size() << " slots of total dim " << slotdim
+           << ", without re-use " << totdim << endl;
     }
 
     void RealCompile(int maxderiv, bool wait)
@@ -3665,6 +3721,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             maxderiv = 0;
         stringstream s;
         string pointer_code;
+        std::vector<std::pair<string,const void*>> pointer_values;
         string top_code = ""
              "#include<fem.hpp>\n"
              "using namespace ngfem;\n"
@@ -3679,12 +3736,14 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             Code code;
             code.is_simd = simd;
             code.deriv = deriv;
+            code.pointer_prefix = ToString(deriv) + (simd ? "s" : "") + "_";
             for (auto i : Range(steps)) {
               cout << IM(3) << "step " << i << ": " << typeid(*steps[i]).name() << endl;
               steps[i]->GenerateCode(code, inputs[i],i);
             }
 
             pointer_code += code.pointer;
+            pointer_values.insert (pointer_values.end(), code.pointer_values.begin(), code.pointer_values.end());
             top_code += code.top;
 
             // set results
@@ -3776,8 +3835,18 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
         }
 
         auto self = shared_from_this();
-        auto compile_func = [self, codes, link_flags, maxderiv] () {
-              self->library = CompileCode( codes, link_flags );
+        auto compile_func = [self, codes, link_flags, pointer_values, maxderiv] () {
+              try
+                {
+                  self->library = CompileCode( codes, link_flags, pointer_values );
+                }
+              catch (const std::exception & e)
+                {
+                  // not silenced by the message level, the user asked for compiled code
+                  cerr << "Compilation of CoefficientFunction failed: " << e.what()
+                       << ", using in-process evaluation" << endl;
+                  return;
+                }
               if(self->cf->IsComplex())
               {
                   self->compiled_function_simd_complex = self->library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
@@ -3807,7 +3876,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
           try {
             std::thread( compile_func ).detach();
           } catch (const std::exception &e) {
-              cerr << IM(3) << "Compilation of CoefficientFunction failed: " << e.what() << endl;
+              cerr << "Compilation of CoefficientFunction failed: " << e.what() << endl;
           }
         }
     }
@@ -3851,15 +3920,11 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     void T_Evaluate (const MIR & ir,
                      BareSliceMatrix<T,ORD> values) const
     {
-      ArrayMem<T, 1000> hmem(ir.Size()*totdim);
-      size_t mem_ptr = 0;
+      ArrayMem<T, 1000> hmem(ir.Size()*slotdim);
       ArrayMem<BareSliceMatrix<T,ORD>,100> temp(steps.Size());
       ArrayMem<BareSliceMatrix<T,ORD>, 100> in(max_inputsize);
       for (size_t i = 0; i < steps.Size()-1; i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ORD> (FlatMatrix<T,ORD> (dim[i], ir.Size(), &hmem[mem_ptr]));
-          mem_ptr += ir.Size()*dim[i];
-        }
+        new (&temp[i]) BareSliceMatrix<T,ORD> (FlatMatrix<T,ORD> (dim[i], ir.Size(), &hmem[ir.Size()*slot_offset[i]]));
       
       new (&temp.Last()) BareSliceMatrix<T,ORD>(values);
 
@@ -3876,15 +3941,12 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
                                  FlatVector<bool> nonzero_deriv, FlatVector<bool> nonzero_dderiv) const
     {
       typedef AutoDiffDiff<1,bool> T;
-      ArrayMem<T, 1000> hmem(totdim);
-      size_t mem_ptr = 0;
+      ArrayMem<T, 1000> hmem(slotdim+dim.Last());
       ArrayMem<FlatVector<T>,100> temp(steps.Size());
       ArrayMem<FlatVector<T>,100> in(max_inputsize);
-      for (size_t i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) FlatVector<T> (dim[i], &hmem[mem_ptr]);
-          mem_ptr += dim[i];
-        }
+      for (size_t i = 0; i < steps.Size()-1; i++)
+        new (&temp[i]) FlatVector<T> (dim[i], &hmem[slot_offset[i]]);
+      new (&temp.Last()) FlatVector<T> (dim.Last(), &hmem[slotdim]);
       
       for (size_t i = 0; i < steps.Size(); i++)
         {
@@ -3926,43 +3988,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
       T_Evaluate (ir, Trans(values));
       return;
-
-      /*
-      // static Timer t1("CompiledCF::Evaluate 1");
-      // static Timer t2("CompiledCF::Evaluate 2");
-      // static Timer t3("CompiledCF::Evaluate 3");
-
-      // t1.Start();
-      // int totdim = 0;
-      // for (int d : dim) totdim += d;
-      ArrayMem<double, 10000> hmem(ir.Size()*totdim);
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<double,ColMajor>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<double,ColMajor>, 100> in(max_inputsize);
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // temp[i].AssignMemory(ir.Size(), dim[i], &hmem[mem_ptr]);
-          new (&temp[i]) BareSliceMatrix<double,ColMajor> (dim[i], &hmem[mem_ptr], DummySize(dim[i], ir.Size()));          
-          mem_ptr += ir.Size()*dim[i];
-        }
-      // t1.Stop();
-      // t2.Start();
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // myglobalvar ++;
-          // timers[i]->Start();
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            // in[nr] = &temp[inputi[nr]];
-            new (&in[nr]) BareSliceMatrix<double,ColMajor> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-          // timers[i]->Stop();
-        }
-      
-      // values = temp.Last();
-      values.AddSize(ir.Size(), Dimension()) = Trans(temp.Last());
-      // t2.Stop();
-      */
     }
 
 
@@ -3978,30 +4003,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
       T_Evaluate (ir, Trans(values));
       return;
-      
-      /*
-      typedef AutoDiff<1,double> T;
-      ArrayMem<T,500> hmem(ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ColMajor> (dim[i], &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T,ColMajor> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-      
-      values.AddSize(ir.Size(), Dimension()) = Trans(temp.Last());
-      */
     }
 
 
@@ -4017,30 +4018,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
       T_Evaluate (ir, Trans(values));
       return;
-
-      /*
-      typedef AutoDiffDiff<1,double> T;
-      ArrayMem<T,500> hmem(ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ColMajor> (dim[i], &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T,ColMajor> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-      
-      values.AddSize(ir.Size(), Dimension()) = Trans(temp.Last());
-      */
     }
 
 
@@ -4056,32 +4033,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
       T_Evaluate (ir, values);
       return;
-
-      /*
-      typedef AutoDiff<1,SIMD<double>> T;
-      // STACK_ARRAY(T, hmem, ir.Size()*totdim);
-      ArrayMem<T,500> hmem(ir.Size()*totdim);
-      size_t mem_ptr = 0;
-
-      ArrayMem<BareSliceMatrix<T>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T>,100> in(max_inputsize);
-
-      for (size_t i = 0; i < steps.Size()-1; i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T> (ir.Size(), &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-      // the final step goes to result matrix
-      new (&temp.Last()) BareSliceMatrix<T>(values);
-      
-      for (size_t i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (size_t nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-      */
     }
 
 
@@ -4097,33 +4048,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
       
       T_Evaluate (ir, values);
       return;
-
-      /*
-      typedef AutoDiffDiff<1,SIMD<double>> T;
-      // STACK_ARRAY(T, hmem, ir.Size()*totdim);
-      ArrayMem<T,500> hmem(ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<T>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T> (ir.Size(), &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T> (temp[inputi[nr]]);
-          // in[nr] = &temp[inputi[nr]];
-
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-
-      values.AddSize(Dimension(), ir.Size()) = temp.Last();
-      */
     }
 
     
@@ -4137,35 +4061,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
       T_Evaluate (ir, values);
       return;
-
-      /*
-      // STACK_ARRAY(SIMD<double>, hmem, ir.Size()*totdim);
-      ArrayMem<SIMD<double>,500> hmem(ir.Size()*totdim);            
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<SIMD<double>>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<SIMD<double>>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<SIMD<double>> (ir.Size(), &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // timers[i]->Start();          
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<SIMD<double>> (temp[inputi[nr]]);            
-          // in[nr] = &temp[inputi[nr]];
-
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-          // timers[i]->Stop();                    
-        }
-
-      BareSliceMatrix<SIMD<double>> temp_last = temp.Last();
-      values.AddSize(Dimension(), ir.Size()) = temp_last;
-      */
     }
 
     virtual void Evaluate (const BaseMappedIntegrationRule & ir, FlatMatrix<Complex> values) const
@@ -4194,231 +4089,6 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
       }
     }
 
-#ifdef OLD
-    [[deprecated]]
-    virtual void EvaluateDeriv (const BaseMappedIntegrationRule & ir,
-                                FlatMatrix<double> values, FlatMatrix<double> deriv) const
-    {
-      /*
-      if(compiled_function_deriv)
-      {
-        compiled_function_deriv(ir, values, deriv);
-        return;
-      }
-      */
-      
-      /*
-      Array<Matrix<>*> temp;
-      Array<Matrix<>*> dtemp;
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // timers[i]->Start();
-          
-          temp.Append (new Matrix<>(ir.Size(), dim[i]));
-          dtemp.Append (new Matrix<>(ir.Size(), dim[i]));
-          
-          Array<FlatMatrix<>*> in;
-          for (int j : inputs[i])
-            in.Append (temp[j]);
-          Array<FlatMatrix<>*> din;
-          for (int j : inputs[i])
-            din.Append (dtemp[j]);
-          
-          steps[i] -> EvaluateDeriv (ir, in, din, *temp[i], *dtemp[i]);
-          // timers[i]->Stop();
-        }
-
-      values = *temp.Last();
-      deriv = *dtemp.Last();
-      
-      for (int i = 0; i < steps.Size(); i++)
-        delete temp[i];
-      for (int i = 0; i < steps.Size(); i++)
-        delete dtemp[i];
-      */
-
-      // int totdim = 0;
-      // for (int d : dim) totdim += d;
-      ArrayMem<double, 10000> hmem(ir.Size()*3*totdim);
-      int mem_ptr = 0;
-      
-      ArrayMem<FlatMatrix<>,100> temp(steps.Size());
-      ArrayMem<FlatMatrix<>,100> dtemp(steps.Size());
-      ArrayMem<FlatMatrix<>*, 20> in, din;
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // timers[i]->Start();
-          temp[i].AssignMemory(ir.Size(), dim[i], &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-          dtemp[i].AssignMemory(ir.Size(), dim[i], &hmem[mem_ptr]);          
-          mem_ptr += ir.Size()*dim[i];
-
-          in.SetSize(0);
-          din.SetSize(0);
-          for (int j : inputs[i])
-            in.Append (&temp[j]);
-          for (int j : inputs[i])
-            din.Append (&dtemp[j]);
-          steps[i] -> EvaluateDeriv (ir, in, din, temp[i], dtemp[i]);
-          // timers[i]->Stop();
-        }
-
-      values = temp.Last();
-      deriv = dtemp.Last();
-    }
-
-    [[deprecated]]
-    virtual void EvaluateDDeriv (const BaseMappedIntegrationRule & ir,
-                                 FlatMatrix<double> values, FlatMatrix<double> deriv,
-                                 FlatMatrix<double> dderiv) const
-    {
-      /*
-      if(compiled_function_dderiv)
-      {
-        compiled_function_dderiv(ir, values, deriv, dderiv);
-        return;
-      }
-      */
-      int totdim = 0;
-      for (int d : dim) totdim += d;
-      ArrayMem<double, 10000> hmem(ir.Size()*3*totdim);
-      int mem_ptr = 0;
-      
-      Array<FlatMatrix<>> temp(steps.Size());
-      Array<FlatMatrix<>> dtemp(steps.Size());
-      Array<FlatMatrix<>> ddtemp(steps.Size());
-      ArrayMem<FlatMatrix<>*, 20> in, din, ddin;
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // timers[i]->Start();          
-          temp[i].AssignMemory(ir.Size(), dim[i], &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-          dtemp[i].AssignMemory(ir.Size(), dim[i], &hmem[mem_ptr]);          
-          mem_ptr += ir.Size()*dim[i];
-          ddtemp[i].AssignMemory(ir.Size(), dim[i], &hmem[mem_ptr]);          
-          mem_ptr += ir.Size()*dim[i];
-
-          in.SetSize(0);
-          din.SetSize(0);
-          ddin.SetSize(0);
-          for (int j : inputs[i])
-            in.Append (&temp[j]);
-          for (int j : inputs[i])
-            din.Append (&dtemp[j]);
-          for (int j : inputs[i])
-            ddin.Append (&ddtemp[j]);
-
-          steps[i] -> EvaluateDDeriv (ir, in, din, ddin, temp[i], dtemp[i], ddtemp[i]);
-          // timers[i]->Stop();                    
-        }
-
-      values = temp.Last();
-      deriv = dtemp.Last();
-      dderiv = ddtemp.Last();
-    }
-#endif
-
-    
-#ifdef OLD
-    virtual void EvaluateDeriv (const SIMD_BaseMappedIntegrationRule & ir, 
-                                AFlatMatrix<double> values, AFlatMatrix<double> deriv) const
-    {
-      /*
-      if(compiled_function_simd_deriv)
-      {
-        compiled_function_simd_deriv(ir, values, deriv);
-        return;
-      }
-      */
-      // throw ExceptionNOSIMD ("*************** CompiledCF :: EvaluateDeriv not available without codegeneration");
-
-
-      STACK_ARRAY(SIMD<double>, hmem, 2*ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<AFlatMatrix<double>,100> temp(steps.Size());
-      ArrayMem<AFlatMatrix<double>,100> dtemp(steps.Size());
-      ArrayMem<AFlatMatrix<double>*,100> in(max_inputsize), din(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) AFlatMatrix<double> (dim[i], ir.IR().GetNIP(), &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-          new (&dtemp[i]) AFlatMatrix<double> (dim[i], ir.IR().GetNIP(), &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // timers[i]->Start();          
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            {
-              in[nr] = &temp[inputi[nr]];
-              din[nr] = &dtemp[inputi[nr]];
-            }
-
-          steps[i] -> EvaluateDeriv (ir, in.Range(0, inputi.Size()), din.Range(0, inputi.Size()),
-                                     temp[i], dtemp[i]);
-
-          // timers[i]->Stop();                    
-        }
-      values = temp.Last();
-      deriv = dtemp.Last();
-    }
-
-    virtual void EvaluateDDeriv (const SIMD_BaseMappedIntegrationRule & ir, 
-                                 AFlatMatrix<double> values, AFlatMatrix<double> deriv,
-                                 AFlatMatrix<double> dderiv) const
-    {
-      /*
-      if(compiled_function_simd_dderiv)
-      {
-        compiled_function_simd_dderiv(ir, values, deriv, dderiv);
-        return;
-      }
-      */
-      // throw ExceptionNOSIMD ("*************** CompiledCF :: EvaluateDDeriv coming soon");
-      STACK_ARRAY(SIMD<double>, hmem, 3*ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<AFlatMatrix<double>,100> temp(steps.Size());
-      ArrayMem<AFlatMatrix<double>,100> dtemp(steps.Size());
-      ArrayMem<AFlatMatrix<double>,100> ddtemp(steps.Size());
-      ArrayMem<AFlatMatrix<double>*,100> in(max_inputsize), din(max_inputsize), ddin(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) AFlatMatrix<double> (dim[i], ir.IR().GetNIP(), &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-          new (&dtemp[i]) AFlatMatrix<double> (dim[i], ir.IR().GetNIP(), &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-          new (&ddtemp[i]) AFlatMatrix<double> (dim[i], ir.IR().GetNIP(), &hmem[mem_ptr]);
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          // timers[i]->Start();          
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            {
-              in[nr] = &temp[inputi[nr]];
-              din[nr] = &dtemp[inputi[nr]];
-              ddin[nr] = &ddtemp[inputi[nr]];
-            }
-
-          steps[i] -> EvaluateDDeriv (ir, in.Range(0, inputi.Size()), din.Range(0, inputi.Size()),
-                                      ddin.Range(0, inputi.Size()),
-                                      temp[i], dtemp[i], ddtemp[i]);
-          // timers[i]->Stop();                    
-        }
-      values = temp.Last();
-      deriv = dtemp.Last();
-      dderiv = ddtemp.Last();
-    }
-#endif
-    
 
 
     
@@ -4572,7 +4242,11 @@ class RealCF : public CoefficientFunctionNoDerivative
   shared_ptr<CoefficientFunction> Compile (shared_ptr<CoefficientFunction> c, bool realcompile, int maxderiv, bool wait)
   {
     auto cf = make_shared<CompiledCoefficientFunction> (c);
-    if(realcompile)
+    // NGS_COMPILE_BACKEND=interpreter: never call the external compiler,
+    // e.g. on cluster nodes where forking a compiler from every rank is not possible
+    const char * backend = getenv("NGS_COMPILE_BACKEND");
+    bool use_interpreter = backend && string(backend) == "interpreter";
+    if(realcompile && !use_interpreter)
       cf->RealCompile(maxderiv, wait);
     return cf;
   }
@@ -76,6 +76,26 @@ namespace ngfem
                           + typeid(*this).name());
     
   }
+
+  void DifferentialOperator ::
+  CalcReferenceMatrix (const FiniteElement & fel,
+                       const SIMD_IntegrationRule & ir,
+                       BareSliceMatrix<SIMD<double>> refmat,
+                       LocalHeap & lh) const
+  {
+    throw Exception(string("Error: DifferentialOperator::CalcReferenceMatrix not overloaded, type = ")
+                    + typeid(*this).name());
+  }
+
+  void DifferentialOperator ::
+  MapReferenceMatrix (const FiniteElement & fel,
+                      const SIMD_BaseMappedIntegrationRule & mir,
+                      BareSliceMatrix<SIMD<double>> refmat,
+                      BareSliceMatrix<SIMD<double>> mat) const
+  {
+    throw Exception(string("Error: DifferentialOperator::MapReferenceMatrix not overloaded, type = ")
+                    + typeid(*this).name());
+  }
   
   void DifferentialOperator ::
   Apply (const FiniteElement & fel,
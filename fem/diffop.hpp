@@ -55,6 +55,27 @@ namespace ngfem
     {
       throw ExceptionNOSIMD (string("generate matrix simdir not implemented for diffop ") + typeid(DOP).name());
     }
+
+    /**
+       B-matrix on the reference element, and its mapping to the
+       physical element. Only if SUPPORT_REFERENCE is set.
+    */
+    static constexpr bool SUPPORT_REFERENCE = false;
+
+    template <typename FEL>
+    static void GenerateReferenceMatrixSIMDIR (const FEL & fel, const SIMD_IntegrationRule & ir,
+                                               BareSliceMatrix<SIMD<double>> refmat, LocalHeap & lh)
+    {
+      throw Exception (string("reference matrix not implemented for diffop ") + typeid(DOP).name());
+    }
+
+    template <typename FEL, typename MIR>
+    static void MapReferenceMatrixSIMDIR (const FEL & fel, const MIR & mir,
+                                          BareSliceMatrix<SIMD<double>> refmat,
+                                          BareSliceMatrix<SIMD<double>> mat)
+    {
+      throw Exception (string("reference matrix not implemented for diffop ") + typeid(DOP).name());
+    }
     /**
        Applies the B-matrix.
        Computes matrix-vector product with the B-matrix
@@ -244,6 +265,28 @@ namespace ngfem
 		const SIMD_BaseMappedIntegrationRule & mir,
 		BareSliceMatrix<SIMD<Complex>> mat) const;
 
+    /**
+       The element the B-matrix on the reference element depends on,
+       nullptr if the operator cannot split off the mapping.
+       Then CalcMatrix = MapReferenceMatrix (CalcReferenceMatrix).
+    */
+    virtual const FiniteElement * ReferenceElement (const FiniteElement & fel) const
+    { return nullptr; }
+
+    /// B-matrix of ReferenceElement(fel), Dim()*ndof rows, one column per point
+    NGS_DLL_HEADER virtual void
+    CalcReferenceMatrix (const FiniteElement & fel,
+                         const SIMD_IntegrationRule & ir,
+                         BareSliceMatrix<SIMD<double>> refmat,
+                         LocalHeap & lh) const;
+
+    /// maps the reference B-matrix to the rows of ReferenceElement(fel) in mat
+    NGS_DLL_HEADER virtual void
+    MapReferenceMatrix (const FiniteElement & fel,
+                        const SIMD_BaseMappedIntegrationRule & mir,
+                        BareSliceMatrix<SIMD<double>> refmat,
+                        BareSliceMatrix<SIMD<double>> mat) const;
+
     NGS_DLL_HEADER virtual void
     Apply (const FiniteElement & fel,
 	   const BaseMappedIntegrationPoint & mip,
@@ -460,6 +503,21 @@ namespace ngfem
     CalcMatrix (const FiniteElement & fel,
 		const SIMD_BaseMappedIntegrationRule & mir,
 		BareSliceMatrix<SIMD<double>> mat) const override;
+
+    virtual const FiniteElement * ReferenceElement (const FiniteElement & fel) const override
+    { return DIFFOP::SUPPORT_REFERENCE ? &fel : nullptr; }
+
+    virtual void
+    CalcReferenceMatrix (const FiniteElement & fel,
+                         const SIMD_IntegrationRule & ir,
+                         BareSliceMatrix<SIMD<double>> refmat,
+                         LocalHeap & lh) const override;
+
+    virtual void
+    MapReferenceMatrix (const FiniteElement & fel,
+                        const SIMD_BaseMappedIntegrationRule & mir,
+                        BareSliceMatrix<SIMD<double>> refmat,
+                        BareSliceMatrix<SIMD<double>> mat) const override;
     
 #ifndef FASTCOMPILE
     virtual void
@@ -107,6 +107,26 @@ namespace ngfem
     DIFFOP::GenerateMatrixSIMDIR (bfel, bmir, mat);
   }
 
+  template <typename DIFFOP>
+  void T_DifferentialOperator<DIFFOP> ::
+  CalcReferenceMatrix (const FiniteElement & bfel,
+                       const SIMD_IntegrationRule & ir,
+                       BareSliceMatrix<SIMD<double>> refmat,
+                       LocalHeap & lh) const
+  {
+    DIFFOP::GenerateReferenceMatrixSIMDIR (bfel, ir, refmat, lh);
+  }
+
+  template <typename DIFFOP>
+  void T_DifferentialOperator<DIFFOP> ::
+  MapReferenceMatrix (const FiniteElement & bfel,
+                      const SIMD_BaseMappedIntegrationRule & bmir,
+                      BareSliceMatrix<SIMD<double>> refmat,
+                      BareSliceMatrix<SIMD<double>> mat) const
+  {
+    DIFFOP::MapReferenceMatrixSIMDIR (bfel, bmir, refmat, mat);
+  }
+
   
   
 #ifndef FASTCOMPILE
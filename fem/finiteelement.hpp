@@ -56,6 +56,12 @@ namespace ngfem
 
     HD virtual bool ComplexShapes() const { return false; }
 
+    /**
+       vertex orientation class. Elements of the same type, order and
+       class have the same shape functions, -1 if unknown.
+    */
+    virtual int GetClassNr () const { return -1; }
+
     /// the name of the element family
     virtual string ClassName() const;
 
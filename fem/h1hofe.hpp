@@ -131,6 +131,36 @@ namespace ngfem
       order = ho;
     }
 
+    /// the shapes depend on the vertex numbers only through their ordering
+    virtual int GetClassNr () const override
+    {
+      if (nodalp2 || (ET != ET_SEGM && ET != ET_TRIG && ET != ET_QUAD && ET != ET_TET))
+        return -1;
+      for (int i = 0; i < N_EDGE; i++)
+        if (order_edge[i] != order) return -1;
+      for (int i = 0; i < N_FACE; i++)
+        if (order_face[i][0] != order || order_face[i][1] != order) return -1;
+      if (DIM == 3)
+        for (int j = 0; j < 3; j++)
+          if (order_cell[0][j] != order) return -1;
+      return ET_trait<ET>::GetClassNr (this->vnums);
+    }
+
+    using BASE::Evaluate;
+    using BASE::AddTrans;
+    using BASE::EvaluateGrad;
+    using BASE::AddGradTrans;
+
+    // sum factorization on tensor-product rules for quads and hexes
+    NGS_DLL_HEADER virtual void Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const override;
+    NGS_DLL_HEADER virtual void AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const override;
+    NGS_DLL_HEADER virtual void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & ir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const override;
+    NGS_DLL_HEADER virtual void AddGradTrans (const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const override;
+
+  protected:
+    /// calls func(SumFactorization<DIM>) if applicable for rule ir
+    template <typename FUNC>
+    bool SumFactorize (const SIMD_IntegrationRule & ir, FUNC func) const;
 
   };
 
@@ -8,6 +8,7 @@
 /*********************************************************************/
 
 #include "recursive_pol_tet.hpp"
+#include "sumfactorization.hpp"
 
 namespace ngfem
 {
@@ -37,7 +38,41 @@ namespace ngfem
     
     void CalcDualShape2 (const BaseMappedIntegrationPoint & mip, SliceVector<> shape) const
     { throw Exception ("dual shape not implemented, H1Ho"); }
-    
+
+    /**
+       Shape functions expanded in products of 1D functions (quads and hexes),
+       for sum factorization. The 1D functions are those of CalcTensorFactors1D.
+       Returns the order p of the 1D set, -1 if not available.
+    */
+    int GetTensorEntries (Array<TensorEntry<DIM>> & entries) const
+    { return -1; }
+
+    /// the p+1 1D functions: 1-t, t, t(1-t) T_k(2t-1) for k = 0,...,p-2
+    static void CalcTensorFactors1D (int p, double t, FlatVector<> f, FlatVector<> df)
+    {
+      AutoDiff<1> x(t, 0);
+      ArrayMem<AutoDiff<1>,40> hf(p+1);
+      hf[0] = 1-x;
+      hf[1] = x;
+      if (p >= 2)
+        QuadOrthoPol::EvalMult (p-2, 2*x-1, x*(1-x), &hf[2]);
+      for (int i = 0; i <= p; i++)
+        {
+          f(i) = hf[i].Value();
+          df(i) = hf[i].DValue(0);
+        }
+    }
+
+  private:
+    /// max order of all nodes
+    int TensorFactorOrder () const
+    {
+      int p = 1;
+      for (int i = 0; i < N_EDGE; i++) p = max2(p, int(order_edge[i]));
+      for (int i = 0; i < N_FACE; i++) p = max2(p, int(Max(order_face[i])));
+      if (DIM == 3) p = max2(p, int(Max(order_cell[0])));
+      return p;
+    }
   };
 
 
@@ -525,6 +560,165 @@ namespace ngfem
       }
   }
 
+  /* *********************** Tensor factors (sum factorization)  **********************/
+
+  /*
+    Edge bubbles are expanded in the face/cell bubbles, such that one
+    set of p+1 1D functions serves all shape functions:
+    IntLegNoBubble_k (x) = sum_{m<=k} c(k,m) T_m (x), T_m Chebyshev.
+    The Chebyshev coefficients are exact by Gauss-Chebyshev quadrature.
+  */
+  class EdgeToQuadOrthoPol
+  {
+  public:
+    enum { MAXK = 40 };
+  private:
+    double c[MAXK][MAXK];
+  public:
+    EdgeToQuadOrthoPol ()
+    {
+      const int n = MAXK;
+      double edgepol[MAXK], quadpol[MAXK];
+      for (int k = 0; k < n; k++)
+        for (int m = 0; m < n; m++)
+          c[k][m] = 0;
+      for (int j = 0; j < n; j++)
+        {
+          double x = cos (M_PI * (j+0.5) / n);
+          IntLegNoBubble::Eval (n-1, x, edgepol);
+          ChebyPolynomial::Eval (n-1, x, quadpol);
+          for (int k = 0; k < n; k++)
+            for (int m = 0; m <= k; m++)
+              c[k][m] += ((m == 0) ? 1.0 : 2.0) / n * edgepol[k] * quadpol[m];
+        }
+    }
+    double operator() (int k, int m) const { return c[k][m]; }
+    static const EdgeToQuadOrthoPol & Get ()
+    {
+      static EdgeToQuadOrthoPol coefs;
+      return coefs;
+    }
+  };
+
+  /*
+    reference coordinates of the vertices, vertex shapes are
+    products of 1-t (index 0) and t (index 1).
+    xi = sigma[v1]-sigma[v0] is +-(2t-1) in the direction where v0 and
+    v1 differ, the orthogonal polynomials of degree k pick up (+-1)^k.
+  */
+
+  template<> inline int
+  H1HighOrderFE_Shape<ET_QUAD> :: GetTensorEntries (Array<TensorEntry<2>> & entries) const
+  {
+    static const int vi[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    auto dir = [&] (int v0, int v1) { return (vi[v0][0] != vi[v1][0]) ? 0 : 1; };
+    int P = TensorFactorOrder();
+    if (P-2 >= EdgeToQuadOrthoPol::MAXK) return -1;
+    auto & etoq = EdgeToQuadOrthoPol::Get();
+    int ii = 0;
+
+    entries.SetSize0();
+    for (int i = 0; i < N_VERTEX; i++, ii++)
+      entries.Append ( { ii, INT<2> (vi[i][0], vi[i][1]), 1.0 } );
+
+    for (int i = 0; i < N_EDGE; i++)
+      if (order_edge[i] >= 2)
+        {
+          INT<2> e = this->GetVertexOrientedEdge(i);
+          int d = dir(e[0], e[1]);
+          double s = vi[e[1]][d] ? 1 : -1;
+          INT<2> f (vi[e[0]][0], vi[e[0]][1]);
+          for (int k = 0; k <= order_edge[i]-2; k++, ii++)
+            for (int m = k%2; m <= k; m += 2)
+              {
+                f[d] = 2+m;
+                entries.Append ( { ii, f, ((k % 2) ? s : 1) * etoq(k,m) } );
+              }
+        }
+
+    INT<2> p = order_face[0];
+    if (p[0] >= 2 && p[1] >= 2)
+      {
+        INT<4> fv = this->GetVertexOrientedFace(0);
+        int d1 = dir(fv[0], fv[1]), d2 = dir(fv[0], fv[3]);
+        double s1 = vi[fv[0]][d1] ? 1 : -1;
+        double s2 = vi[fv[0]][d2] ? 1 : -1;
+        INT<2> f;
+        for (int k = 0; k <= p[0]-2; k++)
+          for (int j = 0; j <= p[1]-2; j++, ii++)
+            {
+              f[d1] = 2+k;
+              f[d2] = 2+j;
+              entries.Append ( { ii, f, ((k % 2) ? s1 : 1) * ((j % 2) ? s2 : 1) } );
+            }
+      }
+    return P;
+  }
+
+
+  template<> inline int
+  H1HighOrderFE_Shape<ET_HEX> :: GetTensorEntries (Array<TensorEntry<3>> & entries) const
+  {
+    static const int vi[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+                                  { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+    auto dir = [&] (int v0, int v1)
+      {
+        for (int d = 0; d < 2; d++)
+          if (vi[v0][d] != vi[v1][d]) return d;
+        return 2;
+      };
+    int P = TensorFactorOrder();
+    if (P-2 >= EdgeToQuadOrthoPol::MAXK) return -1;
+    auto & etoq = EdgeToQuadOrthoPol::Get();
+    int ii = 0;
+
+    entries.SetSize0();
+    for (int i = 0; i < N_VERTEX; i++, ii++)
+      entries.Append ( { ii, INT<3> (vi[i][0], vi[i][1], vi[i][2]), 1.0 } );
+
+    for (int i = 0; i < N_EDGE; i++)
+      if (order_edge[i] >= 2)
+        {
+          INT<2> e = this->GetVertexOrientedEdge(i);
+          int d = dir(e[0], e[1]);
+          double s = vi[e[1]][d] ? 1 : -1;
+          INT<3> f (vi[e[0]][0], vi[e[0]][1], vi[e[0]][2]);
+          for (int k = 0; k <= order_edge[i]-2; k++, ii++)
+            for (int m = k%2; m <= k; m += 2)
+              {
+                f[d] = 2+m;
+                entries.Append ( { ii, f, ((k % 2) ? s : 1) * etoq(k,m) } );
+              }
+        }
+
+    for (int i = 0; i < N_FACE; i++)
+      {
+        INT<2> p = order_face[i];
+        if (p[0] < 2 || p[1] < 2) continue;
+        INT<4> fv = this->GetVertexOrientedFace(i);
+        int d1 = dir(fv[0], fv[1]), d2 = dir(fv[0], fv[3]);
+        double s1 = vi[fv[0]][d1] ? 1 : -1;
+        double s2 = vi[fv[0]][d2] ? 1 : -1;
+        INT<3> f (vi[fv[0]][0], vi[fv[0]][1], vi[fv[0]][2]);
+        for (int k = 0; k <= p[0]-2; k++)
+          for (int j = 0; j <= p[1]-2; j++, ii++)
+            {
+              f[d1] = 2+k;
+              f[d2] = 2+j;
+              entries.Append ( { ii, f, ((k % 2) ? s1 : 1) * ((j % 2) ? s2 : 1) } );
+            }
+      }
+
+    INT<3> p = order_cell[0];
+    if (p[0] >= 2 && p[1] >= 2 && p[2] >= 2)
+      for (int i = 0; i <= p[0]-2; i++)
+        for (int j = 0; j <= p[1]-2; j++)
+          for (int k = 0; k <= p[2]-2; k++, ii++)
+            entries.Append ( { ii, INT<3> (2+i, 2+j, 2+k), 1.0 } );
+    return P;
+  }
+
+
   /* ******************************** Pyramid  ************************************ */
 
   template<> template<typename Tx, typename TFA>  
@@ -656,6 +850,120 @@ namespace ngfem
       }
   }
 
+
+
+  /* *********************** Sum factorization  **********************/
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE> template <typename FUNC>
+  bool H1HighOrderFE<ET,SHAPES,BASE> :: 
+  SumFactorize (const SIMD_IntegrationRule & ir, FUNC func) const
+  {
+    // below, the shape-function loop is faster
+    if (ET != ET_QUAD && ET != ET_HEX) return false;
+    if (this->order < 5) return false;
+    if (!SumFactorization<DIM>::IsApplicable (ir)) return false;
+
+    ArrayMem<TensorEntry<DIM>,1000> entries;
+    int p = static_cast<const SHAPES&> (*this).GetTensorEntries (entries);
+    if (p < 1) return false;
+
+    SumFactorization<DIM> sf(ir, p+1, entries,
+                             [p] (double t, FlatVector<> f, FlatVector<> df)
+                             { SHAPES::CalcTensorFactors1D (p, t, f, df); });
+    func (sf);
+    return true;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
+  {
+    if (SumFactorize (ir, [&] (const SumFactorization<DIM> & sf)
+                      {
+                        constexpr size_t SW = SIMD<double>::Size();
+                        FlatVector<> fvalues(ir.Size()*SW, (double*)&values(0));
+                        sf.Evaluate (coefs, fvalues.Range(0, sf.GetNIP()));
+                        // padding lanes of the last SIMD entry
+                        fvalues.Range(sf.GetNIP(), fvalues.Size()) = 0.0;
+                      }))
+      return;
+    BASE::Evaluate (ir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    if (SumFactorize (ir, [&] (const SumFactorization<DIM> & sf)
+                      {
+                        sf.AddTrans (FlatVector<> (sf.GetNIP(), (double*)&values(0)), coefs);
+                      }))
+      return;
+    BASE::AddTrans (ir, values, coefs);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const
+  {
+    constexpr int D = (DIM > 0) ? DIM : 1;
+    if (bmir.DimSpace() == DIM &&
+        SumFactorize (bmir.IR(), [&] (const SumFactorization<DIM> & sf)
+                      {
+                        constexpr size_t SW = SIMD<double>::Size();
+                        auto & mir = static_cast<const SIMD_MappedIntegrationRule<D,D>&> (bmir);
+                        ArrayMem<double,3000> mem(D*mir.Size()*SW);
+                        FlatMatrix<> gradref(D, mir.Size()*SW, &mem[0]);
+                        gradref = 0.0;
+                        sf.EvaluateGrad (coefs, gradref.Cols(0, sf.GetNIP()));
+                        for (size_t i = 0; i < mir.Size(); i++)
+                          {
+                            auto jacinv = mir[i].GetJacobianInverse();
+                            Vec<D,SIMD<double>> gref;
+                            for (int k = 0; k < D; k++)
+                              gref(k) = SIMD<double> (&gradref(k, i*SW));
+                            for (int j = 0; j < D; j++)
+                              {
+                                SIMD<double> sum = 0.0;
+                                for (int k = 0; k < D; k++)
+                                  sum += jacinv(k,j) * gref(k);
+                                values(j,i) = sum;
+                              }
+                          }
+                      }))
+      return;
+    BASE::EvaluateGrad (bmir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> :: 
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    constexpr int D = (DIM > 0) ? DIM : 1;
+    if (bmir.DimSpace() == DIM &&
+        SumFactorize (bmir.IR(), [&] (const SumFactorization<DIM> & sf)
+                      {
+                        constexpr size_t SW = SIMD<double>::Size();
+                        auto & mir = static_cast<const SIMD_MappedIntegrationRule<D,D>&> (bmir);
+                        ArrayMem<double,3000> mem(D*mir.Size()*SW);
+                        FlatMatrix<> gradref(D, mir.Size()*SW, &mem[0]);
+                        for (size_t i = 0; i < mir.Size(); i++)
+                          {
+                            auto jacinv = mir[i].GetJacobianInverse();
+                            for (int k = 0; k < D; k++)
+                              {
+                                SIMD<double> sum = 0.0;
+                                for (int j = 0; j < D; j++)
+                                  sum += jacinv(k,j) * values(j,i);
+                                sum.Store (&gradref(k, i*SW));
+                              }
+                          }
+                        sf.AddGradTrans (gradref.Cols(0, sf.GetNIP()), coefs);
+                      }))
+      return;
+    BASE::AddGradTrans (bmir, values, coefs);
+  }
+
 }
 
 #endif
@@ -74,6 +74,24 @@ namespace ngfem
         throw Exception ("SetDefinedOn called with negative index");
   }
 
+  void Integrator :: SetIntegrationRule (ELEMENT_TYPE et, const IntegrationRule & ir)
+  {
+    userdefined_intrules[int(et)] = make_unique<IntegrationRule>(ir.Copy());
+    userdefined_simd_intrules[int(et)] = make_unique<SIMD_IntegrationRule>(*userdefined_intrules[int(et)]);
+    // the old rule is freed, a new one may get its address
+    ReferenceShapeCache::Invalidate();
+  }
+
+  void Integrator :: SetIntegrationRule (const IntegrationRule & ir)
+  {
+    for(auto i : Range(25))
+      {
+        userdefined_intrules[i] = make_unique<IntegrationRule>(ir.Copy());
+        userdefined_simd_intrules[i] = make_unique<SIMD_IntegrationRule>(*userdefined_intrules[i]);
+      }
+    ReferenceShapeCache::Invalidate();
+  }
+
   void Integrator :: SetName (const string & aname)
   { 
     name = aname; 
@@ -108,20 +108,9 @@ namespace ngfem
       definedon_element = adefinedonelem;
     }
 
-    void SetIntegrationRule(ELEMENT_TYPE et, const IntegrationRule& ir)
-    {
-      userdefined_intrules[int(et)] = make_unique<IntegrationRule>(ir.Copy());
-      userdefined_simd_intrules[int(et)] = make_unique<SIMD_IntegrationRule>(*userdefined_intrules[int(et)]);
-    }
+    void SetIntegrationRule(ELEMENT_TYPE et, const IntegrationRule& ir);
 
-    void SetIntegrationRule(const IntegrationRule& ir)
-    {
-      for(auto i : Range(25))
-        {
-          userdefined_intrules[i] = make_unique<IntegrationRule>(ir.Copy());
-          userdefined_simd_intrules[i] = make_unique<SIMD_IntegrationRule>(*userdefined_intrules[i]);
-        }
-    }
+    void SetIntegrationRule(const IntegrationRule& ir);
 
     inline const IntegrationRule& GetIntegrationRule(ELEMENT_TYPE et, int order) const
     {
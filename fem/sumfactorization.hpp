@@ -0,0 +1,258 @@
+#ifndef FILE_SUMFACTORIZATION
+#define FILE_SUMFACTORIZATION
+
+/*********************************************************************/
+/* File:   sumfactorization.hpp                                      */
+/* Date:   18. Oct. 2026                                             */
+/*********************************************************************/
+
+namespace ngfem
+{
+
+  /// shape function dof contributes val * prod_d f_{ind[d]} (x_d)
+  template <int DIM>
+  struct TensorEntry
+  {
+    int dof;
+    INT<DIM> ind;
+    double val;
+  };
+
+
+  /**
+     Sum factorization for scalar elements on tensor-product cells.
+
+     The element expands its shape functions in products of
+     one-dimensional functions taken from a common set f_0, ..., f_{nf-1}:
+
+       phi_i(x) = sum_{entries e, e.dof = i} e.val * prod_d f_{e.ind[d]} (x_d)
+
+     Values and gradients at the points of a tensor-product integration
+     rule (1D rules GetIRX/Y/Z, x running slowest) are computed by
+     contracting one direction after the other. The costs are
+     O(nf^DIM nq) instead of O(ndof nq^DIM) for the shape-function loop.
+  */
+  template <int DIM>
+  class SumFactorization
+  {
+    FlatArray<TensorEntry<DIM>> entries;
+    size_t nf;
+    size_t nq[3];
+    /// values and derivatives of the 1D functions, nq[d] x nf and transposed
+    FlatMatrix<> tab[3], dtab[3], tabt[3], dtabt[3];
+    ArrayMem<double, 1024> tabmem;
+
+  public:
+    /// tabulate (t, f, df) evaluates all 1D functions and derivatives at t
+    template <typename TAB>
+    SumFactorization (const SIMD_IntegrationRule & ir,
+                      size_t anf, FlatArray<TensorEntry<DIM>> aentries,
+                      const TAB & tabulate)
+      : entries(aentries), nf(anf)
+    {
+      const SIMD_IntegrationRule * ir1d[3] = { &ir.GetIRX(), &ir.GetIRY(), &ir.GetIRZ() };
+      size_t sum = 0;
+      for (int d = 0; d < DIM; d++)
+        {
+          nq[d] = ir1d[d]->GetNIP();
+          sum += 4*nq[d]*nf;
+        }
+      tabmem.SetSize (sum);
+      double * pmem = &tabmem[0];
+      for (int d = 0; d < DIM; d++)
+        {
+          size_t n = nq[d]*nf;
+          tab[d].AssignMemory (nq[d], nf, pmem);
+          dtab[d].AssignMemory (nq[d], nf, pmem+n);
+          tabt[d].AssignMemory (nf, nq[d], pmem+2*n);
+          dtabt[d].AssignMemory (nf, nq[d], pmem+3*n);
+          pmem += 4*n;
+
+          constexpr size_t SW = SIMD<double>::Size();
+          for (size_t q = 0; q < nq[d]; q++)
+            {
+              double t = (*ir1d[d])[q/SW](0)[q%SW];
+              tabulate (t, tab[d].Row(q), dtab[d].Row(q));
+            }
+          tabt[d] = Trans (tab[d]);
+          dtabt[d] = Trans (dtab[d]);
+        }
+    }
+
+    /// is ir a volume tensor-product rule with x running slowest ?
+    static bool IsApplicable (const SIMD_IntegrationRule & ir)
+    {
+      if (DIM < 2 || DIM > 3 || !ir.IsTP() || ir.Size() == 0) return false;
+      if (ir[0].VB() != VOL) return false;
+      size_t n = ir.GetIRX().GetNIP() * ir.GetIRY().GetNIP();
+      if (DIM == 3) n *= ir.GetIRZ().GetNIP();
+      return n == ir.GetNIP();
+    }
+
+    size_t GetNIP () const
+    {
+      size_t n = 1;
+      for (int d = 0; d < DIM; d++) n *= nq[d];
+      return n;
+    }
+
+    /// values(ip) = sum_i coefs(i) phi_i(ip)
+    void Evaluate (BareSliceVector<> coefs, FlatVector<> values) const
+    {
+      ArrayMem<double, 1000> cmem(CoefSize());
+      FlatVector<> c(cmem.Size(), &cmem[0]);
+      Scatter (coefs, c);
+      Forward (c, tab, tabt, values);
+    }
+
+    /// coefs(i) += sum_ip phi_i(ip) values(ip)
+    void AddTrans (FlatVector<> values, BareSliceVector<> coefs) const
+    {
+      ArrayMem<double, 1000> cmem(CoefSize());
+      FlatVector<> c(cmem.Size(), &cmem[0]);
+      Backward (values, tab, tabt, c, false);
+      Gather (c, coefs);
+    }
+
+    /// gradient with respect to reference coordinates, grad.Row(d) for direction d
+    void EvaluateGrad (BareSliceVector<> coefs, SliceMatrix<> grad) const
+    {
+      ArrayMem<double, 1000> cmem(CoefSize());
+      FlatVector<> c(cmem.Size(), &cmem[0]);
+      Scatter (coefs, c);
+      for (int d = 0; d < DIM; d++)
+        {
+          auto ops = DiffOps(d);
+          FlatVector<> row(grad.Width(), &grad(d,0));
+          Forward (c, ops.first.data(), ops.second.data(), row);
+        }
+    }
+
+    /// coefs(i) += sum_ip sum_d dphi_i/dx_d(ip) grad(d,ip)
+    void AddGradTrans (SliceMatrix<> grad, BareSliceVector<> coefs) const
+    {
+      ArrayMem<double, 1000> cmem(CoefSize());
+      FlatVector<> c(cmem.Size(), &cmem[0]);
+      for (int d = 0; d < DIM; d++)
+        {
+          auto ops = DiffOps(d);
+          FlatVector<> row(grad.Width(), &grad(d,0));
+          Backward (row, ops.first.data(), ops.second.data(), c, d > 0);
+        }
+      Gather (c, coefs);
+    }
+
+  private:
+    size_t CoefSize () const
+    {
+      size_t n = 1;
+      for (int d = 0; d < DIM; d++) n *= nf;
+      return n;
+    }
+
+    size_t Index (INT<DIM> f) const
+    {
+      size_t ind = 0;
+      for (int d = 0; d < DIM; d++)
+        ind = ind*nf + f[d];
+      return ind;
+    }
+
+    void Scatter (BareSliceVector<> coefs, FlatVector<> c) const
+    {
+      c = 0.0;
+      for (auto & e : entries)
+        c(Index(e.ind)) += e.val * coefs(e.dof);
+    }
+
+    void Gather (FlatVector<> c, BareSliceVector<> coefs) const
+    {
+      for (auto & e : entries)
+        coefs(e.dof) += e.val * c(Index(e.ind));
+    }
+
+    /// 1D operators with the derivative in direction dir
+    std::pair<std::array<FlatMatrix<>,3>, std::array<FlatMatrix<>,3>> DiffOps (int dir) const
+    {
+      std::array<FlatMatrix<>,3> ops, opst;
+      for (int d = 0; d < DIM; d++)
+        {
+          ops[d].AssignMemory (nq[d], nf, &((d == dir) ? dtab[d] : tab[d])(0,0));
+          opst[d].AssignMemory (nf, nq[d], &((d == dir) ? dtabt[d] : tabt[d])(0,0));
+        }
+      return { ops, opst };
+    }
+
+    /// c = a * b, for these small matrices faster than the blocked MultMatMat
+    static void MatMat (SliceMatrix<> a, SliceMatrix<> b, SliceMatrix<> c)
+    {
+      size_t n = a.Width(), w = b.Width();
+      for (size_t i = 0; i < a.Height(); i++)
+        {
+          double * pc = &c(i,0);
+          for (size_t j = 0; j < w; j++) pc[j] = 0.0;
+          for (size_t k = 0; k < n; k++)
+            {
+              double aik = a(i,k);
+              const double * pb = &b(k,0);
+              for (size_t j = 0; j < w; j++)
+                pc[j] += aik * pb[j];
+            }
+        }
+    }
+
+    /// u = (A_0 x A_1 x A_2) c, A_d is nq[d] x nf
+    void Forward (FlatVector<> c, const FlatMatrix<> * a, const FlatMatrix<> * at,
+                  FlatVector<> u) const
+    {
+      if (DIM == 2)
+        {
+          ArrayMem<double, 1000> mem1(nq[0]*nf);
+          FlatMatrix<> t1(nq[0], nf, &mem1[0]);
+          MatMat (a[0], FlatMatrix<>(nf, nf, c.Data()), t1);
+          MatMat (t1, at[1], FlatMatrix<>(nq[0], nq[1], u.Data()));
+        }
+      else
+        {
+          ArrayMem<double, 1000> mem1(nq[0]*nf*nf), mem2(nq[0]*nq[1]*nf);
+          FlatMatrix<> t1(nq[0], nf*nf, &mem1[0]);
+          FlatMatrix<> t2(nq[0]*nq[1], nf, &mem2[0]);
+          MatMat (a[0], FlatMatrix<>(nf, nf*nf, c.Data()), t1);
+          for (size_t q0 = 0; q0 < nq[0]; q0++)
+            MatMat (a[1], FlatMatrix<>(nf, nf, &t1(q0,0)),
+                    t2.Rows(q0*nq[1], (q0+1)*nq[1]));
+          MatMat (t2, at[2], FlatMatrix<>(nq[0]*nq[1], nq[2], u.Data()));
+        }
+    }
+
+    /// c (+)= (A_0 x A_1 x A_2)^T u
+    void Backward (FlatVector<> u, const FlatMatrix<> * a, const FlatMatrix<> * at,
+                   FlatVector<> c, bool add) const
+    {
+      ArrayMem<double, 1000> cmem(c.Size());
+      FlatVector<> hc(c.Size(), add ? &cmem[0] : c.Data());
+      if (DIM == 2)
+        {
+          ArrayMem<double, 1000> mem1(nq[0]*nf);
+          FlatMatrix<> t1(nq[0], nf, &mem1[0]);
+          MatMat (FlatMatrix<>(nq[0], nq[1], u.Data()), a[1], t1);
+          MatMat (at[0], t1, FlatMatrix<>(nf, nf, hc.Data()));
+        }
+      else
+        {
+          ArrayMem<double, 1000> mem1(nq[0]*nf*nf), mem2(nq[0]*nq[1]*nf);
+          FlatMatrix<> t1(nq[0], nf*nf, &mem1[0]);
+          FlatMatrix<> t2(nq[0]*nq[1], nf, &mem2[0]);
+          MatMat (FlatMatrix<>(nq[0]*nq[1], nq[2], u.Data()), a[2], t2);
+          for (size_t q0 = 0; q0 < nq[0]; q0++)
+            MatMat (at[1], t2.Rows(q0*nq[1], (q0+1)*nq[1]),
+                    FlatMatrix<>(nf, nf, &t1(q0,0)));
+          MatMat (at[0], t1, FlatMatrix<>(nf, nf*nf, hc.Data()));
+        }
+      if (add) c += hc;
+    }
+  };
+
+}
+
+#endif
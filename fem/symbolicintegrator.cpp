@@ -835,6 +835,59 @@ namespace ngfem
 
   
 
+  static atomic<size_t> refshapes_generation(0);
+
+  ReferenceShapeCache :: ReferenceShapeCache ()
+    : table(64), generation(refshapes_generation) { ; }
+
+  void ReferenceShapeCache :: Invalidate ()
+  {
+    refshapes_generation++;
+  }
+
+  bool ReferenceShapeCache ::
+  CalcMatrix (const DifferentialOperator & diffop, size_t nr,
+              const FiniteElement & fel,
+              const SIMD_BaseMappedIntegrationRule & mir,
+              BareSliceMatrix<SIMD<double>> mat,
+              LocalHeap & lh)
+  {
+    const FiniteElement * reffel = diffop.ReferenceElement (fel);
+    if (!reffel) return false;
+    int classnr = reffel->GetClassNr();
+    if (classnr < 0) return false;
+
+    // the address identifies the integration rule. Built-in rules are static,
+    // replacing a user-defined rule invalidates the cache.
+    TKEY key(INT<5,size_t> (nr, typeid(*reffel).hash_code(), reffel->GetNDof(), classnr,
+                            size_t(&mir.IR()[0])));
+    key[5] = mir.IR().Size();
+
+    shared_ptr<Matrix<SIMD<double>>> refmat;
+    {
+      MyLock lock(mutex);
+      if (generation != refshapes_generation)
+        {
+          table = ClosedHashTable<TKEY, shared_ptr<Matrix<SIMD<double>>>> (64);
+          generation = refshapes_generation;
+        }
+      if (table.Used (key))
+        refmat = table.Get (key);
+    }
+
+    if (!refmat)
+      {
+        refmat = make_shared<Matrix<SIMD<double>>> (diffop.Dim()*reffel->GetNDof(), mir.Size());
+        diffop.CalcReferenceMatrix (fel, mir.IR(), *refmat, lh);
+        MyLock lock(mutex);
+        table.Set (key, refmat);
+      }
+
+    diffop.MapReferenceMatrix (fel, mir, *refmat, mat);
+    return true;
+  }
+
+
   SymbolicBilinearFormIntegrator ::
   SymbolicBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb,
                                   VorB aelement_vb)
@@ -1214,9 +1267,12 @@ namespace ngfem
                       // bbmat2 = 0.0;
                       {
                         // ThreadRegionTimer regbmat(timer_SymbBFIbmat, TaskManager::GetThreadId());
-                        proxy1->Evaluator()->CalcMatrix(fel_trial, mir, bbmat1);
+                        if (!refshapes.CalcMatrix (*proxy1->Evaluator(), k1nr, fel_trial, mir, bbmat1, lh))
+                          proxy1->Evaluator()->CalcMatrix(fel_trial, mir, bbmat1);
                         if (!samediffop)
-                          proxy2->Evaluator()->CalcMatrix(fel_test, mir, bbmat2);
+                          if (!refshapes.CalcMatrix (*proxy2->Evaluator(), trial_proxies.Size()+l1nr,
+                                                     fel_test, mir, bbmat2, lh))
+                            proxy2->Evaluator()->CalcMatrix(fel_test, mir, bbmat2);
                       }
 
                       if (is_diagonal)
@@ -429,6 +429,33 @@ public:
     IntRange r = Dim() * fel.GetRange(comp);
     diffop->CalcMatrix (fel[comp], mir, mat.Rows(r));
   }
+
+  virtual const FiniteElement * ReferenceElement (const FiniteElement & bfel) const
+  {
+    const CompoundFiniteElement & fel = static_cast<const CompoundFiniteElement&> (bfel);
+    return diffop->ReferenceElement (fel[comp]);
+  }
+
+  virtual void
+  CalcReferenceMatrix (const FiniteElement & bfel,
+                       const SIMD_IntegrationRule & ir,
+                       BareSliceMatrix<SIMD<double>> refmat,
+                       LocalHeap & lh) const
+  {
+    const CompoundFiniteElement & fel = static_cast<const CompoundFiniteElement&> (bfel);
+    diffop->CalcReferenceMatrix (fel[comp], ir, refmat, lh);
+  }
+
+  virtual void
+  MapReferenceMatrix (const FiniteElement & bfel,
+                      const SIMD_BaseMappedIntegrationRule & mir,
+                      BareSliceMatrix<SIMD<double>> refmat,
+                      BareSliceMatrix<SIMD<double>> mat) const
+  {
+    const CompoundFiniteElement & fel = static_cast<const CompoundFiniteElement&> (bfel);
+    IntRange r = Dim() * fel.GetRange(comp);
+    diffop->MapReferenceMatrix (fel[comp], mir, refmat, mat.Rows(r));
+  }
   
   NGS_DLL_HEADER virtual void
   Apply (const FiniteElement & bfel,
@@ -530,6 +557,42 @@ public:
 
 
 
+  /**
+     B-matrices on the reference element, shared by all threads.
+     Keyed by proxy, element class, ndof, vertex orientation class and
+     integration rule, such that an element only needs the mapping
+     (e.g. the multiplication with the inverse Jacobian for gradients).
+     Invalidated whenever a finite element space is updated or an
+     integrator gets a user-defined integration rule.
+  */
+  class ReferenceShapeCache
+  {
+    typedef INT<6,size_t> TKEY;
+    ClosedHashTable<TKEY, shared_ptr<Matrix<SIMD<double>>>> table;
+    size_t generation;
+    MyMutex mutex;
+  public:
+    NGS_DLL_HEADER ReferenceShapeCache ();
+
+    /// clears all caches
+    NGS_DLL_HEADER static void Invalidate ();
+
+    /// B-matrix via the cached reference matrix, returns false if not supported
+    NGS_DLL_HEADER bool CalcMatrix (const DifferentialOperator & diffop, size_t nr,
+                                    const FiniteElement & fel,
+                                    const SIMD_BaseMappedIntegrationRule & mir,
+                                    BareSliceMatrix<SIMD<double>> mat,
+                                    LocalHeap & lh);
+
+    bool CalcMatrix (const DifferentialOperator & diffop, size_t nr,
+                     const FiniteElement & fel,
+                     const SIMD_BaseMappedIntegrationRule & mir,
+                     BareSliceMatrix<SIMD<Complex>> mat,
+                     LocalHeap & lh)
+    { return false; }
+  };
+
+
 
 
   class SymbolicLinearFormIntegrator : public LinearFormIntegrator
@@ -588,6 +651,7 @@ public:
 
     int trial_difforder, test_difforder;
     bool is_symmetric;
+    mutable ReferenceShapeCache refshapes;
   public:
     NGS_DLL_HEADER SymbolicBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb,
                                                    VorB aelement_boundary);
@@ -0,0 +1,612 @@
+/**************************************************************************/
+/* File:   amg.cpp                                                        */
+/* Date:   18. Oct. 2026                                                  */
+/**************************************************************************/
+
+/*
+   smoothed aggregation algebraic multigrid
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  static INLINE double Entry (double val, int k, int l) { return val; }
+  template <int N>
+  static INLINE double Entry (const Mat<N,N,double> & val, int k, int l) { return val(k,l); }
+
+  // fully stored copy with double entries, row k of block row i becomes row i*N+k
+  template <typename TM>
+  static shared_ptr<SparseMatrix<double>> ScalarMatrix (const BaseSparseMatrix & bmat)
+  {
+    auto pmat = dynamic_cast<const SparseMatrixTM<TM>*> (&bmat);
+    if (!pmat) return nullptr;
+    const SparseMatrixTM<TM> & mat = *pmat;
+    constexpr int N = mat_traits<TM>::HEIGHT;
+    bool symmetric = dynamic_cast<const SparseMatrixSymmetric<TM>*> (&bmat) != nullptr;
+
+    size_t h = mat.Height();
+    Array<int> cnt(h*N);
+    cnt = 0;
+    for (size_t i = 0; i < h; i++)
+      for (int j : mat.GetRowIndices(i))
+        for (int k = 0; k < N; k++)
+          {
+            cnt[i*N+k] += N;
+            if (symmetric && j != int(i))
+              cnt[j*N+k] += N;
+          }
+
+    // rows stay sorted: the stored lower part first, then the transposed
+    // entries in the order of their rows
+    auto smat = make_shared<SparseMatrix<double>> (cnt, mat.Width()*N);
+    cnt = 0;
+    for (size_t i = 0; i < h; i++)
+      {
+        auto ind = mat.GetRowIndices(i);
+        auto vals = mat.GetRowValues(i);
+        for (size_t jj = 0; jj < ind.Size(); jj++)
+          {
+            int j = ind[jj];
+            for (int k = 0; k < N; k++)
+              for (int l = 0; l < N; l++)
+                {
+                  int r = i*N+k, c = j*N+l;
+                  double val = Entry (vals(jj), k, l);
+                  smat->GetRowIndices(r)[cnt[r]] = c;
+                  smat->GetRowValues(r)(cnt[r]++) = val;
+                  if (symmetric && j != int(i))
+                    {
+                      smat->GetRowIndices(c)[cnt[c]] = r;
+                      smat->GetRowValues(c)(cnt[c]++) = val;
+                    }
+                }
+          }
+      }
+    return smat;
+  }
+
+  template <int N>
+  static shared_ptr<SparseMatrix<double>> ScalarMatrixMat (const BaseSparseMatrix & bmat)
+  {
+    if (auto smat = ScalarMatrix<Mat<N,N,double>> (bmat))
+      return smat;
+    return ScalarMatrixMat<N-1> (bmat);
+  }
+
+  template <>
+  shared_ptr<SparseMatrix<double>> ScalarMatrixMat<0> (const BaseSparseMatrix & bmat)
+  {
+    return ScalarMatrix<double> (bmat);
+  }
+
+
+  /// diag^{-1}, to estimate the spectrum of the Jacobi-preconditioned matrix
+  class DiagonalScaling : public BaseMatrix
+  {
+    FlatArray<double> invdiag;
+  public:
+    DiagonalScaling (FlatArray<double> ainvdiag) : invdiag(ainvdiag) { ; }
+    virtual bool IsComplex () const override { return false; }
+    virtual int VHeight () const override { return invdiag.Size(); }
+    virtual int VWidth () const override { return invdiag.Size(); }
+    virtual AutoVector CreateRowVector () const override
+    { return make_shared<VVector<double>> (invdiag.Size()); }
+    virtual AutoVector CreateColVector () const override
+    { return make_shared<VVector<double>> (invdiag.Size()); }
+
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override
+    {
+      auto fx = x.FVDouble();
+      auto fy = y.FVDouble();
+      ParallelForRange (invdiag.Size(), [&] (IntRange r)
+                        {
+                          for (size_t i : r)
+                            fy(i) += s * invdiag[i] * fx(i);
+                        });
+    }
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override
+    {
+      y = 0.0;
+      MultAdd (1, x, y);
+    }
+  };
+
+
+  /*
+    Greedy aggregation of the nodes (Vanek, Mandel, Brezina 1996).
+    Nodes i and j are strongly coupled if |A_ij| > eps sqrt(|A_ii| |A_jj|),
+    with the Frobenius norms of the node blocks. Returns the number of
+    aggregates, nodes without couplings get agg[i] = -1.
+  */
+  static int Aggregate (const SparseMatrix<double> & mat, FlatArray<int> dofnode,
+                        size_t nn, double eps, Array<int> & agg)
+  {
+    static Timer t("SmoothedAggregationAMG::Aggregate"); RegionTimer reg(t);
+
+    TableCreator<int> creator(nn);
+    for ( ; !creator.Done(); creator++)
+      for (size_t d = 0; d < dofnode.Size(); d++)
+        if (dofnode[d] != -1)
+          creator.Add (dofnode[d], d);
+    Table<int> nodedofs = creator.MoveTable();
+
+    Array<double> diagnorm(nn);
+    ParallelFor (nn, [&] (size_t i)
+                 {
+                   double sum = 0;
+                   for (int d : nodedofs[i])
+                     {
+                       auto ind = mat.GetRowIndices(d);
+                       auto vals = mat.GetRowValues(d);
+                       for (size_t k = 0; k < ind.Size(); k++)
+                         if (dofnode[ind[k]] == int(i))
+                           sum += sqr (vals(k));
+                     }
+                   diagnorm[i] = sqrt (sum);
+                 });
+
+    // scaled block norms of the off-diagonal blocks of node i
+    auto couplings = [&] (size_t i, Array<INT<2,double>> & pairs,
+                          Array<int> & nbs, Array<double> & vals)
+      {
+        pairs.SetSize0();
+        for (int d : nodedofs[i])
+          {
+            auto ind = mat.GetRowIndices(d);
+            auto rvals = mat.GetRowValues(d);
+            for (size_t k = 0; k < ind.Size(); k++)
+              {
+                int j = dofnode[ind[k]];
+                if (j != -1 && j != int(i) && rvals(k) != 0.0)
+                  pairs.Append (INT<2,double> (j, sqr(rvals(k))));
+              }
+          }
+        QuickSort (pairs, [] (INT<2,double> a, INT<2,double> b) { return a[0] < b[0]; });
+        nbs.SetSize0();
+        vals.SetSize0();
+        for (auto p : pairs)
+          if (nbs.Size() && nbs.Last() == int(p[0]))
+            vals.Last() += p[1];
+          else
+            {
+              nbs.Append (int(p[0]));
+              vals.Append (p[1]);
+            }
+        for (size_t k = 0; k < nbs.Size(); k++)
+          {
+            double dd = diagnorm[i]*diagnorm[nbs[k]];
+            vals[k] = (dd > 0) ? sqrt(vals[k] / dd) : 0;
+          }
+      };
+
+    Array<int> cnt(nn);
+    Array<bool> coupled(nn);
+    ParallelForRange (nn, [&] (IntRange r)
+                      {
+                        Array<INT<2,double>> pairs;
+                        Array<int> nbs;
+                        Array<double> vals;
+                        for (size_t i : r)
+                          {
+                            couplings (i, pairs, nbs, vals);
+                            coupled[i] = nbs.Size() > 0;
+                            cnt[i] = 0;
+                            for (double v : vals)
+                              if (v > eps) cnt[i]++;
+                          }
+                      });
+
+    Table<int> strong(cnt);
+    Table<double> strength(cnt);
+    ParallelForRange (nn, [&] (IntRange r)
+                      {
+                        Array<INT<2,double>> pairs;
+                        Array<int> nbs;
+                        Array<double> vals;
+                        for (size_t i : r)
+                          {
+                            couplings (i, pairs, nbs, vals);
+                            size_t cnti = 0;
+                            for (size_t k = 0; k < nbs.Size(); k++)
+                              if (vals[k] > eps)
+                                {
+                                  strong[i][cnti] = nbs[k];
+                                  strength[i][cnti++] = vals[k];
+                                }
+                          }
+                      });
+
+    agg.SetSize (nn);
+    agg = -1;
+    int naggs = 0;
+
+    // phase 1: a node with its strong neighbourhood, if none of them is taken
+    for (size_t i = 0; i < nn; i++)
+      {
+        if (agg[i] != -1 || strong[i].Size() == 0) continue;
+        bool free = true;
+        for (int j : strong[i])
+          if (agg[j] != -1) free = false;
+        if (!free) continue;
+        agg[i] = naggs;
+        for (int j : strong[i])
+          agg[j] = naggs;
+        naggs++;
+      }
+
+    // phase 2: join the aggregate of the strongest coupled neighbour
+    Array<int> agg1;
+    agg1 = agg;
+    for (size_t i = 0; i < nn; i++)
+      {
+        if (agg[i] != -1) continue;
+        double maxval = 0;
+        for (size_t k = 0; k < strong[i].Size(); k++)
+          {
+            int j = strong[i][k];
+            if (agg1[j] != -1 && strength[i][k] > maxval)
+              {
+                agg[i] = agg1[j];
+                maxval = strength[i][k];
+              }
+          }
+      }
+
+    // phase 3: the remaining nodes with their free strong neighbours
+    for (size_t i = 0; i < nn; i++)
+      {
+        if (agg[i] != -1 || !coupled[i]) continue;
+        agg[i] = naggs;
+        for (int j : strong[i])
+          if (agg[j] == -1)
+            agg[j] = naggs;
+        naggs++;
+      }
+
+    return naggs;
+  }
+
+
+  /*
+    Tentative prolongation: on every aggregate the rows of the
+    near-nullspace are factorized as Q R, Q gives the columns of the
+    prolongation, R the coarse near-nullspace. Linearly dependent
+    columns are dropped, the coarse nodes are the aggregates.
+  */
+  static shared_ptr<SparseMatrix<double>>
+  TentativeProlongation (FlatArray<int> dofnode, FlatArray<int> agg, int naggs,
+                         FlatMatrix<double> b, Matrix<double> & bc, Array<int> & coarsenode)
+  {
+    static Timer t("SmoothedAggregationAMG::TentativeProlongation"); RegionTimer reg(t);
+
+    size_t n = dofnode.Size();
+    size_t nns = b.Width();
+    auto dofagg = [&] (size_t d) { return dofnode[d] == -1 ? -1 : agg[dofnode[d]]; };
+
+    TableCreator<int> creator(naggs);
+    for ( ; !creator.Done(); creator++)
+      for (size_t d = 0; d < n; d++)
+        if (dofagg(d) != -1)
+          creator.Add (dofagg(d), d);
+    Table<int> aggdofs = creator.MoveTable();
+
+    Matrix<double> q(n, nns), r(naggs*nns, nns);
+    q = 0.0;
+    r = 0.0;
+    Array<int> rank(naggs);
+    ParallelFor (naggs, [&] (size_t a)
+                 {
+                   FlatArray<int> dofs = aggdofs[a];
+                   Matrix<double> qa(nns, dofs.Size());
+                   auto ra = r.Rows(a*nns, (a+1)*nns);
+                   int rk = 0;
+                   for (size_t k = 0; k < nns; k++)
+                     {
+                       auto v = qa.Row(rk);
+                       for (size_t i = 0; i < dofs.Size(); i++)
+                         v(i) = b(dofs[i], k);
+                       double norm0 = L2Norm (v);
+                       // modified Gram-Schmidt, twice
+                       for (int sweep = 0; sweep < 2; sweep++)
+                         for (int l = 0; l < rk; l++)
+                           {
+                             double rlk = InnerProduct (qa.Row(l), v);
+                             v -= rlk * qa.Row(l);
+                             ra(l,k) += rlk;
+                           }
+                       double norm = L2Norm (v);
+                       if (norm <= 1e-10 * norm0 || norm == 0) continue;
+                       v /= norm;
+                       ra(rk,k) = norm;
+                       rk++;
+                     }
+                   rank[a] = rk;
+                   for (size_t i = 0; i < dofs.Size(); i++)
+                     for (int l = 0; l < rk; l++)
+                       q(dofs[i], l) = qa(l,i);
+                 });
+
+    Array<int> firstc(naggs+1);
+    firstc[0] = 0;
+    for (int a = 0; a < naggs; a++)
+      firstc[a+1] = firstc[a] + rank[a];
+    size_t nc = firstc[naggs];
+
+    bc.SetSize (nc, nns);
+    coarsenode.SetSize (nc);
+    for (int a = 0; a < naggs; a++)
+      for (int l = 0; l < rank[a]; l++)
+        {
+          bc.Row(firstc[a]+l) = r.Row(a*nns+l);
+          coarsenode[firstc[a]+l] = a;
+        }
+
+    Array<int> cnt(n);
+    for (size_t d = 0; d < n; d++)
+      cnt[d] = (dofagg(d) != -1) ? rank[dofagg(d)] : 0;
+    auto prol = make_shared<SparseMatrix<double>> (cnt, nc);
+    ParallelFor (n, [&] (size_t d)
+                 {
+                   if (cnt[d] == 0) return;
+                   int a = dofagg(d);
+                   for (int l = 0; l < rank[a]; l++)
+                     {
+                       prol->GetRowIndices(d)[l] = firstc[a]+l;
+                       prol->GetRowValues(d)(l) = q(d,l);
+                     }
+                 });
+    return prol;
+  }
+
+
+  static void CalcDiagonal (const SparseMatrix<double> & mat, Array<double> & invdiag)
+  {
+    invdiag.SetSize (mat.Height());
+    ParallelFor (mat.Height(), [&] (size_t i)
+                 {
+                   double d = 0;
+                   auto ind = mat.GetRowIndices(i);
+                   for (size_t k = 0; k < ind.Size(); k++)
+                     if (ind[k] == int(i))
+                       d = mat.GetRowValues(i)(k);
+                   invdiag[i] = (d != 0) ? 1/d : 0;
+                 });
+  }
+
+
+  SmoothedAggregationAMG ::
+  SmoothedAggregationAMG (shared_ptr<BaseSparseMatrix> amat, shared_ptr<BitArray> afreedofs)
+    : mat(amat), freedofs(afreedofs)
+  {
+    if (mat->IsComplex())
+      throw Exception ("SmoothedAggregationAMG: complex matrices not supported");
+  }
+
+
+  void SmoothedAggregationAMG :: Setup ()
+  {
+    static Timer t("SmoothedAggregationAMG::Setup"); RegionTimer reg(t);
+    static Timer tprol("SmoothedAggregationAMG::Setup prolongation");
+    static Timer trap("SmoothedAggregationAMG::Setup Galerkin");
+
+    auto fine = make_shared<Level>();
+    fine->mat = ScalarMatrixMat<MAX_SYS_DIM> (*mat);
+    if (!fine->mat)
+      throw Exception ("SmoothedAggregationAMG: needs a real sparse matrix");
+    size_t n = fine->mat->Height();
+    size_t es = n / mat->Height();
+
+    // the non-free dofs are decoupled, with unit diagonal
+    fixed.SetSize (n);
+    fixed.Clear();
+    if (freedofs)
+      for (size_t d = 0; d < n; d++)
+        if (!freedofs->Test(d/es))
+          fixed.Set(d);
+    ParallelFor (n, [&] (size_t r)
+                 {
+                   auto ind = fine->mat->GetRowIndices(r);
+                   auto vals = fine->mat->GetRowValues(r);
+                   for (size_t k = 0; k < ind.Size(); k++)
+                     if (fixed.Test(r) || fixed.Test(ind[k]))
+                       vals(k) = (ind[k] == int(r)) ? 1.0 : 0.0;
+                 });
+
+    Array<int> nodes;
+    if (dofnode.Size())
+      {
+        if (dofnode.Size() != n)
+          throw Exception ("SmoothedAggregationAMG: node array has wrong size");
+        nodes = dofnode;
+      }
+    else
+      {
+        nodes.SetSize (n);
+        for (size_t d = 0; d < n; d++)
+          nodes[d] = d / es;
+      }
+    for (size_t d = 0; d < n; d++)
+      if (fixed.Test(d)) nodes[d] = -1;
+
+    Matrix<double> b;
+    if (nullspace)
+      {
+        if (nullspace->Size() != n)
+          throw Exception ("SmoothedAggregationAMG: near-nullspace vectors have wrong size");
+        b.SetSize (n, nullspace->NVecs());
+        b = nullspace->Data();
+      }
+    else
+      {
+        // the k-th dof of every node gets a one in vector k
+        size_t nn = 0;
+        for (int nd : nodes) nn = max2 (nn, size_t(nd+1));
+        Array<int> cnt(nn);
+        cnt = 0;
+        for (int nd : nodes)
+          if (nd != -1) cnt[nd]++;
+        int nns = 0;
+        for (int c : cnt) nns = max2 (nns, c);
+        b.SetSize (n, nns);
+        b = 0.0;
+        cnt = 0;
+        for (size_t d = 0; d < n; d++)
+          if (nodes[d] != -1)
+            b(d, cnt[nodes[d]]++) = 1;
+      }
+    for (size_t d = 0; d < n; d++)
+      if (fixed.Test(d)) b.Row(d) = 0.0;
+
+    levels.SetSize0();
+    levels.Append (fine);
+    for (int l = 0; ; l++)
+      {
+        Level & lev = *levels[l];
+        CalcDiagonal (*lev.mat, lev.invdiag);
+        // the Lanczos estimate is a lower bound
+        lev.lmax = 1.1 * EstimateMaxEigenvalue (*lev.mat, DiagonalScaling(lev.invdiag));
+        cout << IM(3) << "AMG level " << l << ": ndof = " << n
+             << ", nze = " << lev.mat->NZE() << endl;
+
+        if (l+1 >= maxlevels || n <= coarsesize) break;
+
+        size_t nn = 0;
+        for (int nd : nodes) nn = max2 (nn, size_t(nd+1));
+        Array<int> agg;
+        int naggs = Aggregate (*lev.mat, nodes, nn, threshold * pow (0.5, l), agg);
+
+        Matrix<double> bc;
+        Array<int> coarsenodes;
+        auto tent = TentativeProlongation (nodes, agg, naggs, b, bc, coarsenodes);
+        size_t nc = tent->Width();
+        if (nc == 0 || nc > 0.9 * n) break;
+
+        tprol.Start();
+        // P = (I - omega D^{-1} A) T
+        double omega = 4.0 / (3.0 * lev.lmax);
+        SparseMatrix<double> smooth(*lev.mat);
+        ParallelFor (n, [&] (size_t r)
+                     {
+                       auto ind = smooth.GetRowIndices(r);
+                       auto vals = smooth.GetRowValues(r);
+                       for (size_t k = 0; k < ind.Size(); k++)
+                         {
+                           vals(k) *= -omega * lev.invdiag[r];
+                           if (ind[k] == int(r)) vals(k) += 1;
+                         }
+                     });
+        lev.prol = dynamic_pointer_cast<SparseMatrix<double>> (MatMult (smooth, *tent));
+        lev.rest = dynamic_pointer_cast<SparseMatrix<double>> (TransposeMatrix (*lev.prol));
+        tprol.Stop();
+
+        trap.Start();
+        auto coarse = make_shared<Level>();
+        coarse->mat = dynamic_pointer_cast<SparseMatrix<double>> (lev.mat->Restrict (*lev.prol));
+        trap.Stop();
+
+        levels.Append (coarse);
+        b.SetSize (bc.Height(), bc.Width());
+        b = bc;
+        nodes = coarsenodes;
+        n = nc;
+      }
+
+    // sparse direct solver on the lower part of the coarsest matrix
+    auto & cmat = *levels.Last()->mat;
+    Array<int> cnt(cmat.Height());
+    for (size_t i = 0; i < cmat.Height(); i++)
+      {
+        cnt[i] = 0;
+        for (int j : cmat.GetRowIndices(i))
+          if (j <= int(i)) cnt[i]++;
+      }
+    auto symmat = make_shared<SparseMatrixSymmetric<double>> (cnt);
+    for (size_t i = 0; i < cmat.Height(); i++)
+      {
+        auto ind = cmat.GetRowIndices(i);
+        auto vals = cmat.GetRowValues(i);
+        for (size_t k = 0, l = 0; k < ind.Size(); k++)
+          if (ind[k] <= int(i))
+            {
+              symmat->GetRowIndices(i)[l] = ind[k];
+              symmat->GetRowValues(i)(l++) = vals(k);
+            }
+      }
+    coarsemat = symmat;
+    coarseinv = coarsemat->InverseMatrix();
+  }
+
+
+  double SmoothedAggregationAMG :: OperatorComplexity () const
+  {
+    size_t sum = 0;
+    for (auto & lev : levels)
+      sum += lev->mat->NZE();
+    return double(sum) / levels[0]->mat->NZE();
+  }
+
+
+  void SmoothedAggregationAMG :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SmoothedAggregationAMG::Mult"); RegionTimer reg(t);
+    if (!levels.Size())
+      throw Exception ("SmoothedAggregationAMG: call Setup first");
+
+    size_t n = levels[0]->mat->Height();
+    VVector<double> f(n), u(n);
+    auto fx = x.FVDouble();
+    auto ff = f.FV();
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          ff(i) = fixed.Test(i) ? 0.0 : fx(i);
+                      });
+
+    Cycle (0, f, u);
+
+    auto fy = y.FVDouble();
+    auto fu = u.FV();
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          fy(i) = fixed.Test(i) ? 0.0 : fu(i);
+                      });
+  }
+
+
+  void SmoothedAggregationAMG :: Cycle (size_t level, const BaseVector & f, BaseVector & u) const
+  {
+    const Level & lev = *levels[level];
+    if (level+1 == levels.Size())
+      {
+        u = *coarseinv * f;
+        return;
+      }
+
+    u = 0.0;
+    Smooth (lev, u, f);
+
+    auto r = f.CreateVector();
+    r = f - *lev.mat * u;
+
+    size_t nc = levels[level+1]->mat->Height();
+    VVector<double> fc(nc), uc(nc);
+    fc = *lev.rest * r;
+    Cycle (level+1, fc, uc);
+    u += *lev.prol * uc;
+
+    Smooth (lev, u, f);
+  }
+
+
+  // Chebyshev polynomial in diag^{-1} A on [lmax/ratio, lmax]
+  void SmoothedAggregationAMG :: Smooth (const Level & lev, BaseVector & u, const BaseVector & f) const
+  {
+    ChebyshevSmooth (*lev.mat, DiagonalScaling(lev.invdiag), lev.lmax, ratio, degree,
+                     u, f, smoothingsteps);
+  }
+
+}
@@ -0,0 +1,94 @@
+#ifndef FILE_NGS_AMG
+#define FILE_NGS_AMG
+
+/**************************************************************************/
+/* File:   amg.hpp                                                        */
+/* Date:   18. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Smoothed aggregation algebraic multigrid (Vanek, Mandel, Brezina).
+
+     For real sparse matrices with double or Mat<N,N> entries, symmetric
+     positive definite on the free dofs. The scalar dofs are grouped into
+     nodes (by default the block rows), strongly coupled nodes are
+     collected into aggregates. The tentative prolongation reproduces the
+     near-nullspace vectors (constants, or rigid body modes for
+     elasticity) exactly on every aggregate, and is smoothed by one damped
+     Jacobi step. Coarse matrices are Galerkin products.
+
+     Mult applies one V-cycle with Chebyshev-Jacobi smoothing and a sparse
+     direct solver on the coarsest level. Shared memory only.
+  */
+  class NGS_DLL_HEADER SmoothedAggregationAMG : public BaseMatrix
+  {
+    struct Level
+    {
+      shared_ptr<SparseMatrix<double>> mat;
+      Array<double> invdiag;
+      /// upper bound for the spectrum of diag^{-1} mat
+      double lmax;
+      /// prolongation from the next coarser level, and its transpose
+      shared_ptr<SparseMatrix<double>> prol, rest;
+    };
+
+    shared_ptr<BaseSparseMatrix> mat;
+    shared_ptr<BitArray> freedofs;
+    Array<int> dofnode;
+    shared_ptr<MultiVector> nullspace;
+
+    int maxlevels = 10;
+    size_t coarsesize = 500;
+    double threshold = 0.08;
+    int smoothingsteps = 1;
+    int degree = 2;
+    double ratio = 30;
+
+    Array<shared_ptr<Level>> levels;
+    /// fine level scalar dofs which are not free
+    BitArray fixed;
+    shared_ptr<BaseSparseMatrix> coarsemat;
+    shared_ptr<BaseMatrix> coarseinv;
+
+  public:
+    SmoothedAggregationAMG (shared_ptr<BaseSparseMatrix> amat,
+                            shared_ptr<BitArray> afreedofs = nullptr);
+
+    /// scalar dof -> node number, -1 for dofs not taking part in aggregation
+    void SetNodes (FlatArray<int> adofnode) { dofnode = adofnode; }
+    /// vectors of size Height()*EntrySize(), default: constant on every component of a node
+    void SetNearNullspace (shared_ptr<MultiVector> vecs) { nullspace = vecs; }
+
+    void SetMaxLevels (int amaxlevels) { maxlevels = amaxlevels; }
+    void SetCoarseSize (size_t size) { coarsesize = size; }
+    /// strength of connection threshold on the finest level, halved per level
+    void SetThreshold (double thres) { threshold = thres; }
+    void SetSmoothingSteps (int steps) { smoothingsteps = steps; }
+    void SetChebyshev (int adegree, double aratio) { degree = adegree; ratio = aratio; }
+
+    /// builds the hierarchy
+    void Setup ();
+
+    int GetNLevels () const { return levels.Size(); }
+    /// sum of the non-zero entries of all levels, divided by the ones of the finest
+    double OperatorComplexity () const;
+
+    virtual bool IsComplex () const override { return false; }
+    virtual int VHeight () const override { return mat->Height(); }
+    virtual int VWidth () const override { return mat->Width(); }
+    virtual AutoVector CreateRowVector () const override { return mat->CreateRowVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateColVector(); }
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+
+  private:
+    void Cycle (size_t level, const BaseVector & f, BaseVector & u) const;
+    void Smooth (const Level & lev, BaseVector & u, const BaseVector & f) const;
+  };
+
+}
+
+#endif
@@ -106,6 +106,19 @@ namespace ngla
     y += s * *temp;
   }
 
+  void BaseMatrix :: MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    auto hx = CreateRowVector();
+    auto hy = CreateColVector();
+    for (size_t i = 0; i < x.NVecs(); i++)
+      {
+        x.GetVector (i, hx);
+        y.GetVector (i, hy);
+        MultAdd (s, hx, hy);
+        y.SetVector (i, hy);
+      }
+  }
+
   void BaseMatrix :: MultAdd (Complex s, const BaseVector & x, BaseVector & y) const 
   {
     stringstream err;
@@ -265,6 +278,7 @@ namespace ngla
       case MUMPS:           return "mumps";
       case MASTERINVERSE:   return "masterinverse";
       case UMFPACK:         return "umfpack";
+      case SPARSECHOLESKY_ND: return "sparsecholesky_nd";
       }
     return "";
   }
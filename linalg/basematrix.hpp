@@ -13,7 +13,7 @@ namespace ngla
 
 
   // sets the solver which is used for InverseMatrix
-  enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE, UMFPACK };
+  enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE, UMFPACK, SPARSECHOLESKY_ND };
   extern string GetInverseName (INVERSETYPE type);
 
   /**
@@ -104,7 +104,8 @@ namespace ngla
     /// y += s Trans(matrix) * x
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const;
 
-
+    /// y[i] += s matrix * x[i] for all vectors, default applies the matrix to one vector after the other
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const;
 
 
     /**
@@ -160,6 +160,114 @@ namespace ngla
   }
 
 
+  static bool AnyParallel (std::initializer_list<const BaseVector*> vecs)
+  {
+    for (auto v : vecs)
+      if (v->GetParallelStatus() != NOT_PARALLEL) return true;
+    return false;
+  }
+
+  void FusedAdd (double s1, const BaseVector & x1, BaseVector & y1,
+                 double s2, const BaseVector & x2, BaseVector & y2)
+  {
+    if (AnyParallel ( { &x1, &y1, &x2, &y2 } ))
+      {
+        y1.Add (s1, x1);
+        y2.Add (s2, x2);
+        return;
+      }
+
+    static Timer t("FusedAdd");
+    RegionTimer reg(t);
+
+    auto fx1 = x1.FVDouble(), fy1 = y1.FVDouble();
+    auto fx2 = x2.FVDouble(), fy2 = y2.FVDouble();
+    if (fx1.Size() != fy1.Size() || fx2.Size() != fy1.Size() || fy2.Size() != fy1.Size())
+      throw Exception ("FusedAdd: vector sizes don't match");
+    t.AddFlops (2*fy1.Size());
+    
+    ParallelForRange (fy1.Range(), [=] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          {
+                            fy1(i) += s1 * fx1(i);
+                            fy2(i) += s2 * fx2(i);
+                          }
+                      });
+  }
+
+  void FusedAdd (Complex s1, const BaseVector & x1, BaseVector & y1,
+                 Complex s2, const BaseVector & x2, BaseVector & y2)
+  {
+    y1.Add (s1, x1);
+    y2.Add (s2, x2);
+  }
+
+  void ScaleAdd (double s, BaseVector & y, const BaseVector & x)
+  {
+    if (AnyParallel ( { &x, &y } ))
+      {
+        y.Scale (s);
+        y.Add (1, x);
+        return;
+      }
+
+    static Timer t("ScaleAdd");
+    RegionTimer reg(t);
+
+    auto fx = x.FVDouble(), fy = y.FVDouble();
+    if (fx.Size() != fy.Size())
+      throw Exception ("ScaleAdd: vector sizes don't match");
+    t.AddFlops (fy.Size());
+    
+    ParallelForRange (fy.Range(), [=] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          fy(i) = s * fy(i) + fx(i);
+                      });
+  }
+
+  void ScaleAdd (Complex s, BaseVector & y, const BaseVector & x)
+  {
+    y.Scale (s);
+    y.Add (1, x);
+  }
+
+  double AddInnerProduct (double s, const BaseVector & x, BaseVector & y,
+                          const BaseVector & z)
+  {
+    if (AnyParallel ( { &x, &y, &z } ) || y.IsComplex())
+      {
+        y.Add (s, x);
+        return InnerProduct (y, z);
+      }
+
+    static Timer t("AddInnerProduct");
+    RegionTimer reg(t);
+
+    auto fx = x.FVDouble(), fy = y.FVDouble(), fz = z.FVDouble();
+    if (fx.Size() != fy.Size() || fz.Size() != fy.Size())
+      throw Exception ("AddInnerProduct: vector sizes don't match");
+    t.AddFlops (2*fy.Size());
+    
+    double parts[16];
+    ParallelJob ([=,&parts] (TaskInfo ti)
+                 {
+                   auto r = ::Range(fy).Split (ti.task_nr, ti.ntasks);
+                   double sum = 0;
+                   for (size_t i : r)
+                     {
+                       fy(i) += s * fx(i);
+                       sum += fy(i) * fz(i);
+                     }
+                   parts[ti.task_nr] = sum;
+                 }, 16);
+    double sum = 0;
+    for (double part : parts) sum += part;
+    return sum;
+  }
+
+
   double BaseVector :: InnerProductD (const BaseVector & v2) const
   {
     return dynamic_cast<const S_BaseVector<double>&> (*this) . 
@@ -217,6 +325,16 @@ namespace ngla
       ist >> fv(i);
   }
 
+  void BaseVector :: DoArchive (Archive & ar)
+  {
+    size_t s = size;
+    ar & s;
+    if (s != size)
+      throw Exception ("BaseVector::DoArchive: vector size does not match archive");
+    FlatVector<double> fv = FVDouble();
+    ar.Do (fv.Size() ? &fv(0) : nullptr, fv.Size());
+  }
+
   size_t BaseVector :: CheckSum () const
   {
     size_t sum = 0;
@@ -597,6 +715,8 @@ namespace ngla
 
 
   void BaseVector :: Cumulate () const { ; }
+  void BaseVector :: StartCumulate () const { Cumulate(); }
+  void BaseVector :: FinishCumulate () const { ; }
   void BaseVector :: Distribute() const { ; }
   PARALLEL_STATUS BaseVector :: GetParallelStatus () const { return NOT_PARALLEL; }
   void BaseVector :: SetParallelStatus (PARALLEL_STATUS stat) const { ; }
@@ -816,6 +936,33 @@ namespace ngla
     return make_shared<S_BaseVectorPtr<TSCAL>> (this->size, es);
   }
 
+  template <typename TSCAL>
+  void S_BaseVectorPtr<TSCAL> :: DoArchive (Archive & ar)
+  {
+    if (!ar.Mapped())
+      {
+        BaseVector::DoArchive (ar);
+        return;
+      }
+
+    size_t s = this->size;
+    ar & s;
+    if (s != this->size)
+      throw Exception ("BaseVector::DoArchive: vector size does not match archive");
+    size_t bytes = this->size * es * sizeof(TSCAL);
+    if (ar.Output())
+      {
+        ar.DoBulk (pdata, bytes);
+        return;
+      }
+
+    // use the mapped file as vector memory
+    if (ownmem) delete [] pdata;
+    pdata = static_cast<TSCAL*> (ar.MapBulk (bytes));
+    ownmem = false;
+    mapped_memory = ar.GetMapping();
+  }
+
   template <typename TSCAL>
   AutoVector S_BaseVectorPtr<TSCAL> :: Range (size_t begin, size_t end) const
   {
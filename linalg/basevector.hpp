@@ -238,6 +238,7 @@ namespace ngla
     virtual void Load(istream & ist);
     virtual void SaveText(ostream & ost) const;
     virtual void LoadText(istream & ist);
+    virtual void DoArchive (Archive & ar);
 
     virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const;
     virtual size_t CheckSum () const;
@@ -339,6 +340,9 @@ namespace ngla
     */
   
     virtual void Cumulate () const;
+    /// split-phase Cumulate, allows to overlap communication with computation
+    virtual void StartCumulate () const;
+    virtual void FinishCumulate () const;
     virtual void Distribute() const;
     virtual PARALLEL_STATUS GetParallelStatus () const;
     virtual void SetParallelStatus (PARALLEL_STATUS stat) const;
@@ -509,6 +513,12 @@ namespace ngla
     virtual void Cumulate () const 
     { vec -> Cumulate(); }
 
+    virtual void StartCumulate () const 
+    { vec -> StartCumulate(); }
+
+    virtual void FinishCumulate () const 
+    { vec -> FinishCumulate(); }
+
     virtual void Distribute() const
     { vec -> Distribute(); }
 
@@ -1018,6 +1028,26 @@ namespace ngla
     return v.L2Norm();
   }
 
+
+  /*
+    Fused vector kernels, one sweep over the vectors instead of one per
+    operation. Parallel vectors use the single operations.
+  */
+
+  /// y1 += s1 x1, y2 += s2 x2
+  NGS_DLL_HEADER void FusedAdd (double s1, const BaseVector & x1, BaseVector & y1,
+                                double s2, const BaseVector & x2, BaseVector & y2);
+  NGS_DLL_HEADER void FusedAdd (Complex s1, const BaseVector & x1, BaseVector & y1,
+                                Complex s2, const BaseVector & x2, BaseVector & y2);
+
+  /// y = s y + x
+  NGS_DLL_HEADER void ScaleAdd (double s, BaseVector & y, const BaseVector & x);
+  NGS_DLL_HEADER void ScaleAdd (Complex s, BaseVector & y, const BaseVector & x);
+
+  /// y += s x, returns (y, z) for real vectors
+  NGS_DLL_HEADER double AddInnerProduct (double s, const BaseVector & x, BaseVector & y,
+                                         const BaseVector & z);
+
 }
 
 #endif
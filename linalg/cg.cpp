@@ -513,6 +513,20 @@ namespace ngla
   }
 
 
+  // d += s w, returns (d, d)
+  template <class IPTYPE, class SCAL>
+  inline SCAL CG_AddInnerProduct (SCAL s, const BaseVector & w, BaseVector & d)
+  {
+    d.Add (s, w);
+    return S_InnerProduct<IPTYPE> (d, d);
+  }
+
+  template <>
+  inline double CG_AddInnerProduct<double> (double s, const BaseVector & w, BaseVector & d)
+  {
+    return AddInnerProduct (s, w, d, d);
+  }
+
   template <class IPTYPE>
   void CGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
   {
@@ -611,19 +625,21 @@ namespace ngla
 	    if (kss == 0.0) break;
 	    
 	    al = wd / kss;
-	    u += al * s;
-	    d -= al * w;
 
 	    if (c)
-	      w = (*c) * d;
+	      {
+		FusedAdd (al, s, u, -al, w, d);
+		w = (*c) * d;
+		wdn = S_InnerProduct<IPTYPE> (d, w);
+	      }
 	    else
-	      w = d;
-	    wdn = S_InnerProduct<IPTYPE> (d, w);
+	      {
+		u += al * s;
+		wdn = CG_AddInnerProduct<IPTYPE> (-al, w, d);
+	      }
 
 	    be = wdn / wd;
-	    
-	    s *= be;
-	    s += w;
+	    ScaleAdd (be, s, c ? w : d);
 
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (wdn)) << endl;
 	    if ( sh )
@@ -1315,10 +1331,615 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   
  
   
+  // local contribution to the inner product
+  template <class IPTYPE, class SCAL>
+  INLINE SCAL LocalInnerProduct (SCAL a, SCAL b) { return a * b; }
+
+  template <>
+  INLINE Complex LocalInnerProduct<ComplexConjugate> (Complex a, Complex b)
+  { return a * conj(b); }
+
+  template <>
+  INLINE Complex LocalInnerProduct<ComplexConjugate2> (Complex a, Complex b)
+  { return conj(a) * b; }
+
+
+  template <class IPTYPE>
+  void PipelinedCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("Pipelined CG solver");
+    static Timer timer_sweep ("Pipelined CG solver - vector sweep");
+    RegionTimer reg (timer);
+
+    try
+      {
+        // Solve A x = f
+        if (sh)
+          sh->SetThreadPercentage(0);
+
+        auto r = f.CreateVector();
+        auto u = f.CreateVector();
+        auto w = f.CreateVector();
+        auto m = f.CreateVector();
+        auto nv = f.CreateVector();
+        auto z = f.CreateVector();
+        auto q = f.CreateVector();
+        auto s = f.CreateVector();
+        auto p = f.CreateVector();
+
+        if (initialize)
+          {
+            x = 0.0;
+            r = f;
+          }
+        else
+          r = f - (*a) * x;
+
+        if (c)
+          u = (*c) * r;
+        else
+          {
+            u = r;
+            u.Cumulate();
+          }
+        w = (*a) * u;
+        z = 0.0; q = 0.0; s = 0.0; p = 0.0;
+
+        // parallel vectors: r, w, s, z distributed, x, u, p, q, m cumulated 
+        auto consistent = [&] ()
+          {
+            for (BaseVector * v : { &r, &w, &s, &z, &nv })
+              v->Distribute();
+            for (BaseVector * v : initializer_list<BaseVector*> { &x, &u, &p, &q, &m })
+              v->Cumulate();
+          };
+
+        // z = n + beta z, q = m + beta q, s = w + beta s, p = u + beta p,
+        // x += alpha p, r -= alpha s, u -= alpha q, w -= alpha z,
+        // and the local parts of (r,u) and (u,w), in one sweep
+        SCAL locdots[2];
+        auto sweep = [&] (bool update, SCAL alpha, SCAL beta)
+          {
+            RegionTimer reg (timer_sweep);
+            timer_sweep.AddFlops ((update ? 18 : 4) * r.FV<SCAL>().Size());
+
+            FlatVector<SCAL> fx = x.FV<SCAL>(), fr = r.FV<SCAL>(), fu = u.FV<SCAL>(),
+              fw = w.FV<SCAL>(), fm = m.FV<SCAL>(), fn = nv.FV<SCAL>(), fz = z.FV<SCAL>(),
+              fq = q.FV<SCAL>(), fs = s.FV<SCAL>(), fp = p.FV<SCAL>();
+
+            SCAL parts[2][16];
+            ParallelJob ([&] (TaskInfo ti)
+                         {
+                           auto range = ::Range(fr).Split (ti.task_nr, ti.ntasks);
+                           SCAL gamma = 0.0, delta = 0.0;
+                           if (update)
+                             for (size_t i : range)
+                               {
+                                 SCAL zi = fn(i) + beta * fz(i);
+                                 SCAL qi = fm(i) + beta * fq(i);
+                                 SCAL si = fw(i) + beta * fs(i);
+                                 SCAL pi = fu(i) + beta * fp(i);
+                                 SCAL ri = fr(i) - alpha * si;
+                                 SCAL ui = fu(i) - alpha * qi;
+                                 SCAL wi = fw(i) - alpha * zi;
+                                 fz(i) = zi; fq(i) = qi; fs(i) = si; fp(i) = pi;
+                                 fx(i) += alpha * pi;
+                                 fr(i) = ri; fu(i) = ui; fw(i) = wi;
+                                 gamma += LocalInnerProduct<IPTYPE> (ri, ui);
+                                 delta += LocalInnerProduct<IPTYPE> (ui, wi);
+                               }
+                           else
+                             for (size_t i : range)
+                               {
+                                 gamma += LocalInnerProduct<IPTYPE> (fr(i), fu(i));
+                                 delta += LocalInnerProduct<IPTYPE> (fu(i), fw(i));
+                               }
+                           parts[0][ti.task_nr] = gamma;
+                           parts[1][ti.task_nr] = delta;
+                         }, 16);
+
+            locdots[0] = locdots[1] = 0.0;
+            for (int k = 0; k < 16; k++)
+              {
+                locdots[0] += parts[0][k];
+                locdots[1] += parts[1][k];
+              }
+          };
+
+        // the global reduction of the local dots runs during apply ()
+        SCAL dots[2];
+        auto reduce_overlapped = [&] (const function<void()> & apply)
+          {
+#ifdef PARALLEL
+            if (r.GetParallelStatus() != NOT_PARALLEL)
+              {
+                MPI_Request request;
+                MPI_Iallreduce (locdots, dots, 2*sizeof(SCAL)/sizeof(double), MPI_DOUBLE, MPI_SUM,
+                                ngs_comm, &request);
+                apply();
+                MPI_Wait (&request, MPI_STATUS_IGNORE);
+                return;
+              }
+#endif
+            apply();
+            dots[0] = locdots[0];
+            dots[1] = locdots[1];
+          };
+        
+        auto apply = [&] ()
+          {
+            if (c)
+              m = (*c) * w;
+            else
+              {
+                m = w;
+                m.Cumulate();
+              }
+            nv = (*a) * m;
+          };
+
+        consistent();
+        sweep (false, 0.0, 0.0);
+        reduce_overlapped (apply);
+        SCAL gamma = dots[0], delta = dots[1];
+
+        if (printrates) cout << IM(1) << "0 " << sqrt(Abs(gamma)) << endl;
+        double err = prec * prec * (stop_absolute ? 1 : Abs(gamma));
+        double lwstart = log(Abs(gamma));
+        double lerr = log(err);
+
+        SCAL alpha = 0.0, gamma_old = 1.0;
+        int n = 0;
+        while (n < maxsteps && Abs(gamma) > err && !(sh && sh->ShouldTerminate()))
+          {
+            SCAL beta = (n == 0) ? SCAL(0.0) : gamma / gamma_old;
+            SCAL denom = (n == 0) ? delta : delta - beta * gamma / alpha;
+            if (denom == 0.0) break;
+            alpha = gamma / denom;
+            gamma_old = gamma;
+            n++;
+
+            consistent();
+            sweep (true, alpha, beta);
+            reduce_overlapped (apply);
+            gamma = dots[0];
+            delta = dots[1];
+
+            if (printrates) cout << IM(1) << n << " " << sqrt (Abs (gamma)) << endl;
+            if (sh)
+              sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+                                                (lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+          }
+
+        const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+        e.Append ("in caught in PipelinedCGSolver::Mult\n");
+        throw;
+      }
+    catch (exception & e)
+      {
+        throw Exception(e.what() +
+                        string ("\ncaught in PipelinedCGSolver::Mult\n"));
+      }
+  }
+
+  
+  void IterativeRefinementSolver :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    static Timer t("IterativeRefinementSolver::Mult"); RegionTimer reg(t);
+    try
+      {
+        // Solve A u = f
+        auto d = f.CreateVector();
+        auto w = f.CreateVector();
+
+        if (initialize)
+          {
+            u = 0.0;
+            d = f;
+          }
+        else
+          d = f - (*a) * u;
+
+        double err0 = stop_absolute ? 1 : L2Norm (f);
+        double err = L2Norm (d);
+        if (printrates) cout << IM(1) << "0 " << err << endl;
+
+        int n = 0;
+        while (n < maxsteps && err > prec * err0)
+          {
+            w = (*c) * d;
+            u += w;
+            d = f - (*a) * u;
+            err = L2Norm (d);
+            n++;
+            if (printrates) cout << IM(1) << n << " " << err << endl;
+          }
+
+        const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+        e.Append ("in caught in IterativeRefinementSolver::Mult\n");
+        throw;
+      }
+  }
+
+
+
+  void BlockKrylovSolver :: ApplyPrecond (const MultiVector & x, MultiVector & y) const
+  {
+    if (c)
+      {
+        y = 0.0;
+        c->MultAdd (1.0, x, y);
+      }
+    else
+      y = x;
+  }
+
+
+  // dst[j] = src[cols[j]]
+  static void CopyColumns (const MultiVector & src, FlatArray<int> cols, MultiVector & dst)
+  {
+    auto s = src.Data();
+    auto d = dst.Data();
+    ParallelForRange (src.Size(), [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          for (size_t j = 0; j < cols.Size(); j++)
+                            d(i,j) = s(i,cols[j]);
+                      });
+  }
+
+  // dst[cols[j]] = src[j]
+  static void CopyColumnsBack (const MultiVector & src, FlatArray<int> cols, MultiVector & dst)
+  {
+    auto s = src.Data();
+    auto d = dst.Data();
+    ParallelForRange (src.Size(), [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          for (size_t j = 0; j < cols.Size(); j++)
+                            d(i,cols[j]) = s(i,j);
+                      });
+  }
+
+
+  // CalcInverse does not detect all singular matrices
+  static void CheckBreakdown (FlatMatrix<double> m)
+  {
+    for (size_t i = 0; i < m.Height(); i++)
+      for (size_t j = 0; j < m.Width(); j++)
+        if (!std::isfinite (m(i,j)))
+          throw Exception ("BlockCGSolver: singular block");
+  }
+
+
+  void BlockCGSolver :: Solve (const MultiVector & f, MultiVector & u)
+  {
+    static Timer t("BlockCGSolver::Solve"); RegionTimer reg(t);
+
+    size_t n = f.Size(), k = f.NVecs();
+    if (initialize) u = 0.0;
+
+    Array<int> active(k);
+    for (size_t j = 0; j < k; j++) active[j] = j;
+    Vector<double> tol(k);
+    bool first = true;
+    // after a breakdown (e.g. linearly dependent right hand sides) 
+    // the vectors are iterated in smaller blocks
+    size_t maxblock = k;
+    steps = 0;
+
+    while (active.Size())
+      {
+        Array<int> block;
+        for (size_t j = 0; j < min2(maxblock, active.Size()); j++)
+          block.Append (active[j]);
+        size_t kb = block.Size();
+
+        MultiVector x(n, kb), r(n, kb), z(n, kb), p(n, kb), q(n, kb);
+        CopyColumns (u, block, x);
+        CopyColumns (f, block, r);
+        a.MultAdd (-1.0, x, r);
+        ApplyPrecond (r, z);
+        p = z;
+        Matrix<double> rho = z.InnerProduct (r);
+
+        if (first)
+          {
+            for (size_t j = 0; j < k; j++)
+              tol(j) = sqr (prec) * (stop_absolute ? 1 : fabs (rho(j,j)));
+            if (printrates) cout << IM(1) << "0 " << sqrt (fabs (rho(0,0))) << endl;
+            first = false;
+          }
+
+        // remove converged vectors
+        Array<int> conv;
+        for (size_t j = 0; j < kb; j++)
+          if (fabs (rho(j,j)) <= tol(block[j]))
+            conv.Append (block[j]);
+        if (conv.Size())
+          {
+            Array<int> remaining;
+            for (int j : active)
+              if (!conv.Contains (j))
+                remaining.Append (j);
+            active = remaining;
+            continue;
+          }
+        if (steps >= maxsteps) break;
+
+        try
+          {
+            bool restart = false;
+            while (!restart && steps < maxsteps)
+              {
+                steps++;
+                q = 0.0;
+                a.MultAdd (1.0, p, q);
+
+                Matrix<double> ptq = p.InnerProduct (q);
+                CalcInverse (ptq);
+                Matrix<double> alpha = ptq * rho;
+                CheckBreakdown (alpha);
+                x.Add (p, alpha);
+                alpha *= -1.0;
+                r.Add (q, alpha);
+
+                ApplyPrecond (r, z);
+                Matrix<double> rhonew = z.InnerProduct (r);
+
+                double maxerr = 0;
+                for (size_t j = 0; j < kb; j++)
+                  {
+                    maxerr = max2 (maxerr, sqrt (fabs (rhonew(j,j))));
+                    if (fabs (rhonew(j,j)) <= tol(block[j]))
+                      restart = true;
+                  }
+                if (printrates) cout << IM(1) << steps << " " << maxerr << endl;
+                if (restart) break;
+
+                Matrix<double> rhoinv = Trans (rho);
+                CalcInverse (rhoinv);
+                Matrix<double> beta = rhoinv * Trans (rhonew);
+                CheckBreakdown (beta);
+                p.ScaleAdd (beta, z);
+                rho = rhonew;
+              }
+          }
+        catch (Exception & e)
+          {
+            // singular block, x is still a valid approximation
+            if (kb == 1) 
+              {
+                CopyColumnsBack (x, block, u);
+                break;
+              }
+            maxblock = max2 (size_t(1), kb/2);
+          }
+
+        CopyColumnsBack (x, block, u);
+      }
+  }
+
+
+
+  /*
+    orthogonalizes w against the basis blocks, and within w. 
+    The coefficients are written to coefs, such that
+    w = sum_i V_i coefs.Rows(V_i) + w_new coefs.Rows(w_new).
+    Returns the orthonormal w_new, linearly dependent columns are dropped.
+   */
+  static shared_ptr<MultiVector> BlockOrthogonalize (FlatArray<shared_ptr<MultiVector>> basis,
+                                                     MultiVector & w, SliceMatrix<double> coefs)
+  {
+    static Timer t("BlockGMRES - orthogonalize"); RegionTimer reg(t);
+    size_t m = w.NVecs();
+    Vector<double> norm0 = w.Norms();
+
+    // block Gram-Schmidt, twice is enough
+    size_t row = 0;
+    for (auto & v : basis)
+      {
+        auto rows = coefs.Rows(row, row+v->NVecs());
+        rows = 0.0;
+        for (int rep = 0; rep < 2; rep++)
+          {
+            Matrix<double> hc = v->InnerProduct (w);
+            rows += hc;
+            hc *= -1.0;
+            w.Add (*v, hc);
+          }
+        row += v->NVecs();
+      }
+
+    // modified Gram-Schmidt within the new block
+    auto wd = w.Data();
+    Array<int> kept;
+    Matrix<double> rw(m, m);
+    rw = 0.0;
+    for (size_t j = 0; j < m; j++)
+      {
+        for (int rep = 0; rep < 2; rep++)
+          for (size_t l = 0; l < kept.Size(); l++)
+            {
+              double hc = InnerProduct (wd.Col(kept[l]), wd.Col(j));
+              rw(l,j) += hc;
+              wd.Col(j) -= hc * wd.Col(kept[l]);
+            }
+        double norm = L2Norm (wd.Col(j));
+        if (norm > 1e-10 * norm0(j))
+          {
+            wd.Col(j) *= 1.0/norm;
+            rw(kept.Size(), j) = norm;
+            kept.Append (j);
+          }
+      }
+
+    if (kept.Size() == 0) return nullptr;
+    coefs.Rows(row, row+kept.Size()) = rw.Rows(0, kept.Size());
+    auto wnew = make_shared<MultiVector> (w.Size(), kept.Size());
+    CopyColumns (w, kept, *wnew);
+    return wnew;
+  }
+
+
+  void BlockGMRESSolver :: Solve (const MultiVector & f, MultiVector & u)
+  {
+    static Timer t("BlockGMRESSolver::Solve"); RegionTimer reg(t);
+
+    size_t n = f.Size(), k = f.NVecs();
+    if (initialize) u = 0.0;
+
+    MultiVector r(n, k);
+    r = f;
+    a.MultAdd (-1.0, u, r);
+
+    Vector<double> tol = r.Norms();
+    if (stop_absolute)
+      tol = prec;
+    else
+      tol *= prec;
+    if (printrates) cout << IM(1) << "0 " << MaxNorm (r.Norms()) << endl;
+
+    size_t maxcols = restart * k;
+    steps = 0;
+
+    while (steps < maxsteps)
+      {
+        Vector<double> rnorms = r.Norms();
+        bool conv = true;
+        for (size_t j = 0; j < k; j++)
+          if (rnorms(j) > tol(j)) conv = false;
+        if (conv) break;
+
+        // Arnoldi relation A M V = V H, H is reduced to R by Householder reflections,
+        // which are also applied to the right hand sides g
+        Array<shared_ptr<MultiVector>> basis;
+        Matrix<double> h(maxcols+k, maxcols), g(maxcols+k, k);
+        Matrix<double> house(maxcols, maxcols+k);
+        Vector<double> hbeta(maxcols);
+        h = 0.0;
+        g = 0.0;
+
+        MultiVector v0(n, k);
+        v0 = r;
+        auto vnew = BlockOrthogonalize (basis, v0, g);
+        basis.Append (vnew);
+        size_t nb = vnew->NVecs();     // number of basis vectors
+        size_t nc = 0;                 // number of columns of h
+        size_t blocknr = 0;
+
+        while (blocknr < basis.Size() && nc + basis[blocknr]->NVecs() <= maxcols && steps < maxsteps)
+          {
+            steps++;
+            auto & vj = *basis[blocknr++];
+            size_t kj = vj.NVecs();
+
+            MultiVector mv(n, kj), w(n, kj);
+            ApplyPrecond (vj, mv);
+            w = 0.0;
+            a.MultAdd (1.0, mv, w);
+
+            vnew = BlockOrthogonalize (basis, w, h.Cols(nc, nc+kj));
+            if (vnew)
+              {
+                basis.Append (vnew);
+                nb += vnew->NVecs();
+              }
+
+            for (size_t l = 0; l < kj; l++, nc++)
+              {
+                auto col = h.Col(nc);
+                for (size_t i = 0; i < nc; i++)
+                  {
+                    auto v = house.Row(i).Range(i, nb);
+                    double hs = hbeta(i) * InnerProduct (v, col.Range(i, nb));
+                    col.Range(i, nb) -= hs * v;
+                  }
+
+                auto x = col.Range(nc, nb);
+                auto v = house.Row(nc).Range(nc, nb);
+                house.Row(nc) = 0.0;
+                hbeta(nc) = 0.0;
+                if (x.Size() == 0) continue;
+                double xnorm = L2Norm (x);
+                if (xnorm == 0) continue;
+                double alpha = (x(0) > 0) ? -xnorm : xnorm;
+                v = x;
+                v(0) -= alpha;
+                hbeta(nc) = 2.0 / L2Norm2 (v);
+                x = 0.0;
+                x(0) = alpha;
+                for (size_t j = 0; j < k; j++)
+                  {
+                    auto gj = g.Col(j).Range(nc, nb);
+                    double hs = hbeta(nc) * InnerProduct (v, gj);
+                    gj -= hs * v;
+                  }
+              }
+
+            conv = true;
+            double maxerr = 0;
+            for (size_t j = 0; j < k; j++)
+              {
+                double err = L2Norm (g.Col(j).Range(nc, nb));
+                maxerr = max2 (maxerr, err);
+                if (err > tol(j)) conv = false;
+              }
+            if (printrates) cout << IM(1) << steps << " " << maxerr << endl;
+            if (conv) break;
+          }
+
+        if (nc == 0) break;
+
+        // R y = g
+        Matrix<double> y(nc, k);
+        for (size_t j = 0; j < k; j++)
+          for (int i = nc-1; i >= 0; i--)
+            {
+              double sum = g(i,j);
+              for (size_t l = i+1; l < nc; l++)
+                sum -= h(i,l) * y(l,j);
+              y(i,j) = (h(i,i) != 0) ? sum / h(i,i) : 0;
+            }
+
+        // u += M V y
+        MultiVector z(n, k);
+        z = 0.0;
+        size_t row = 0;
+        for (size_t b = 0; b < blocknr; b++)
+          {
+            size_t kb = basis[b]->NVecs();
+            z.Add (*basis[b], y.Rows(row, row+kb));
+            row += kb;
+          }
+        if (c)
+          c->MultAdd (1.0, z, u);
+        else
+          u.Add (1.0, z);
+
+        r = f;
+        a.MultAdd (-1.0, u, r);
+      }
+  }
+
+
+
   template class CGSolver<double>;
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
   template class CGSolver<ComplexConjugate2>;
+  template class PipelinedCGSolver<double>;
+  template class PipelinedCGSolver<Complex>;
+  template class PipelinedCGSolver<ComplexConjugate>;
+  template class PipelinedCGSolver<ComplexConjugate2>;
   template class BiCGStabSolver<double>;
   template class BiCGStabSolver<Complex>;
   template class BiCGStabSolver<ComplexConjugate>;
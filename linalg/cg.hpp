@@ -125,6 +125,31 @@ namespace ngla
   };
 
 
+  /**
+     Pipelined preconditioned CG (Ghysels, Vanroose).
+     
+     All vector updates and both inner products of one iteration are
+     done in a single sweep. The global reduction of the inner products
+     (one per iteration) is overlapped with the preconditioner and
+     the matrix-vector product. Needs 5 more vectors than CG, and one
+     more preconditioner and matrix application.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER PipelinedCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    PipelinedCGSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    PipelinedCGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
   /// The BiCGStab solver
   template <class IPTYPE>
   class NGS_DLL_HEADER BiCGStabSolver : public KrylovSpaceSolver
@@ -176,6 +201,24 @@ namespace ngla
 
 
 
+  /**
+     Iterative refinement (defect correction)
+     u += c (f - a u), with the residual computed by the matrix a.
+     c is typically a solver working with a low precision
+     matrix (e.g. SparseMatrixMixed), a provides full double accuracy.
+  */
+  class NGS_DLL_HEADER IterativeRefinementSolver : public KrylovSpaceSolver
+  {
+  public:
+    ///
+    IterativeRefinementSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { SetMaxSteps (20); }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+
   /// The conjugate gradient solver
   template <class IPTYPE>
   class NGS_DLL_HEADER GMRESSolver : public KrylovSpaceSolver
@@ -228,6 +271,75 @@ namespace ngla
 
 
 
+  /**
+     Block Krylov space solvers for many right hand sides.
+     Matrix and preconditioner are applied to all vectors at once
+     (see MultiVector), the Krylov spaces of all right hand sides
+     are shared.
+  */
+  class NGS_DLL_HEADER BlockKrylovSolver
+  {
+  protected:
+    const BaseMatrix & a;
+    const BaseMatrix * c;
+    double prec = 1e-8;
+    int maxsteps = 200;
+    int steps = 0;
+    bool initialize = true;
+    bool stop_absolute = false;
+    bool printrates = false;
+
+  public:
+    BlockKrylovSolver (const BaseMatrix & aa, const BaseMatrix * ac = nullptr)
+      : a(aa), c(ac) { ; }
+    virtual ~BlockKrylovSolver () { ; }
+
+    void SetPrecision (double aprec) { prec = aprec; stop_absolute = false; }
+    void SetAbsolutePrecision (double aprec) { prec = aprec; stop_absolute = true; }
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
+    void SetInitialize (bool ai) { initialize = ai; }
+    void SetPrintRates (bool pr = true) { printrates = pr; }
+    int GetSteps () const { return steps; }
+
+    /// solve A u[i] = f[i] for all i
+    virtual void Solve (const MultiVector & f, MultiVector & u) = 0;
+
+  protected:
+    /// y = C x, or y = x without preconditioner
+    void ApplyPrecond (const MultiVector & x, MultiVector & y) const;
+  };
+
+
+  /**
+     Block CG (O'Leary) for symmetric positive definite matrices.
+     When one of the vectors has converged, the iteration restarts with
+     the remaining ones.
+  */
+  class NGS_DLL_HEADER BlockCGSolver : public BlockKrylovSolver
+  {
+  public:
+    BlockCGSolver (const BaseMatrix & aa, const BaseMatrix * ac = nullptr)
+      : BlockKrylovSolver (aa, ac) { ; }
+    virtual void Solve (const MultiVector & f, MultiVector & u) override;
+  };
+
+
+  /**
+     Block GMRES with right preconditioning, restarted after 
+     'restart' blocks. Linearly dependent Krylov vectors are dropped.
+  */
+  class NGS_DLL_HEADER BlockGMRESSolver : public BlockKrylovSolver
+  {
+    int restart;
+  public:
+    BlockGMRESSolver (const BaseMatrix & aa, const BaseMatrix * ac = nullptr, int arestart = 20)
+      : BlockKrylovSolver (aa, ac), restart(arestart) { ; }
+    virtual void Solve (const MultiVector & f, MultiVector & u) override;
+  };
+  
+
+
+
   /*
 
   // Conjugate residual solver for symmetric, indefinite matrices
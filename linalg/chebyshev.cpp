@@ -85,4 +85,98 @@ namespace ngla
   }
 
 
+
+  double EstimateMaxEigenvalue (const BaseMatrix & a, const BaseMatrix & c, int steps)
+  {
+    static Timer t("EstimateMaxEigenvalue"); RegionTimer reg(t);
+
+    // Lanczos in the c^{-1} inner product, p = c^{-1} q is carried along
+    auto p = a.CreateColVector();
+    auto pold = a.CreateColVector();
+    auto q = a.CreateColVector();
+    auto y = a.CreateColVector();
+
+    p.SetRandom();
+    q = c * p;
+    double nrm = sqrt (fabs (InnerProduct (p, q)));
+    if (nrm == 0) return 0;
+    p *= 1/nrm;
+    q *= 1/nrm;
+    pold = 0;
+
+    Array<double> alpha, beta;
+    for (int j = 0; j < steps; j++)
+      {
+        y = a * q;
+        double al = InnerProduct (y, q);
+        alpha.Append (al);
+
+        y -= al * p;
+        if (j > 0) y -= beta.Last() * pold;
+        pold = p;
+        q = c * y;
+        double be = sqrt (fabs (InnerProduct (y, q)));
+        if (be <= 1e-12 * fabs(al)) break;   // invariant subspace found
+        beta.Append (be);
+        p = (1/be) * y;
+        q *= 1/be;
+      }
+
+    int n = alpha.Size();
+    Matrix<double> tri(n, n), evecs(n, n);
+    Vector<double> lami(n);
+    tri = 0.0;
+    for (int i = 0; i < n; i++)
+      tri(i,i) = alpha[i];
+    for (int i = 0; i+1 < n; i++)
+      tri(i,i+1) = tri(i+1,i) = beta[i];
+    FlatVector<double> flami = lami;
+    FlatMatrix<double> fevecs = evecs;
+    CalcEigenSystem (tri, flami, fevecs);
+
+    double lmax = 0;
+    for (int i = 0; i < n; i++)
+      lmax = max2 (lmax, lami(i));
+    return lmax;
+  }
+
+
+  void ChebyshevSmooth (const BaseMatrix & a, const BaseMatrix & dinv,
+                        double lmax, double ratio, int degree,
+                        BaseVector & u, const BaseVector & f, int steps)
+  {
+    static Timer t("ChebyshevSmooth"); RegionTimer reg(t);
+    if (lmax == 0) return;
+
+    double lmin = lmax / ratio;
+    double theta = (lmax+lmin) / 2;
+    double delta = (lmax-lmin) / 2;
+    double sigma = theta / delta;
+
+    auto r = a.CreateColVector();
+    auto d = a.CreateColVector();
+    auto w = a.CreateColVector();
+
+    // three-term recurrence of the Chebyshev polynomials
+    for (int i = 0; i < steps; i++)
+      {
+        r = f - a * u;
+        d = dinv * r;
+        d *= 1/theta;
+        double rhoold = 1/sigma;
+        for (int k = 1; k <= degree; k++)
+          {
+            u += d;
+            if (k == degree) break;
+            a.MultAdd (-1, d, r);
+            double rho = 1 / (2*sigma - rhoold);
+            w = dinv * r;
+            d *= rho*rhoold;
+            d += (2*rho/delta) * w;
+            rhoold = rho;
+          }
+      }
+  }
+
+
 }
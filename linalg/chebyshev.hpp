@@ -35,6 +35,25 @@ namespace ngla
     virtual AutoVector CreateVector () const;
   };
 
+
+  /**
+     Estimates the largest eigenvalue of c a by a few Lanczos steps.
+     a is symmetric, c is symmetric positive (semi-)definite.
+     The Ritz value is a lower bound.
+  */
+  extern NGS_DLL_HEADER double EstimateMaxEigenvalue (const BaseMatrix & a, const BaseMatrix & c,
+                                                      int steps = 10);
+
+  /**
+     Smoothing steps u += q(dinv a) dinv (f - a u), the error is multiplied
+     by the Chebyshev polynomial of degree in dinv a damping the eigenvalues
+     in [lmax/ratio, lmax] (Saad, Alg. 12.1).
+  */
+  extern NGS_DLL_HEADER void ChebyshevSmooth (const BaseMatrix & a, const BaseMatrix & dinv,
+                                              double lmax, double ratio, int degree,
+                                              BaseVector & u, const BaseVector & f,
+                                              int steps = 1);
+
 }
 
 #endif
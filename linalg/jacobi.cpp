@@ -40,6 +40,65 @@ namespace ngla
 		 });
   }
 
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void JacobiPrecond<TM,TV_ROW,TV_COL> :: SetupGS () const
+  {
+    // greedy coloring of the inner rows, 32 colors per sweep
+    static Timer tcol("Jacobiprecond::coloring"); RegionTimer rcol(tcol);
+    Array<int> rowcolor(height);
+    rowcolor = -1;
+    size_t ninner = 0;
+    for (int i = 0; i < height; i++)
+      if (!inner || inner->Test(i)) ninner++;
+
+    Array<unsigned int> mask(height);
+    int maxcolor = -1;
+    int basecol = 0;
+    size_t found = 0;
+    while (found < ninner)
+      {
+        mask = 0;
+        for (int i = 0; i < height; i++)
+          {
+            if (rowcolor[i] >= 0 || (inner && !inner->Test(i))) continue;
+
+            // rows coupling to i (mask), and rows i couples to
+            unsigned check = mask[i];
+            for (int j : mat.GetRowIndices(i))
+              if (rowcolor[j] >= basecol)
+                check |= 1u << (rowcolor[j]-basecol);
+            if (check == UINT_MAX) continue;
+
+            unsigned checkbit = 1;
+            int color = basecol;
+            while (check & checkbit)
+              {
+                color++;
+                checkbit *= 2;
+              }
+            rowcolor[i] = color;
+            maxcolor = max2(maxcolor, color);
+            found++;
+            for (int j : mat.GetRowIndices(i))
+              mask[j] |= checkbit;
+          }
+        basecol += 8*sizeof(unsigned int);
+      }
+
+    TableCreator<int> creator(maxcolor+1);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < height; i++)
+        if (rowcolor[i] >= 0)
+          creator.Add (rowcolor[i], i);
+    coloring = creator.MoveTable();
+
+    color_balance.SetSize (coloring.Size());
+    for (auto c : Range(coloring))
+      color_balance[c].Calc (coloring[c].Size(),
+                             [&] (size_t i) { return 5 + mat.GetRowIndices(coloring[c][i]).Size(); });
+  }
+
   ///
   template <class TM, class TV_ROW, class TV_COL>
   JacobiPrecond<TM,TV_ROW,TV_COL> :: ~JacobiPrecond () 
@@ -91,12 +150,29 @@ namespace ngla
     FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
 
-    for (int i = 0; i < height; i++)
-      if (!this->inner || this->inner->Test(i))
-	{
-	  TV_ROW ax = mat.RowTimesVector (i, fx);
-	  fx(i) += invdiag[i] * (fb(i) - ax);
-	}
+    if (task_manager)
+      {
+        EnsureGS();
+        // rows of one color don't couple
+        for (int c = 0; c < coloring.Size(); c++)
+          ParallelForRange
+            (color_balance[c], [&] (IntRange r)
+             {
+               for (int i : coloring[c].Range(r))
+                 {
+                   TV_ROW ax = mat.RowTimesVector (i, fx);
+                   fx(i) += invdiag[i] * (fb(i) - ax);
+                 }
+             });
+      }
+    else
+
+      for (int i = 0; i < height; i++)
+        if (!this->inner || this->inner->Test(i))
+          {
+            TV_ROW ax = mat.RowTimesVector (i, fx);
+            fx(i) += invdiag[i] * (fb(i) - ax);
+          }
   }
 
 
@@ -112,12 +188,28 @@ namespace ngla
     FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
 
-    for (int i = height-1; i >= 0; i--)
-      if (!this->inner || this->inner->Test(i))
-	{
-	  TV_ROW ax = mat.RowTimesVector (i, fx);
-	  fx(i) += invdiag[i] * (fb(i) - ax);
-	}
+    if (task_manager)
+      {
+        EnsureGS();
+        for (int c = coloring.Size()-1; c >= 0; c--)
+          ParallelForRange
+            (color_balance[c], [&] (IntRange r)
+             {
+               for (int i : coloring[c].Range(r))
+                 {
+                   TV_ROW ax = mat.RowTimesVector (i, fx);
+                   fx(i) += invdiag[i] * (fb(i) - ax);
+                 }
+             });
+      }
+    else
+
+      for (int i = height-1; i >= 0; i--)
+        if (!this->inner || this->inner->Test(i))
+          {
+            TV_ROW ax = mat.RowTimesVector (i, fx);
+            fx(i) += invdiag[i] * (fb(i) - ax);
+          }
   }
 
   ///
@@ -138,8 +230,73 @@ namespace ngla
   JacobiPrecondSymmetric (const SparseMatrixSymmetric<TM,TV> & amat, 
 			  shared_ptr<BitArray> ainner, bool use_par)
     : JacobiPrecond<TM,TV,TV> (amat, ainner, use_par)
-  { 
-    ;
+  { ; }
+
+
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> :: SetupGS () const
+  {
+    JacobiPrecond<TM,TV,TV>::SetupGS();
+
+    // column access for the full rows needed by the colored Gauss-Seidel
+    auto & amat = this->mat;
+    int height = this->height;
+    TableCreator<int> rcreator(height);
+    TableCreator<size_t> pcreator(height);
+    for ( ; !rcreator.Done(); rcreator++, pcreator++)
+      for (int k = 0; k < height; k++)
+        {
+          auto ind = amat.GetRowIndices(k);
+          for (size_t j = 0; j < ind.Size(); j++)
+            if (ind[j] != k)
+              {
+                rcreator.Add (ind[j], k);
+                pcreator.Add (ind[j], amat.First(k)+j);
+              }
+        }
+    trans_row = rcreator.MoveTable();
+    trans_pos = pcreator.MoveTable();
+  }
+
+
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> ::
+  ColoredSweep (FlatVector<TVX> fx, FlatVector<TVX> fb, bool forward) const
+  {
+    this->EnsureGS();
+    const SparseMatrixSymmetric<TM,TV> & smat =
+      dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+    auto & coloring = this->coloring;
+
+    for (int cnt = 0; cnt < coloring.Size(); cnt++)
+      {
+        int c = forward ? cnt : coloring.Size()-1-cnt;
+        ParallelForRange
+          (this->color_balance[c], [&] (IntRange r)
+           {
+             for (int i : coloring[c].Range(r))
+               {
+                 TVX hv = fb(i) - smat.RowTimesVectorNoDiag (i, fx) - UpperRowTimesVector (i, fx);
+                 fx(i) = this->invdiag[i] * hv;
+               }
+           });
+      }
+  }
+
+
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> ::
+  CalcPartialResiduum (FlatVector<TVX> fx, FlatVector<TVX> fb, FlatVector<TVX> fy) const
+  {
+    ParallelFor (this->height, [&] (size_t i)
+                 {
+                   TVX sum = UpperRowTimesVector (i, fx);
+                   auto ind = this->mat.GetRowIndices(i);
+                   size_t n = ind.Size();
+                   if (n && ind[n-1] == int(i))
+                     sum += this->mat.GetRowValues(i)(n-1) * fx(i);
+                   fy(i) = fb(i) - sum;
+                 });
   }
 
   ///
@@ -156,6 +313,17 @@ namespace ngla
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
 
+    if (task_manager)
+      {
+        if (this->inner)
+          ParallelFor (this->height, [&] (size_t i)
+                       {
+                         if (!this->inner->Test(i)) fx(i) = TVX(0);
+                       });
+        ColoredSweep (fx, fb, true);
+        return;
+      }
+
     // x := b - L^t x
     for (int i = 0; i < this->height; i++)
       if (!this->inner || this->inner->Test(i))
@@ -165,6 +333,12 @@ namespace ngla
 	}
       else
 	fx(i) = TVX(0);
+
+    // later inner rows also added to the non-inner entries
+    if (this->inner)
+      for (int i = 0; i < this->height; i++)
+        if (!this->inner->Test(i))
+          fx(i) = TVX(0);
     
     // x := (L+D)^{-1} x
     for (int i = 0; i < this->height; i++)
@@ -190,6 +364,14 @@ namespace ngla
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
 
+    if (task_manager)
+      {
+        FlatVector<TVX> fb = b.FV<TVX> ();
+        ColoredSweep (fx, fb, true);
+        CalcPartialResiduum (fx, fb, fy);
+        return;
+      }
+
     // input, y = b - (D+L^t) x
     // (L+D) x_new := b - L^t x  = y + D x
     // D (x_new-x) = b - L x_new
@@ -227,6 +409,17 @@ namespace ngla
 
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    if (task_manager)
+      {
+        if (this->inner)
+          ParallelFor (this->height, [&] (size_t i)
+                       {
+                         if (!this->inner->Test(i)) fx(i) = TVX(0);
+                       });
+        ColoredSweep (fx, fb, false);
+        return;
+      }
     
     for (int i = this->height-1; i >= 0; i--)
       if (!this->inner || this->inner->Test(i))
@@ -261,6 +454,14 @@ namespace ngla
     FlatVector<TVX> fy = y.FV<TVX>();
     // FlatVector<TVX> fb = b.FV<TVX>();
 
+    if (task_manager)
+      {
+        FlatVector<TVX> fb = b.FV<TVX>();
+        ColoredSweep (fx, fb, false);
+        CalcPartialResiduum (fx, fb, fy);
+        return;
+      }
+
     for (int i = smat.Height()-1; i >=0; i--)
       if (!this->inner || this->inner->Test(i))
 	{
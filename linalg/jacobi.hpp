@@ -36,6 +36,16 @@ namespace ngla
     int height;
     ///
     Array<TM> invdiag;
+    /// multicolor ordering of the inner rows, for the parallel Gauss-Seidel
+    mutable Table<int> coloring;
+    ///
+    mutable Array<Partitioning> color_balance;
+    ///
+    mutable once_flag gs_setup;
+
+    /// colors the rows, called before the first colored sweep
+    virtual void SetupGS () const;
+    void EnsureGS () const { call_once (gs_setup, [this] () { SetupGS(); }); }
   public:
     // typedef typename mat_traits<TM>::TV_ROW TVX;
     typedef typename mat_traits<TM>::TSCAL TSCAL;
@@ -89,6 +99,27 @@ namespace ngla
   {
   public:
     typedef TV TVX;
+  protected:
+    /// the strictly upper part of row i is stored in rows trans_row[i] at positions trans_pos[i]
+    mutable Table<int> trans_row;
+    mutable Table<size_t> trans_pos;
+
+    /// coloring, and column access for the full rows
+    virtual void SetupGS () const;
+
+    TVX UpperRowTimesVector (int i, FlatVector<TVX> fx) const
+    {
+      TVX sum = typename mat_traits<TVX>::TSCAL(0);
+      for (size_t j = 0; j < trans_row[i].Size(); j++)
+        sum += Trans(this->mat[trans_pos[i][j]]) * fx(trans_row[i][j]);
+      return sum;
+    }
+
+    /// Gauss-Seidel sweep over the colors, rows of one color in parallel
+    void ColoredSweep (FlatVector<TVX> fx, FlatVector<TVX> fb, bool forward) const;
+    /// y = b - (D+L^t) x
+    void CalcPartialResiduum (FlatVector<TVX> fx, FlatVector<TVX> fb, FlatVector<TVX> fy) const;
+  public:
 
     ///
     JacobiPrecondSymmetric (const SparseMatrixSymmetric<TM,TV> & amat, 
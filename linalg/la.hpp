@@ -31,8 +31,11 @@ namespace ngla
 #include "paralleldofs.hpp"
 #include "basevector.hpp"
 #include "vvector.hpp"
+#include "multivector.hpp"
 #include "basematrix.hpp"
 #include "sparsematrix.hpp"
+#include "sparsematrix_sell.hpp"
+#include "sparsematrix_mixed.hpp"
 #include "order.hpp"
 #include "sparsecholesky.hpp"
 #include "pardisoinverse.hpp"
@@ -47,6 +50,7 @@ namespace ngla
 #include "elementbyelement.hpp"
 #include "cg.hpp"
 #include "chebyshev.hpp"
+#include "amg.hpp"
 #include "eigen.hpp"
 #include "arnoldi.hpp"
 
@@ -0,0 +1,141 @@
+/**************************************************************************/
+/* File:   multivector.cpp                                                */
+/* Date:   18. Oct. 2026                                                  */
+/**************************************************************************/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  MultiVector :: MultiVector (size_t asize, size_t anvecs)
+    : size(asize), nvecs(anvecs), vecs(asize, anvecs)
+  {
+    vecs = 0.0;
+  }
+
+  void MultiVector :: SetVector (size_t i, const BaseVector & v)
+  {
+    auto fv = v.FVDouble();
+    if (fv.Size() != size)
+      throw Exception ("MultiVector::SetVector: size does not match");
+    ParallelForRange (size, [&] (IntRange r) { vecs.Col(i).Range(r) = fv.Range(r); });
+  }
+
+  void MultiVector :: GetVector (size_t i, BaseVector & v) const
+  {
+    auto fv = v.FVDouble();
+    if (fv.Size() != size)
+      throw Exception ("MultiVector::GetVector: size does not match");
+    ParallelForRange (size, [&] (IntRange r) { fv.Range(r) = vecs.Col(i).Range(r); });
+  }
+
+  MultiVector & MultiVector :: operator= (double val)
+  {
+    ParallelForRange (size, [&] (IntRange r) { vecs.Rows(r) = val; });
+    return *this;
+  }
+
+  MultiVector & MultiVector :: operator= (const MultiVector & v2)
+  {
+    if (v2.size != size || v2.nvecs != nvecs)
+      throw Exception ("MultiVector::operator=: sizes don't match");
+    ParallelForRange (size, [&] (IntRange r) { vecs.Rows(r) = v2.vecs.Rows(r); });
+    return *this;
+  }
+
+  void MultiVector :: Add (const MultiVector & v2, SliceMatrix<double> coefs)
+  {
+    static Timer t("MultiVector::Add"); RegionTimer reg(t);
+    t.AddFlops (size*v2.nvecs*nvecs);
+    ParallelForRange (size, [&] (IntRange r)
+                      {
+                        constexpr size_t bs = 64;
+                        Matrix<double> hv(bs, nvecs);
+                        for (size_t first = r.First(); first < r.Next(); first += bs)
+                          {
+                            size_t next = min2(first+bs, r.Next());
+                            auto h = hv.Rows(0, next-first);
+                            MultMatMat (v2.vecs.Rows(first, next), coefs, h);
+                            vecs.Rows(first, next) += h;
+                          }
+                      });
+  }
+
+  void MultiVector :: ScaleAdd (SliceMatrix<double> coefs, const MultiVector & v2)
+  {
+    static Timer t("MultiVector::ScaleAdd"); RegionTimer reg(t);
+    t.AddFlops (size*nvecs*nvecs);
+    ParallelForRange (size, [&] (IntRange r)
+                      {
+                        constexpr size_t bs = 64;
+                        Matrix<double> hv(bs, nvecs);
+                        for (size_t first = r.First(); first < r.Next(); first += bs)
+                          {
+                            size_t next = min2(first+bs, r.Next());
+                            auto rows = vecs.Rows(first, next);
+                            auto h = hv.Rows(0, next-first);
+                            MultMatMat (rows, coefs, h);
+                            rows = h + v2.vecs.Rows(first, next);
+                          }
+                      });
+  }
+
+  void MultiVector :: Add (double s, const MultiVector & v2)
+  {
+    ParallelForRange (size, [&] (IntRange r) { vecs.Rows(r) += s * v2.vecs.Rows(r); });
+  }
+
+  Matrix<double> MultiVector :: InnerProduct (const MultiVector & v2) const
+  {
+    static Timer t("MultiVector::InnerProduct"); RegionTimer reg(t);
+    t.AddFlops (size*nvecs*v2.nvecs);
+
+    Matrix<double> sum(nvecs, v2.nvecs);
+    sum = 0.0;
+    mutex summutex;
+    ParallelForRange (size, [&] (IntRange r)
+                      {
+                        // rank-1 updates, the inner loop runs over contiguous values
+                        size_t n1 = nvecs, n2 = v2.nvecs;
+                        Matrix<double> part(n1, n2);
+                        part = 0.0;
+                        for (size_t i : r)
+                          {
+                            const double * pa = &vecs(i,0);
+                            const double * pb = &v2.vecs(i,0);
+                            for (size_t j1 = 0; j1 < n1; j1++)
+                              {
+                                double * ps = &part(j1,0);
+                                double aij = pa[j1];
+                                for (size_t j2 = 0; j2 < n2; j2++)
+                                  ps[j2] += aij * pb[j2];
+                              }
+                          }
+                        lock_guard<mutex> guard(summutex);
+                        sum += part;
+                      });
+    return sum;
+  }
+
+  Vector<double> MultiVector :: Norms () const
+  {
+    Vector<double> norms(nvecs);
+    norms = 0.0;
+    mutex summutex;
+    ParallelForRange (size, [&] (IntRange r)
+                      {
+                        Vector<double> part(nvecs);
+                        part = 0.0;
+                        for (size_t i : r)
+                          for (size_t j = 0; j < nvecs; j++)
+                            part(j) += sqr (vecs(i,j));
+                        lock_guard<mutex> guard(summutex);
+                        norms += part;
+                      });
+    for (size_t j = 0; j < nvecs; j++)
+      norms(j) = sqrt (norms(j));
+    return norms;
+  }
+
+}
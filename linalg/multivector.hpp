@@ -0,0 +1,63 @@
+#ifndef FILE_NGS_MULTIVECTOR
+#define FILE_NGS_MULTIVECTOR
+
+/**************************************************************************/
+/* File:   multivector.hpp                                                */
+/* Date:   18. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     A set of k real vectors of the same size.
+
+     The values are stored contiguously as a size x k matrix, the k values
+     of one entry are next to each other. A sparse matrix applied to all
+     vectors at once (SpMM) uses every matrix entry k times.
+
+     Size is the number of doubles of one vector, i.e. Size() * EntrySize()
+     of the corresponding BaseVector. Shared memory only, parallel
+     vectors are not supported.
+  */
+  class NGS_DLL_HEADER MultiVector
+  {
+    size_t size;
+    size_t nvecs;
+    Matrix<double> vecs;
+
+  public:
+    MultiVector (size_t asize, size_t anvecs);
+
+    size_t Size () const { return size; }
+    size_t NVecs () const { return nvecs; }
+
+    /// row i holds entry i of all vectors
+    FlatMatrix<double> Data () const { return vecs; }
+    /// vector i
+    SliceVector<double> operator[] (size_t i) const { return vecs.Col(i); }
+
+    /// copy v into vector i
+    void SetVector (size_t i, const BaseVector & v);
+    /// copy vector i into v
+    void GetVector (size_t i, BaseVector & v) const;
+
+    MultiVector & operator= (double val);
+    MultiVector & operator= (const MultiVector & v2);
+
+    /// this += v2 * coefs, coefs is v2.NVecs() x NVecs()
+    void Add (const MultiVector & v2, SliceMatrix<double> coefs);
+    /// this = this * coefs + v2, coefs is NVecs() x NVecs()
+    void ScaleAdd (SliceMatrix<double> coefs, const MultiVector & v2);
+    /// this += s v2
+    void Add (double s, const MultiVector & v2);
+
+    /// all inner products, result(i,j) = <this[i], v2[j]>
+    Matrix<double> InnerProduct (const MultiVector & v2) const;
+    /// l2-norms of the vectors
+    Vector<double> Norms () const;
+  };
+
+}
+
+#endif
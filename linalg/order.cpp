@@ -557,6 +557,11 @@ namespace ngla
 
 
   void MinimumDegreeOrdering :: Order()
+  {
+    Order (FlatArray<int>());
+  }
+
+  void MinimumDegreeOrdering :: Order (FlatArray<int> given)
   {
     static Timer reorder_timer("MinimumDegreeOrdering::Order");
     RegionTimer reg(reorder_timer);
@@ -573,6 +578,7 @@ namespace ngla
 
     int minj = -1;
     int lastel = -1;
+    size_t gi = 0;
 
     if (n > 5000)
       cout << IM(4) << "order " << flush;
@@ -611,14 +617,24 @@ namespace ngla
 	else
 	  {
 	    // find new master vertex
-	    do
-	      {
-		minj = priqueue.MinDegree();
-		priqueue.Invalidate(minj); 
-		if (vertices[minj].Master() != minj)
-		  priqueue.SetDegree (minj, n);
-	      }
-	    while (vertices[minj].Master() != minj);
+            if (given.Size())
+              {
+                // slaves follow their master
+                while (vertices[given[gi]].Eliminated() ||
+                       vertices[given[gi]].Master() != given[gi])
+                  gi++;
+                minj = given[gi];
+                priqueue.Invalidate(minj);
+              }
+            else
+              do
+                {
+                  minj = priqueue.MinDegree();
+                  priqueue.Invalidate(minj); 
+                  if (vertices[minj].Master() != minj)
+                    priqueue.SetDegree (minj, n);
+                }
+              while (vertices[minj].Master() != minj);
 
 	    blocknr[i] = i;
 	    EliminateMasterVertex (minj);
@@ -777,4 +793,162 @@ namespace ngla
     list[nr].degree = 0;
   }
 
+
+
+
+  /*
+    Nested dissection:
+    A subgraph occupies the range [first, next) of the ordering. It is
+    split by a level set of a breadth first search starting from a
+    pseudo-peripheral vertex. The two parts are moved to the front of
+    the range, the separator to the end. All subgraphs of one level of
+    the dissection tree are split in parallel.
+  */
+  Array<int> NestedDissection (const Table<int> & graph, FlatArray<int> verts)
+  {
+    static Timer t("NestedDissection"); RegionTimer reg(t);
+
+    constexpr size_t leafsize = 64;
+    size_t nv = verts.Size();
+
+    Array<int> ord(nv);
+    ord = verts;
+
+    // subgraph of vertex, -1 for separators and unused vertices
+    Array<int> part(graph.Size());
+    Array<int> level(graph.Size());
+    part = -1;
+    for (int v : verts)
+      part[v] = 0;
+
+    struct SubGraph { size_t first, next; int id; };
+    Array<SubGraph> current, children;
+    if (nv > leafsize)
+      current.Append ( { 0, nv, 0 } );
+    atomic<int> idcnt(1);
+
+    // tasks read part of neighbours in other subgraphs while those are written
+    auto PartOf = [&] (int v) { return AsAtomic(part[v]).load(memory_order_relaxed); };
+    auto SetPart = [&] (int v, int id) { AsAtomic(part[v]).store(id, memory_order_relaxed); };
+
+    while (current.Size())
+      {
+        children.SetSize (2*current.Size());
+        ParallelFor (current.Size(), [&] (size_t k)
+          {
+            SubGraph sg = current[k];
+            FlatArray<int> sub = ord.Range(sg.first, sg.next);
+            size_t size = sub.Size();
+            children[2*k] = children[2*k+1] = { 0, 0, -1 };
+
+            // breadth first search in subgraph, returns number of levels
+            Array<int> queue(size);
+            auto bfs = [&] (int root)
+              {
+                for (int v : sub) level[v] = -1;
+                queue.SetSize0();
+                queue.Append (root);
+                level[root] = 0;
+                for (size_t qi = 0; qi < queue.Size(); qi++)
+                  for (int w : graph[queue[qi]])
+                    if (PartOf(w) == sg.id && level[w] == -1)
+                      {
+                        level[w] = level[queue[qi]]+1;
+                        queue.Append (w);
+                      }
+                return level[queue.Last()]+1;
+              };
+
+            int nlevels = bfs (sub[0]);
+
+            Array<int> hsub(size);
+            size_t cnt = 0;
+            
+            if (queue.Size() < size)
+              {
+                // not connected: reached component first, then the rest
+                for (int v : queue) hsub[cnt++] = v;
+                size_t nreached = cnt;
+                for (int v : sub)
+                  if (level[v] == -1) hsub[cnt++] = v;
+                sub = hsub;
+                children[2*k] = { sg.first, sg.first+nreached, idcnt++ };
+                children[2*k+1] = { sg.first+nreached, sg.next, idcnt++ };
+              }
+            else
+              {
+                // pseudo-peripheral vertex
+                for (int it = 0; it < 2; it++)
+                  {
+                    int far = queue.Last();
+                    int nl = bfs (far);
+                    if (nl <= nlevels) break;
+                    nlevels = nl;
+                  }
+                if (nlevels < 3) return;    // too compact for a separator
+                
+                Array<size_t> levelsize(nlevels);
+                levelsize = 0;
+                for (int v : sub) levelsize[level[v]]++;
+
+                // smallest level set in the middle third, else the median level
+                int sep = -1;
+                size_t below = 0;
+                for (int l = 0; l < nlevels; l++)
+                  {
+                    if (l > 0 && below >= 0.35*size && below+levelsize[l] <= 0.65*size)
+                      if (sep == -1 || levelsize[l] < levelsize[sep])
+                        sep = l;
+                    below += levelsize[l];
+                  }
+                if (sep == -1)
+                  {
+                    below = 0;
+                    for (sep = 0; sep < nlevels-2; sep++)
+                      {
+                        below += levelsize[sep];
+                        if (2*below >= size) break;
+                      }
+                    sep = max2(sep, 1);
+                  }
+                
+                // separator vertices without neighbour behind the separator join the front part
+                for (int v : sub)
+                  if (level[v] == sep)
+                    {
+                      bool needed = false;
+                      for (int w : graph[v])
+                        if (PartOf(w) == sg.id && level[w] == sep+1)
+                          needed = true;
+                      if (!needed) level[v] = sep-1;
+                    }
+
+                for (int v : sub) if (level[v] < sep) hsub[cnt++] = v;
+                size_t nfront = cnt;
+                for (int v : sub) if (level[v] > sep) hsub[cnt++] = v;
+                size_t nback = cnt-nfront;
+                for (int v : sub) if (level[v] == sep) hsub[cnt++] = v;
+                sub = hsub;
+
+                for (size_t i = nfront+nback; i < size; i++)
+                  SetPart (sub[i], -1);
+                children[2*k] = { sg.first, sg.first+nfront, idcnt++ };
+                children[2*k+1] = { sg.first+nfront, sg.first+nfront+nback, idcnt++ };
+              }
+
+            for (int c = 0; c < 2; c++)
+              {
+                auto & child = children[2*k+c];
+                for (size_t i = child.first; i < child.next; i++)
+                  SetPart (ord[i], child.id);
+              }
+          });
+
+        current.SetSize0();
+        for (auto & child : children)
+          if (child.next-child.first > leafsize)
+            current.Append (child);
+      }
+    return ord;
+  }
 }
@@ -151,6 +151,8 @@ namespace ngla
     void EliminateSlaveVertex (int v);
     ///
     void Order();
+    /// eliminate the master vertices in the given sequence (instead of minimal degree)
+    void Order (FlatArray<int> given);
     /// 
     ~MinimumDegreeOrdering();
 
@@ -198,6 +200,15 @@ namespace ngla
   };
 
 
+
+  /**
+     Nested dissection ordering by level-set separators.
+     graph contains the neighbours of the vertices in verts.
+     Returns verts in elimination order, separators after
+     the subgraphs they separate. Subgraphs are processed in parallel.
+  */
+  extern NGS_DLL_HEADER Array<int> NestedDissection (const Table<int> & graph, FlatArray<int> verts);
+
 }
 
 
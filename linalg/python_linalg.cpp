@@ -75,6 +75,21 @@ void ExportSparseMatrix(py::module m)
     .def("CreateTranspose", [] (const SparseMatrix<double> & sp)
          { return TransposeMatrix (sp); })
 
+    .def("ToSELL", [] (const SparseMatrix<double> & sp, int sigma) -> shared_ptr<BaseMatrix>
+         { return make_shared<SparseMatrixSELL> (sp, sigma); },
+         py::arg("sigma")=256,
+         "copy to SELL-C-sigma format for SIMD-vectorized matrix-vector products")
+    .def("ToMixedPrecision", [] (const SparseMatrix<double> & sp, string storage) -> shared_ptr<BaseMatrix>
+         {
+           if (storage == "float")
+             return make_shared<SparseMatrixMixed<float>> (sp);
+           if (storage == "bf16")
+             return make_shared<SparseMatrixMixed<bfloat16>> (sp);
+           throw Exception ("ToMixedPrecision: unknown storage '" + storage + "', use 'float' or 'bf16'");
+         },
+         py::arg("storage")="float",
+         "copy values to 'float' or 'bf16' storage, products are accumulated in double")
+
     .def("__matmul__", [] (const SparseMatrix<double> & a, const SparseMatrix<double> & b)
          { return MatMult(a,b); })
     .def("__matmul__", [](shared_ptr<SparseMatrix<double>> a, shared_ptr<BaseMatrix> mb)
@@ -534,6 +549,7 @@ freedofs : BitArray
 inverse : string
   Solver to use, allowed values are:
     sparsecholesky - internal solver of NGSolve for symmetric matrices
+    sparsecholesky_nd - internal solver with nested dissection ordering, less fill for 3D problems
     umfpack        - solver by Suitesparse/UMFPACK (if NGSolve was configured with USE_UMFPACK=ON)
     pardiso        - PARDISO, either provided by libpardiso (USE_PARDISO=ON) or Intel MKL (USE_MKL=ON).
                      If neither Pardiso nor Intel MKL was linked at compile-time, NGSolve will look
@@ -591,6 +607,18 @@ inverse : string
   py::class_<S_BaseMatrix<Complex>, shared_ptr<S_BaseMatrix<Complex>>, BaseMatrix>
     (m, "S_BaseMatrixC", "base sparse matrix");
 
+  py::class_<SparseMatrixSELL, shared_ptr<SparseMatrixSELL>, S_BaseMatrix<double>>
+    (m, "SparseMatrixSELL", "sparse matrix in SELL-C-sigma storage")
+    .def_property_readonly("nze_padded", &SparseMatrixSELL::NZEPadded)
+    ;
+
+  py::class_<SparseMatrixMixed<float>, shared_ptr<SparseMatrixMixed<float>>, S_BaseMatrix<double>>
+    (m, "SparseMatrixFloat", "sparse matrix with float values, double accumulation")
+    ;
+  py::class_<SparseMatrixMixed<bfloat16>, shared_ptr<SparseMatrixMixed<bfloat16>>, S_BaseMatrix<double>>
+    (m, "SparseMatrixBF16", "sparse matrix with bfloat16 values, double accumulation")
+    ;
+
 
   py::class_<BlockMatrix, BaseMatrix, shared_ptr<BlockMatrix>> (m, "BlockMatrix")
     .def(py::init<> ([] (vector<vector<shared_ptr<BaseMatrix>>> mats)
@@ -665,6 +693,29 @@ inverse : string
 
   py::class_<SparseCholesky<double>, shared_ptr<SparseCholesky<double>>, SparseFactorization> (m, "SparseCholesky_d");
   py::class_<SparseCholesky<Complex>, shared_ptr<SparseCholesky<Complex>>, SparseFactorization> (m, "SparseCholesky_c");
+
+  py::class_<SparseCholeskyAnalysis, shared_ptr<SparseCholeskyAnalysis>>
+    (m, "SparseCholeskyAnalysis",
+     "symbolic factorization (ordering and structure of the factor), shared by matrices of the same pattern")
+    .def(py::init([] (shared_ptr<BaseSparseMatrix> mat, shared_ptr<BitArray> freedofs, bool nested_dissection)
+                  {
+                    return SparseCholeskyAnalysis::Get (*mat, freedofs, nullptr, nested_dissection);
+                  }),
+         py::arg("mat"), py::arg("freedofs")=nullptr, py::arg("nested_dissection")=false)
+    .def_property_readonly("nze", [] (SparseCholeskyAnalysis & self) { return self.nze; },
+                           "number of non-zero entries of the factor")
+    ;
+
+  m.def("SparseCholesky", [] (shared_ptr<BaseSparseMatrix> mat,
+                              shared_ptr<SparseCholeskyAnalysis> analysis) -> shared_ptr<BaseMatrix>
+        {
+          if (auto dmat = dynamic_pointer_cast<SparseMatrixTM<double>> (mat))
+            return make_shared<SparseCholesky<double>> (*dmat, analysis);
+          if (auto cmat = dynamic_pointer_cast<SparseMatrixTM<Complex>> (mat))
+            return make_shared<SparseCholesky<Complex>> (*cmat, analysis);
+          throw Exception ("SparseCholesky: needs a sparse matrix with double or complex entries");
+        }, py::arg("mat"), py::arg("analysis"), py::call_guard<py::gil_scoped_release>(),
+        "numeric sparse cholesky factorization of mat, using the symbolic factorization analysis");
   
   py::class_<Projector, shared_ptr<Projector>, BaseMatrix> (m, "Projector")
     .def(py::init<shared_ptr<BitArray>,bool>());
@@ -680,12 +731,19 @@ inverse : string
 
   m.def("CGSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
                                           bool iscomplex, bool printrates, 
-                                          double precision, int maxsteps)
+                                          double precision, int maxsteps, bool pipelined)
                                        {
                                          KrylovSpaceSolver * solver;
                                          if(mat.IsComplex()) iscomplex = true;
                                          
-                                         if (iscomplex)
+                                         if (pipelined)
+                                           {
+                                             if (iscomplex)
+                                               solver = new PipelinedCGSolver<Complex> (mat, pre);
+                                             else
+                                               solver = new PipelinedCGSolver<double> (mat, pre);
+                                           }
+                                         else if (iscomplex)
                                            solver = new CGSolver<Complex> (mat, pre);
                                          else
                                            solver = new CGSolver<double> (mat, pre);
@@ -694,8 +752,9 @@ inverse : string
                                          solver->SetPrintRates (printrates);
                                          return shared_ptr<KrylovSpaceSolver>(solver);
                                        },
-          "CG Solver", py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("printrates")=true,
-           py::arg("precision")=1e-8, py::arg("maxsteps")=200
+          "CG Solver, pipelined=True overlaps the inner products with preconditioner and matrix",
+          py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("printrates")=true,
+           py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("pipelined")=false
           )
     ;
 
@@ -718,6 +777,21 @@ inverse : string
           )
     ;
 
+  m.def("IterativeRefinement", [](const BaseMatrix & mat, const BaseMatrix & inner,
+                                  bool printrates, double precision, int maxsteps)
+                                  {
+                                    KrylovSpaceSolver * solver = new IterativeRefinementSolver (mat, inner);
+                                    solver->SetPrecision(precision);
+                                    solver->SetMaxSteps(maxsteps);
+                                    solver->SetPrintRates (printrates);
+                                    return shared_ptr<KrylovSpaceSolver>(solver);
+                                  },
+          "Iterative refinement: defect correction u += inner (f - mat u) with the residual in full precision",
+          py::arg("mat"), py::arg("inner"), py::arg("printrates")=false,
+          py::arg("precision")=1e-12, py::arg("maxsteps")=20
+          )
+    ;
+
   m.def("TestPC", [](const BaseMatrix & mat, const BaseMatrix & pre) {
       EigenSystem eigen(mat, pre);
       eigen.Calc();
@@ -752,6 +826,64 @@ inverse : string
           )
     ;
   
+  py::class_<MultiVector, shared_ptr<MultiVector>> (m, "MultiVector",
+                                                     "k real vectors stored together, for block solvers")
+    .def(py::init<> ([] (shared_ptr<BaseVector> vec, size_t k)
+                     {
+                       return make_shared<MultiVector> (vec->FVDouble().Size(), k);
+                     }),
+         py::arg("vec"), py::arg("k"), "k vectors of the same size as vec")
+    .def_property_readonly("size", &MultiVector::Size)
+    .def_property_readonly("nvecs", &MultiVector::NVecs)
+    .def("SetVector", &MultiVector::SetVector, py::arg("i"), py::arg("vec"), "copy vec into vector i")
+    .def("GetVector", &MultiVector::GetVector, py::arg("i"), py::arg("vec"), "copy vector i into vec")
+    .def("InnerProduct", [] (MultiVector & self, MultiVector & other)
+         {
+           return Matrix<double> (self.InnerProduct(other));
+         })
+    .def("Norms", [] (MultiVector & self)
+         {
+           return Vector<double> (self.Norms());
+         })
+    ;
+
+  py::class_<BlockKrylovSolver, shared_ptr<BlockKrylovSolver>> (m, "BlockKrylovSolver")
+    .def("Solve", &BlockKrylovSolver::Solve, py::arg("f"), py::arg("u"),
+         "solve mat u[i] = f[i] for all vectors", py::call_guard<py::gil_scoped_release>())
+    .def("GetSteps", &BlockKrylovSolver::GetSteps)
+    ;
+
+  m.def("BlockCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                            bool printrates, double precision, int maxsteps)
+        {
+          auto solver = make_shared<BlockCGSolver> (*mat, pre.get());
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return shared_ptr<BlockKrylovSolver>(solver);
+        },
+        "Block CG Solver for many right hand sides, real symmetric positive definite matrices",
+        py::arg("mat"), py::arg("pre")=nullptr, py::arg("printrates")=false,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::keep_alive<0,1>(), py::keep_alive<0,2>()
+        )
+    ;
+
+  m.def("BlockGMRESSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                               bool printrates, double precision, int maxsteps, int restart)
+        {
+          auto solver = make_shared<BlockGMRESSolver> (*mat, pre.get(), restart);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return shared_ptr<BlockKrylovSolver>(solver);
+        },
+        "Block GMRES Solver for many right hand sides, restarted after 'restart' blocks",
+        py::arg("mat"), py::arg("pre")=nullptr, py::arg("printrates")=false,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("restart")=20,
+        py::keep_alive<0,1>(), py::keep_alive<0,2>()
+        )
+    ;
+
   m.def("ArnoldiSolver", [](BaseMatrix & mata, BaseMatrix & matm, shared_ptr<BitArray> freedofs,
                             py::list vecs, py::object bpshift)
         {
@@ -814,6 +946,8 @@ inverse : string
   m.def("DoArchive" , [](shared_ptr<Archive> & arch, BaseMatrix & mat)
                                          { cout << "output basematrix" << endl;
                                            mat.DoArchive(*arch); return arch; });
+  m.def("DoArchive" , [](shared_ptr<Archive> & arch, BaseVector & vec)
+                                         { vec.DoArchive(*arch); return arch; });
                                            
 }
 
@@ -8,6 +8,7 @@
 
 #include <la.hpp>
 
+#include <map>
 #include "concurrentqueue.h" 
 
 
@@ -33,23 +34,26 @@ namespace ngla
 
 
 
-  template <class TM>
-  SparseCholeskyTM<TM> :: 
-  SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
-                    shared_ptr<BitArray> ainner,
-                    shared_ptr<const Array<int>> acluster,
-                    bool allow_refactor)
-    : SparseFactorization (a, ainner, acluster), mat(a)
+  SparseCholeskyAnalysis :: 
+  SparseCholeskyAnalysis (const MatrixGraph & a, 
+                          shared_ptr<BitArray> ainner,
+                          shared_ptr<const Array<int>> acluster,
+                          bool anested_dissection)
   { 
-    static Timer t("SparseCholesky - total");
+    // own copies, the caller may change the sets later
+    if (ainner) inner = make_shared<BitArray> (*ainner);
+    if (acluster) cluster = make_shared<Array<int>> (*acluster);
+    nested_dissection = anested_dissection;
+    graph_firsti = a.GetFirstArray();
+    graph_colnr.SetSize (a.NZE());
+    for (int i = 0; i < a.Size(); i++)
+      graph_colnr.Range(a.First(i), a.First(i+1)) = a.GetRowIndices(i);
+
+    static Timer t("SparseCholesky - analysis");
     static Timer ta("SparseCholesky - allocate");
-    static Timer tf("SparseCholesky - fill factor");
     RegionTimer reg(t);
-    // (*testout) << "matrix = " << a << endl;
-    // (*testout) << "diag a = ";
-    // for ( int i=0; i<a.Height(); i++ ) (*testout) << i << ", " << a(i,i) << endl;
 
-    int n = a.Height();
+    int n = a.Size();
     height = n;
 
     int printstat = 0;
@@ -60,7 +64,7 @@ namespace ngla
     clock_t starttime, endtime;
     starttime = clock();
     
-    mdo = new MinimumDegreeOrdering (n);
+    auto mdo = make_unique<MinimumDegreeOrdering> (n);
 
     if (inner)
       for (int i = 0; i < n; i++)
@@ -119,7 +123,36 @@ namespace ngla
       cout << IM(4) << "start ordering" << endl;
     
     // mdo -> PrintCliques ();
-    mdo->Order();
+    if (nested_dissection)
+      {
+        auto use_entry = [&] (int i, int col)
+          {
+            if (inner) return inner->Test(i) && inner->Test(col);
+            if (cluster) return (*cluster)[i] == (*cluster)[col] && (*cluster)[i] != 0;
+            return true;
+          };
+        
+        Array<int> verts;
+        for (int i = 0; i < n; i++)
+          if (use_entry (i, i))
+            verts.Append (i);
+
+        TableCreator<int> creator(n);
+        for ( ; !creator.Done(); creator++)
+          for (int i : verts)
+            for (int col : a.GetRowIndices(i))
+              if (col < i && use_entry (i, col))
+                {
+                  creator.Add (i, col);
+                  creator.Add (col, i);
+                }
+        Table<int> graph = creator.MoveTable();
+
+        // the minimum degree machinery computes the fill for the given sequence
+        mdo->Order (NestedDissection (graph, verts));
+      }
+    else
+      mdo->Order();
     nused = mdo->nused;
     endtime = clock();
     if (printstat)
@@ -134,32 +167,133 @@ namespace ngla
     ta.Start();
     Allocate (mdo->order,  mdo->vertices, &mdo->blocknr[0]);
     ta.Stop();
+  }
 
-    tf.Start();
-    delete mdo;
-    mdo = 0;
 
+  bool SparseCholeskyAnalysis ::
+  Matches (const MatrixGraph & graph,
+           const BitArray * ainner, const Array<int> * acluster,
+           bool anested_dissection) const
+  {
+    size_t n = graph.Size();
+    if (size_t(height) != n || nested_dissection != anested_dissection) return false;
+    if (graph.NZE() != graph_colnr.Size()) return false;
+    if (bool(ainner) != bool(inner) || bool(acluster) != bool(cluster)) return false;
+
+    FlatArray<size_t> firsti = graph.GetFirstArray();
+    for (size_t i = 0; i <= n; i++)
+      if (firsti[i] != graph_firsti[i]) return false;
+    for (size_t i = 0; i < n; i++)
+      {
+        FlatArray<int> cols = graph.GetRowIndices(i);
+        for (size_t j = 0; j < cols.Size(); j++)
+          if (cols[j] != graph_colnr[graph_firsti[i]+j]) return false;
+        if (ainner && ainner->Test(i) != inner->Test(i)) return false;
+        if (acluster && (*acluster)[i] != (*cluster)[i]) return false;
+      }
+    return true;
+  }
+
+
+  /*
+    The cache is keyed on a hash of the pattern and the used dofs.
+    A hit is compared against the stored pattern, since hashes may collide.
+    It holds weak pointers, the analysis lives as long as some
+    factorization uses it.
+  */
+  shared_ptr<SparseCholeskyAnalysis> SparseCholeskyAnalysis ::
+  Get (const MatrixGraph & graph,
+       shared_ptr<BitArray> ainner,
+       shared_ptr<const Array<int>> acluster,
+       bool nested_dissection)
+  {
+    static Timer t("SparseCholesky - analysis lookup");
+    RegionTimer reg(t);
+
+    auto combine = [] (size_t & seed, size_t val)
+      { seed ^= val + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2); };
+    
+    size_t n = graph.Size();
+    size_t hash = n;
+    combine (hash, graph.NZE());
+    combine (hash, nested_dissection);
+    for (size_t i = 0; i < n; i++)
+      {
+        combine (hash, graph.GetRowIndices(i).Size());
+        for (int j : graph.GetRowIndices(i))
+          combine (hash, j);
+        if (ainner)
+          combine (hash, ainner->Test(i));
+        if (acluster)
+          combine (hash, (*acluster)[i]);
+      }
+    combine (hash, ainner != nullptr);
+    combine (hash, acluster != nullptr);
+
+    static mutex cache_mutex;
+    static std::map<size_t, weak_ptr<SparseCholeskyAnalysis>> cache;
+    {
+      lock_guard<mutex> guard(cache_mutex);
+      if (auto analysis = cache[hash].lock())
+        if (analysis->Matches (graph, ainner.get(), acluster.get(), nested_dissection))
+          return analysis;
+    }
+
+    auto analysis = make_shared<SparseCholeskyAnalysis> (graph, ainner, acluster, nested_dissection);
+
+    lock_guard<mutex> guard(cache_mutex);
+    for (auto it = cache.begin(); it != cache.end(); )
+      if (it->second.expired())
+        it = cache.erase(it);
+      else
+        it++;
+    cache[hash] = analysis;
+    return analysis;
+  }
+
+
+
+  template <class TM>
+  SparseCholeskyTM<TM> :: 
+  SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
+                    shared_ptr<BitArray> ainner,
+                    shared_ptr<const Array<int>> acluster,
+                    bool allow_refactor,
+                    bool nested_dissection)
+    : SparseCholeskyTM (a, SparseCholeskyAnalysis::Get (a, ainner, acluster, nested_dissection))
+  { ; }
+
+  
+  template <class TM>
+  SparseCholeskyTM<TM> :: 
+  SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
+                    shared_ptr<SparseCholeskyAnalysis> aanalysis)
+    : SparseFactorization (a, aanalysis->inner, aanalysis->cluster),
+      analysis(aanalysis), 
+      height(analysis->height), nused(analysis->nused), nze(analysis->nze),
+      order(analysis->order), inv_order(analysis->inv_order),
+      firstinrow(analysis->firstinrow), rowindex2(analysis->rowindex2),
+      firstinrow_ri(analysis->firstinrow_ri), blocknrs(analysis->blocknrs),
+      blocks(analysis->blocks), block_dependency(analysis->block_dependency),
+      microtasks(analysis->microtasks), micro_dependency(analysis->micro_dependency),
+      micro_dependency_trans(analysis->micro_dependency_trans),
+      maxrow(analysis->maxrow), mat(a)
+  { 
+    static Timer t("SparseCholesky - total");
+    static Timer tf("SparseCholesky - fill factor");
+    RegionTimer reg(t);
+
+    // a different pattern of the same size would be factored silently wrong
+    if (!analysis->Matches (a, analysis->inner.get(), analysis->cluster.get(),
+                            analysis->nested_dissection))
+      throw Exception ("SparseCholesky: matrix does not match the analysis");
+    int n = height;
+
+    tf.Start();
     diag.SetSize(nused);
     // lfact.SetSize (nze);
     lfact = NumaInterleavedArray<TM> (nze);
     lfact = TM(0.0);     // first touch
-    
-    endtime = clock();
-    if (printstat)
-      (cout) << "allocation time = "
-	     << double (endtime - starttime) / CLOCKS_PER_SEC << " secs" << endl;
-    
-    starttime = endtime;
-
-    /*
-    TM id;
-    id = 0.0;
-    SetIdentity(id);
-    
-    for (int i = 0; i < n; i++)
-      if (a.GetPositionTest (i,i) == numeric_limits<size_t>::max())
-	SetOrig (i, i, id);
-    */
 
     if (!inner && !cluster)
       // for (int i = 0; i < n; i++)
@@ -214,53 +348,12 @@ namespace ngla
 	}
 
     tf.Stop();
-    
-    if (printstat)
-      cout << IM(4) << "do factor " << flush;
 
     FactorSPD();
-    /*
-#ifdef LAPACK
-    if (a.IsSPD())
-      FactorSPD();
-    else
-#endif
-      Factor(); 
-    */
-
-    /*
-    for (int i = 0; i < n; i++)
-      if (a.GetPositionTest (i,i) == numeric_limits<size_t>::max())
-	diag[order[i]] = TM(0.0);
-
-    if (inner)
-      {
-	for (int i = 0; i < n; i++)
-	  if (!inner->Test(i))
-	    diag[order[i]] = TM(0.0);
-      }
-
-    if (cluster)
-      {
-	for (int i = 0; i < n; i++)
-	  if (!(*cluster)[i])
-	    diag[order[i]] = TM(0.0);
-      }
-    */
-
-    if (printstat)
-      cout << IM(4) << "done" << endl;
-    
-    endtime = clock();
-
-    if (printstat)
-      (cout) << " factoring time = " << double(endtime - starttime) / CLOCKS_PER_SEC << " sec" << endl;
   }
-  
 
-  
-  template <class TM>
-  void SparseCholeskyTM<TM> :: 
+
+  void SparseCholeskyAnalysis :: 
   Allocate (const Array<int> & aorder, 
 	    // const Array<CliqueEl*> & cliques,
 	    const Array<MDOVertex> & vertices,
@@ -295,7 +388,7 @@ namespace ngla
     nze = cnt;
 
     if (n > 2000)
-      cout << IM(4) << " " << cnt*sizeof(TM)+cnt_master*sizeof(int) << " Bytes " << flush;
+      cout << IM(4) << " " << cnt << " entries " << flush;
     //cout << IM(4) <<"(cnt="<<cnt<<", sizeof(TM)="<<sizeof(TM)<< ", cnt_master=" << cnt_master << ", sizeof(int)=" << sizeof(int) <<") " << flush;
 
 
@@ -864,6 +957,24 @@ namespace ngla
   }
 
   
+  template <typename TFUNC>
+  void RunParallelDependency (const Table<int> & dag,
+                              const Table<int> & trans_dag, // transposed dag
+                              TFUNC func);
+
+  
+  /*
+    Multifrontal factorization:
+    supernode s consists of the dofs [super[s], super[s+1]) and has the
+    external dofs ext(s). Its frontal matrix collects the entries of A and
+    the update matrices of its children in the elimination tree. After the
+    dense LDL^t of the front, the Schur complement on ext(s) is passed
+    as update matrix to the parent.
+
+    Subtrees with small fronts are independent and run in parallel,
+    the large fronts near the root run one after the other, with
+    parallel dense kernels.
+  */
   template <class TM> template<typename T>
   void SparseCholeskyTM<TM> :: FactorSPD1 (T dummy) 
   {
@@ -877,14 +988,9 @@ namespace ngla
       }
 
     static Timer factor_timer("SparseCholesky::Factor SPD");
-    static Timer factor_dense1("SparseCholesky::Factor SPD - setup dense cholesky");
-    static Timer factor_dense("SparseCholesky::Factor SPD - dense cholesky");
-
-    static Timer timerb("SparseCholesky::Factor - B", 2);
-    static Timer timerc("SparseCholesky::Factor - merge in rows");
-    static Timer timercla("SparseCholesky::Factor - merge(lapack)", 2);
-    static Timer timerc1("SparseCholesky::Factor - merge1", 2);
-    static Timer timerc2("SparseCholesky::Factor - merge2", 2);
+    static Timer timer_tree("SparseCholesky::Factor SPD - elimination tree");
+    static Timer timer_sub("SparseCholesky::Factor SPD - subtrees");
+    static Timer timer_top("SparseCholesky::Factor SPD - top fronts");
 
     RegionTimer reg (factor_timer);
     
@@ -892,79 +998,130 @@ namespace ngla
     if (n > 20)
       cout << IM(4) << " factor SPD " << flush;
 
-    // to avoid aliasing:
-    size_t * hfirstinrow = firstinrow.Addr(0);
-    size_t * hfirstinrow_ri = firstinrow_ri.Addr(0);
-    int * hrowindex2 = rowindex2.Addr(0);
-    TM * hlfact = lfact.Addr(0);
-    
-    Array<TM> tmpmem;
-    for (size_t i1 = 0; i1 < n;  )
+    timer_tree.Start();
+    Array<int> super;
+    for (size_t i = 0; i < n; i++)
+      if (i == 0 || blocknrs[i] != blocknrs[i-1])
+        super.Append (i);
+    size_t nsuper = super.Size();
+    super.Append (n);
+
+    auto ext = [&] (size_t s)
       {
-	size_t last_same = i1;
-	while (last_same < n && blocknrs[last_same] == blocknrs[i1])
-          {
-            last_same++;
+        size_t first = super[s];
+        size_t mi = super[s+1]-first;
+        size_t base = firstinrow_ri[first] + mi-1;
+        size_t ne = firstinrow[first+1]-firstinrow[first] - (mi-1);
+        return rowindex2.Range(base, base+ne);
+      };
+
+    Array<int> super_of_dof(n);
+    for (size_t s = 0; s < nsuper; s++)
+      super_of_dof[Range(super[s], super[s+1])] = s;
+
+    // the parent is the supernode of the first external dof
+    Array<int> parent(nsuper);
+    for (size_t s = 0; s < nsuper; s++)
+      parent[s] = ext(s).Size() ? super_of_dof[ext(s)[0]] : -1;
+
+    TableCreator<int> creator(nsuper);
+    for ( ; !creator.Done(); creator++)
+      for (size_t s = 0; s < nsuper; s++)
+        if (parent[s] != -1)
+          creator.Add (parent[s], s);
+    Table<int> children = creator.MoveTable();
+
+    // a front is on top if it or any front below is big, parents come after children
+    constexpr size_t bigfront = 256;
+    Array<bool> top(nsuper);
+    top = false;
+    for (size_t s = 0; s < nsuper; s++)
+      {
+        if (super[s+1]-super[s]+ext(s).Size() > bigfront)
+          top[s] = true;
+        if (top[s] && parent[s] != -1)
+          top[parent[s]] = true;
+      }
+    timer_tree.Stop();
 
-	    if (n > 2000 && (last_same) % 1000 == 999)
-	      {
-		if ((last_same) % 10000 == 9999)
-		  cout << IM(4) << "+" << flush;
-		else
-		  cout << IM(4) << "." << flush;
-	      }
-          }
+    // update matrices, column major lower part is valid
+    Array<Array<TM>> update(nsuper);
 
-        
-        // timerb.Start();
+    auto factor_front = [&] (size_t s)
+      {
+        size_t first = super[s], next = super[s+1];
+        size_t mi = next-first;
+        FlatArray<int> es = ext(s);
+        size_t ne = es.Size();
+        size_t nk = mi + ne;
 
-	// rows in same block ...
-	size_t mi = last_same - i1;
-        size_t nk = hfirstinrow[i1+1] - hfirstinrow[i1] + 1;
-        
-        // factor_dense1.Start();
-        // Matrix<TM,ColMajor> tmp(nk, nk);
-        tmpmem.SetSize(nk*nk);
+        Array<TM> tmpmem(nk*nk);
         FlatMatrix<TM,ColMajor> tmp(nk, nk, tmpmem.Addr(0));
 
-        bool big = nk > 1000;
-        if (big)
-          {
-            ParallelForRange (nk, [&](IntRange r)
-                              {
-                                tmp.Cols(r) = TM(0.0);
-                              });
-          }
+        if (nk > 1000)
+          ParallelForRange (nk, [&](IntRange r)
+                            {
+                              tmp.Cols(r) = TM(0.0);
+                            });
         else
-          {
-            tmp = TM(0.0);
-          }
+          tmp = TM(0.0);
 
 	for (size_t j = 0; j < mi; j++)
 	  {
-            tmp(j,j) = diag[i1+j];
-            tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+            tmp(j,j) = diag[first+j];
+            tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, &lfact[firstinrow[first+j]]);
+          }
+
+        // extend-add the update matrices of the children
+        for (int c : children[s])
+          {
+            FlatArray<int> ec = ext(c);
+            size_t nc = ec.Size();
+            Array<int> pos(nc);
+            for (size_t i = 0, k = 0; i < nc; i++)
+              {
+                size_t dof = ec[i];
+                if (dof < next)
+                  pos[i] = dof-first;
+                else
+                  {
+                    while (k < ne && size_t(es[k]) < dof) k++;
+                    if (k == ne || size_t(es[k]) != dof)
+                      throw Exception ("SparseCholesky: update matrix not contained in parent front");
+                    pos[i] = mi+k;
+                  }
+              }
+
+            FlatMatrix<TM,ColMajor> upd(nc, nc, update[c].Addr(0));
+            auto add_col = [&] (size_t j)
+              {
+                auto tcol = tmp.Col(pos[j]);
+                auto ucol = upd.Col(j);
+                for (size_t i = j; i < nc; i++)
+                  tcol(pos[i]) += ucol(i);
+              };
+            if (nc < 100)
+              for (size_t j = 0; j < nc; j++)
+                add_col(j);
+            else
+              ParallelFor (nc, add_col);
+            update[c].DeleteAll();
           }
 
-        // factor_dense1.Stop();
-        
         auto A11 = tmp.Rows(0,mi).Cols(0,mi);
         auto B   = tmp.Rows(mi,nk).Cols(0,mi);
         auto A22 = tmp.Rows(mi,nk).Cols(mi,nk);
-        // factor_dense.Start();
         CalcLDL (A11);
-        if (mi < nk)
+        if (ne > 0)
           {
             CalcLDL_SolveL (A11,B);
             CalcLDL_A2 (A11.Diag(),B,A22);
           }
-        // factor_dense.Stop();          
 
-        
         auto write_back_row = [&](size_t j)
           {
-            diag[i1+j] = A11(j,j);
-            FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+            diag[first+j] = A11(j,j);
+            FlatVector<TM>(nk-j-1, &lfact[firstinrow[first+j]]) = tmp.Col(j).Range(j+1,nk);
           };
 
         if (mi < 10)
@@ -973,83 +1130,56 @@ namespace ngla
         else
           ParallelFor (mi, write_back_row);
 
-        // timerb.Stop();
-        //timerc.Start();
-
-
-	// merge rows
-	size_t firsti_ri = hfirstinrow_ri[i1] + last_same-i1-1;
-	size_t firsti = hfirstinrow[i1] + last_same-i1-1;
-	size_t lasti = hfirstinrow[i1+1]-1;
-	mi = lasti-firsti+1;
-
-        // timerc1.Start();
-
-        auto merge_row = [&] (size_t j)
+        if (ne > 0)
           {
-            auto sum = A22.Col(j);
-            
-            // merge together
-            size_t firstj = hfirstinrow[hrowindex2[firsti_ri+j]];
-            size_t firstj_ri = hfirstinrow_ri[hrowindex2[firsti_ri+j]];
-            
-            for (size_t k = j+1; k < mi; k++)
-              {
-                size_t kk = hrowindex2[firsti_ri+k];
-                while (hrowindex2[firstj_ri] != kk)
-                  {
-                    firstj++;
-                    firstj_ri++;
-                  }
-                
-                lfact[firstj] += sum[k];
-                firstj++;
-                firstj_ri++;
-              }
-          };
-
-        if (mi < 100)
-          for (size_t j = 0; j < mi; j++)
-            merge_row(j);
-        else
-          ParallelFor (Range(mi), merge_row);
-          
-
-        // timerc1.Stop();
-
-        // timerc2.Start();
-	for (size_t i2 = i1; i2 < last_same; i2++)
-	  {
-	    size_t first = hfirstinrow[i2] + last_same-i2-1;
-	    size_t last = hfirstinrow[i2+1];
-	    size_t j_ri = hfirstinrow_ri[i2] + last_same-i2-1;
+            update[s].SetSize (ne*ne);
+            FlatMatrix<TM,ColMajor> upd(ne, ne, update[s].Addr(0));
+            for (size_t j = 0; j < ne; j++)
+              upd.Col(j).Range(j,ne) = A22.Col(j).Range(j,ne);
+          }
+      };
 
-	    for (auto j = first; j < last; j++, j_ri++)
-	      {
-		TM q = diag[i2] * lfact[j];
-		diag[rowindex2[j_ri]] -= Trans (lfact[j]) * q;
-	      }
-	  }
-        // timerc2.Stop();
-	i1 = last_same;
-        // timerc.Stop();
-      }
+    
+    timer_sub.Start();
+    Array<int> subnodes, subnr(nsuper);
+    for (size_t s = 0; s < nsuper; s++)
+      if (!top[s])
+        {
+          subnr[s] = subnodes.Size();
+          subnodes.Append (s);
+        }
 
-    size_t j = 0;
-    for (size_t i = 0; i < n; i++)
-      {
-	TM ai = diag[i];
-	size_t last = hfirstinrow[i+1];
+    TableCreator<int> creator_dag(subnodes.Size());
+    TableCreator<int> creator_trans(subnodes.Size());
+    for ( ; !creator_dag.Done(); creator_dag++, creator_trans++)
+      for (int s : subnodes)
+        if (parent[s] != -1 && !top[parent[s]])
+          {
+            creator_dag.Add (subnr[s], subnr[parent[s]]);
+            creator_trans.Add (subnr[parent[s]], subnr[s]);
+          }
+    Table<int> dag = creator_dag.MoveTable();
+    Table<int> trans_dag = creator_trans.MoveTable();
 
-	for ( ; j < last; j++)
-          lfact[j] = lfact[j] * ai;
-      }
+    RunParallelDependency (dag, trans_dag,
+                           [&] (int nr) { factor_front (subnodes[nr]); });
+    timer_sub.Stop();
+    
+    timer_top.Start();
+    for (size_t s = 0; s < nsuper; s++)
+      if (top[s])
+        factor_front (s);
+    timer_top.Stop();
 
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   TM ai = diag[i];
+                   for (size_t j = firstinrow[i]; j < firstinrow[i+1]; j++)
+                     lfact[j] = lfact[j] * ai;
+                 });
 
     if (n > 2000)
       cout << IM(4) << endl;
-
-    // task_manager -> StartWorkers();
   }
 
 
@@ -1827,7 +1957,7 @@ namespace ngla
   template <class TM>
   SparseCholeskyTM<TM> :: ~SparseCholeskyTM()
   {
-    delete mdo;
+    ;
   }
 
 
@@ -48,20 +48,14 @@ namespace ngla
 
 
   /**
-     A sparse cholesky factorization.
-     The unknowns are reordered by the minimum degree
-     ordering algorithm
-
-     computs A = L D L^t
-     L is stored column-wise
+     Symbolic factorization for the sparse cholesky factorization:
+     the ordering, the structure of the L-factor and the task graphs.
+     It depends only on the matrix graph and the used dofs, and is
+     shared by all factorizations of matrices with the same pattern.
   */
-
-  template<class TM>
-	   // class TV_ROW = typename mat_traits<TM>::TV_ROW, 
-	   // class TV_COL = typename mat_traits<TM>::TV_COL>
-  class SparseCholeskyTM : public SparseFactorization
+  class NGS_DLL_HEADER SparseCholeskyAnalysis
   {
-  protected:
+  public:
     // height of the matrix
     int height;
     // number of real unknowns
@@ -73,17 +67,9 @@ namespace ngla
     Array<int> order;
     Array<int> inv_order;
     
-    // L-factor in compressed storage
-    // Array<TM, size_t> lfact;
-    NumaInterleavedArray<TM> lfact;
-
     // index-array to lfact
     Array<size_t> firstinrow;
 
-    // diagonal 
-    Array<TM> diag;
-
-
     // row-indices of non-zero entries
     // all row-indices within one block are identic, and stored just once
     Array<int> rowindex2;
@@ -99,7 +85,6 @@ namespace ngla
     // dependency graph for elimination
     Table<int> block_dependency; 
 
-  public:      // needed for gcc 4.9, why  ??? 
     class MicroTask
     {
     public:
@@ -109,19 +94,115 @@ namespace ngla
       int bblock;
       int nbblocks;
     };
-  protected:
     
     Array<MicroTask> microtasks;
     Table<int> micro_dependency;     
     Table<int> micro_dependency_trans;     
 
+    // maximal non-zero entries in a column
+    int maxrow;
 
-    //
-    MinimumDegreeOrdering * mdo;
+    // the used dofs
+    shared_ptr<BitArray> inner;
+    shared_ptr<const Array<int>> cluster;
+
+    // the pattern the analysis was computed for, to validate cache hits
+    Array<size_t> graph_firsti;
+    Array<int> graph_colnr;
+    bool nested_dissection;
+
+    ///
+    SparseCholeskyAnalysis (const MatrixGraph & graph,
+                            shared_ptr<BitArray> ainner = nullptr,
+                            shared_ptr<const Array<int>> acluster = nullptr,
+                            bool nested_dissection = false);
+
+    /// returns the analysis of a previous call for the same pattern and used dofs, if still alive
+    static shared_ptr<SparseCholeskyAnalysis> Get (const MatrixGraph & graph,
+                                                   shared_ptr<BitArray> ainner = nullptr,
+                                                   shared_ptr<const Array<int>> acluster = nullptr,
+                                                   bool nested_dissection = false);
+
+    /// is this the analysis for the given pattern and used dofs ?
+    bool Matches (const MatrixGraph & graph,
+                  const BitArray * ainner, const Array<int> * acluster,
+                  bool anested_dissection) const;
+
+    // the dofs of block bnr
+    IntRange BlockDofs (int bnr) const { return Range(blocks[bnr], blocks[bnr+1]); }
+
+    // the external dofs of block bnr
+    FlatArray<int> BlockExtDofs (int bnr) const
+    {
+      auto range = BlockDofs (bnr);
+      auto base = firstinrow_ri[range.First()] + range.Size()-1;
+      auto ext_size =  firstinrow[range.First()+1]-firstinrow[range.First()] - range.Size()+1;
+      return rowindex2.Range(base, base+ext_size);
+    }
+
+  private:
+    void Allocate (const Array<int> & aorder, 
+		   const Array<MDOVertex> & vertices,
+		   const int * blocknr);
+  };
+
+
+
+
+  /**
+     A sparse cholesky factorization.
+     The unknowns are reordered by the minimum degree
+     ordering algorithm, or by nested dissection
+
+     computs A = L D L^t
+     L is stored column-wise
+
+     The symbolic factorization is taken from a SparseCholeskyAnalysis,
+     matrices of the same pattern share it.
+  */
+
+  template<class TM>
+	   // class TV_ROW = typename mat_traits<TM>::TV_ROW, 
+	   // class TV_COL = typename mat_traits<TM>::TV_COL>
+  class SparseCholeskyTM : public SparseFactorization
+  {
+  protected:
+    shared_ptr<SparseCholeskyAnalysis> analysis;
+    
+    // height of the matrix
+    int height;
+    // number of real unknowns
+    int nused;
+    // number of non-zero entries in the L-factor
+    size_t nze;
+
+    // the symbolic factorization, see SparseCholeskyAnalysis
+    Array<int> & order;
+    Array<int> & inv_order;
+    Array<size_t> & firstinrow;
+    Array<int> & rowindex2;
+    Array<size_t> & firstinrow_ri;
+    Array<int> & blocknrs;
+    Array<int> & blocks; 
+    Table<int> & block_dependency; 
+
+  public:
+    typedef SparseCholeskyAnalysis::MicroTask MicroTask;
+  protected:
+    Array<MicroTask> & microtasks;
+    Table<int> & micro_dependency;     
+    Table<int> & micro_dependency_trans;     
 
     // maximal non-zero entries in a column
     int maxrow;
 
+    // L-factor in compressed storage
+    // Array<TM, size_t> lfact;
+    NumaInterleavedArray<TM> lfact;
+
+    // diagonal 
+    Array<TM> diag;
+
     // the original matrix
     const SparseMatrixTM<TM> & mat;
 
@@ -132,7 +213,11 @@ namespace ngla
     SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
                       shared_ptr<BitArray> ainner = nullptr,
                       shared_ptr<const Array<int>> acluster = nullptr,
-                      bool allow_refactor = 0);
+                      bool allow_refactor = 0,
+                      bool nested_dissection = false);
+    /// numeric factorization only
+    SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
+                      shared_ptr<SparseCholeskyAnalysis> aanalysis);
     ///
     virtual ~SparseCholeskyTM ();
     ///
@@ -140,9 +225,7 @@ namespace ngla
     ///
     int VWidth() const { return height; }
     ///
-    void Allocate (const Array<int> & aorder, 
-		   const Array<MDOVertex> & vertices,
-		   const int * blocknr);
+    shared_ptr<SparseCholeskyAnalysis> GetAnalysis() const { return analysis; }
     ///
     void Factor (); 
 #ifdef LAPACK
@@ -236,8 +319,13 @@ namespace ngla
     SparseCholesky (const SparseMatrixTM<TM> & a, 
 		    shared_ptr<BitArray> ainner = nullptr,
 		    shared_ptr<const Array<int>> acluster = nullptr,
-		    bool allow_refactor = 0)
-      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor) { ; }
+		    bool allow_refactor = 0,
+                    bool nested_dissection = false)
+      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor, nested_dissection) { ; }
+
+    SparseCholesky (const SparseMatrixTM<TM> & a, 
+                    shared_ptr<SparseCholeskyAnalysis> aanalysis)
+      : SparseCholeskyTM<TM> (a, aanalysis) { ; }
 
     ///
     virtual ~SparseCholesky () { ; }
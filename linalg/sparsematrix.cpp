@@ -952,11 +952,12 @@ namespace ngla
     else if (ainversetype == "mumps")         SetInverseType ( MUMPS );
     else if (ainversetype == "masterinverse") SetInverseType ( MASTERINVERSE );
     else if (ainversetype == "sparsecholesky") SetInverseType ( SPARSECHOLESKY );
+    else if (ainversetype == "sparsecholesky_nd") SetInverseType ( SPARSECHOLESKY_ND );
     else if (ainversetype == "umfpack")       SetInverseType ( UMFPACK );
     else
       {
         throw Exception (ToString("undefined inverse ")+ainversetype+
-                         "\nallowed is: 'sparsecholesky', 'pardiso', 'pardisospd', 'mumps', 'masterinverse', 'umfpack'");
+                         "\nallowed is: 'sparsecholesky', 'sparsecholesky_nd', 'pardiso', 'pardisospd', 'mumps', 'masterinverse', 'umfpack'");
       }
     return old_invtype;
   }
@@ -1117,6 +1118,76 @@ namespace ngla
 
   }
 
+  // y += s A x for all vectors at once, only for scalar real matrices
+  template <typename TM>
+  static bool SparseMultAddMulti (const SparseMatrixTM<TM> & mat, const Partitioning & balance,
+                                  bool symmetric, double s, const MultiVector & x, MultiVector & y)
+  {
+    return false;
+  }
+
+  static bool SparseMultAddMulti (const SparseMatrixTM<double> & mat, const Partitioning & balance,
+                                  bool symmetric, double s, const MultiVector & x, MultiVector & y)
+  {
+    static Timer t("SparseMatrix::MultAdd MultiVector"); RegionTimer reg(t);
+    t.AddFlops ((symmetric ? 2 : 1) * mat.NZE() * x.NVecs());
+
+    auto fx = x.Data();
+    auto fy = y.Data();
+    size_t k = x.NVecs();
+
+    auto addrow = [&] (size_t row)
+      {
+        auto cols = mat.GetRowIndices(row);
+        auto vals = mat.GetRowValues(row);
+        double * py = &fy(row,0);
+        for (size_t j = 0; j < cols.Size(); j++)
+          {
+            double val = s * vals(j);
+            const double * px = &fx(cols[j],0);
+            for (size_t l = 0; l < k; l++)
+              py[l] += val * px[l];
+          }
+      };
+
+    if (!symmetric)
+      {
+        ParallelForRange (balance, [&] (IntRange r)
+                          {
+                            for (size_t row : r) addrow (row);
+                          });
+        return true;
+      }
+
+    // lower triangle and its transpose, as the symmetric MultAdd
+    for (size_t row = 0; row < mat.Height(); row++)
+      {
+        addrow (row);
+        auto cols = mat.GetRowIndices(row);
+        auto vals = mat.GetRowValues(row);
+        const double * px = &fx(row,0);
+        for (size_t j = 0; j < cols.Size(); j++)
+          {
+            if (size_t(cols[j]) == row) continue;
+            double val = s * vals(j);
+            double * py = &fy(cols[j],0);
+            for (size_t l = 0; l < k; l++)
+              py[l] += val * px[l];
+          }
+      }
+    return true;
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    // real matrix for complex vectors is not a scalar SpMM
+    if (x.Size() != size_t(this->Width()) ||
+        !SparseMultAddMulti (*this, balance, false, s, x, y))
+      BaseMatrix::MultAdd (s, x, y);
+  }
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
@@ -1198,9 +1269,14 @@ namespace ngla
     ar & this->size;
     ar & this->width;
     ar & this->nze;
-    ar & firsti;
-    ar & colnr;
-    ar & data;
+    DoMapped (ar, firsti);
+    DoMapped (ar, colnr);
+    DoMapped (ar, data);
+    if (ar.Input())
+      {
+        this->mapped_memory = ar.GetMapping();
+        this->CalcBalancing();
+      }
     cout << "sparsemat, doarch, sizeof (firstint) = " << firsti.Size() << endl;
   }
 
@@ -1248,7 +1324,8 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset, nullptr, false,
+                                                         this->GetInverseType() == SPARSECHOLESKY_ND);
     //#endif
   }
 
@@ -1309,7 +1386,8 @@ namespace ngla
       }
     else
       {
-        return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters);
+        return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters, false,
+                                                         this->GetInverseType() == SPARSECHOLESKY_ND);
       }
   }
 
@@ -1379,131 +1457,17 @@ namespace ngla
                                   shared_ptr<BaseSparseMatrix> acmat ) const
   {
     static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
     RegionTimer reg(t);
-    
-    int n = this->Height();
-
-    auto cmat = dynamic_pointer_cast<SparseMatrixTM<TM>> (acmat);
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
-
-	Array<int> marks(n);
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-	      FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-	      FlatArray<int> prol_colind = prol.GetRowIndices(col);
-
-	      for (int k = 0; k < prol_rowind.Size(); k++)
-		for (int l = 0; l < prol_colind.Size(); l++)
-		  {
-		    int kk = prol_rowind[k];
-		    int ll = prol_colind[l];
-		    
-		    // if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-		  }
-	    }
-
-	int nc = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  nc = max2 (nc, e2v[i][1]);
-	nc++;
-
-	// *testout << "e2v = " << endl << e2v << endl;
-        
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
-
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
-	
-	cnt = 0;
-	marks = -1;
-
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
-
-	cmat = make_shared<SparseMatrix<TM,TV_ROW,TV_COL>> (cnt);
-
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
-      }
-
-    cmat->AsVector() = 0.0;
-    RegionTimer reg2(tcomp);
-	  
-    for (int i = 0; i < n; i++)
-      {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<TM> mat_rval = this->GetRowValues(i);
-
-        for (int j = 0; j < mat_ri.Size(); j++)
-          {
-            int col = mat_ri[j];
-            TM mat_val = mat_rval[j]; 
 
-            FlatArray<int> prol_ri_i = prol.GetRowIndices(i);
-            FlatArray<int> prol_ri_col = prol.GetRowIndices(col);
-            FlatVector<double> prol_rval_i = prol.GetRowValues(i);
-            FlatVector<double> prol_rval_col = prol.GetRowValues(col);
+    // same graph as the old coarse matrix: only refill the values
+    auto cmat = dynamic_pointer_cast<SparseMatrix<TM,TV_ROW,TV_COL>> (acmat);
+    if (cmat && !dynamic_pointer_cast<SparseMatrixSymmetric<TM,TV_ROW>> (acmat) &&
+        cmat->Height() == prol.Width() && GalerkinProduct (*this, false, prol, *cmat))
+      return cmat;
 
-            for (int k = 0; k < prol_ri_i.Size(); k++)
-              for (int l = 0; l < prol_ri_col.Size(); l++)
-                {
-                  int kk = prol_ri_i[k];
-                  int ll = prol_ri_col[l];
-                  
-                  if ( /*kk>=ll &&*/ kk < cmat->Height() )
-                    {
-                      (*cmat)(kk,ll) += 
-                        prol_rval_i[k] * prol_rval_col[l] * mat_val; 
-                    }
-                  
-                  // if (ll >= kk && i != col && ll < cmat->Height() )
-                  //   {
-                  //     (*cmat)(ll,kk) += 
-                  //       prol_rval_col[l] * prol_rval_i[k] * Trans(mat_val); 
-                  //   }
-                  
-                }
-          }
-      }
+    auto graph = GalerkinGraph (*this, false, prol);
+    cmat = make_shared<SparseMatrix<TM,TV_ROW,TV_COL>> (*graph, true);
+    GalerkinProduct (*this, false, prol, *cmat);
     return cmat;
   }
 
@@ -1631,6 +1595,15 @@ namespace ngla
       }
   }
 
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    if (x.Size() != size_t(this->Width()) ||
+        !SparseMultAddMulti (*this, this->balance, true, s, x, y))
+      BaseMatrix::MultAdd (s, x, y);
+  }
+
   template <class TM, class TV>
   void SparseMatrixSymmetric<TM,TV> :: 
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
@@ -1961,340 +1934,240 @@ namespace ngla
     return MatMult<double, double, double>(mata, matb);
   }
 
-  template <class TM, class TV>
-  shared_ptr<BaseSparseMatrix>
-  SparseMatrixSymmetric<TM,TV> :: Restrict (const SparseMatrixTM<double> & prol,
-					    shared_ptr<BaseSparseMatrix> acmat ) const
-  {
-    static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
-    RegionTimer reg(t);
-    
-    int n = this->Height();
-
-    auto cmat = dynamic_pointer_cast<SparseMatrixSymmetric<TM,TV>>(acmat);
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
-
-	Array<int> marks(n);
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-	      FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-	      FlatArray<int> prol_colind = prol.GetRowIndices(col);
-
-	      for (int k = 0; k < prol_rowind.Size(); k++)
-		for (int l = 0; l < prol_colind.Size(); l++)
-		  {
-		    int kk = prol_rowind[k];
-		    int ll = prol_colind[l];
-		    
-		    if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-		  }
-	    }
-
-	int nc = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  nc = max2 (nc, e2v[i][1]);
-	nc++;
-
-	// *testout << "e2v = " << endl << e2v << endl;
-        
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
-
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
-	
-	cnt = 0;
-	marks = -1;
-
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
-
-	cmat = make_shared<SparseMatrixSymmetric<TM,TV>> (cnt);
-
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
-      }
-
-    *cmat = 0.;
-    RegionTimer reg2(tcomp);
-	  
-    for (int i = 0; i < n; i++)
-      {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<TM> mat_rval = this->GetRowValues(i);
-
-        for (int j = 0; j < mat_ri.Size(); j++)
-          {
-            int col = mat_ri[j];
-            TM mat_val = mat_rval[j]; 
-
-            FlatArray<int> prol_ri_i = prol.GetRowIndices(i);
-            FlatArray<int> prol_ri_col = prol.GetRowIndices(col);
-            FlatVector<double> prol_rval_i = prol.GetRowValues(i);
-            FlatVector<double> prol_rval_col = prol.GetRowValues(col);
-
-            for (int k = 0; k < prol_ri_i.Size(); k++)
-              for (int l = 0; l < prol_ri_col.Size(); l++)
-                {
-                  int kk = prol_ri_i[k];
-                  int ll = prol_ri_col[l];
-                  
-                  if ( kk>=ll && kk < cmat->Height() )
-                    {
-                      (*cmat)(kk,ll) += 
-                        prol_rval_i[k] * prol_rval_col[l] * mat_val; 
-                    }
-                  
-                  if (ll >= kk && i != col && ll < cmat->Height() )
-                    {
-                      (*cmat)(ll,kk) += 
-                        prol_rval_col[l] * prol_rval_i[k] * Trans(mat_val); 
-                    }
-                  
-                }
-          }
-      }
-    return cmat;
-  }
-  
-
-
 
-  template <> shared_ptr<BaseSparseMatrix>
-  SparseMatrix<double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                    shared_ptr<BaseSparseMatrix> acmat ) const
+  // row i of a symmetric matrix stores the lower part, collect the upper part
+  static Table<int> UpperGraph (const MatrixGraph & graph)
   {
-    static Timer t ("sparsematrix - restrict");
-    RegionTimer reg(t);
-
-    auto prolT = TransposeMatrix(prol);
-
-    auto prod1 = MatMult<double, double, double>(*this, prol);
-    auto prod = MatMult<double, double, double>(*prolT, *prod1);
-    return prod;
+    TableCreator<int> creator(graph.Size());
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < graph.Size(); i++)
+        for (int j : graph.GetRowIndices(i))
+          if (j < i)
+            creator.Add (j, i);
+    return creator.MoveTable();
   }
 
-  template <> shared_ptr<BaseSparseMatrix>
-  SparseMatrix<std::complex<double>> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                  shared_ptr<BaseSparseMatrix> acmat ) const
+  shared_ptr<MatrixGraph>
+  GalerkinGraph (const MatrixGraph & graph, bool symmetric, const SparseMatrixTM<double> & prol)
   {
-    static Timer t ("sparsematrix - restrict");
+    static Timer t ("Galerkin graph");
     RegionTimer reg(t);
-    // new version
-    auto prolT = TransposeMatrix(prol);
 
-    auto prod1 = MatMult<std::complex<double>, std::complex<double>, double>(*this, prol);
-    auto prod = MatMult<std::complex<double>, double, std::complex<double>>(*prolT, *prod1);
-    return prod;
-  }
+    if (prol.Height() != graph.Size())
+      throw Exception ("GalerkinGraph: prolongation does not fit to matrix");
 
+    size_t nc = prol.Width();
+    auto rest = TransposeMatrix (prol);
+    Table<int> upper;
+    if (symmetric)
+      upper = UpperGraph (graph);
 
+    Array<int> cnt(nc);
+    shared_ptr<MatrixGraph> cgraph;
 
+    // pass 0: count, pass 1: fill sorted column numbers
+    for (int pass = 0; pass < 2; pass++)
+      {
+        ParallelForRange
+          (IntRange(nc), [&] (IntRange r)
+           {
+             // only row-sized scratch, duplicates are removed after sorting
+             Array<int> cols;
+             for (int I : r)
+               {
+                 cols.SetSize0();
+                 auto addrow = [&] (int k)
+                   {
+                     for (int J : prol.GetRowIndices(k))
+                       if (!symmetric || J <= I)
+                         cols.Append (J);
+                   };
+                 for (int i : rest->GetRowIndices(I))
+                   {
+                     for (int k : graph.GetRowIndices(i))
+                       addrow (k);
+                     if (symmetric)
+                       for (int k : upper[i])
+                         addrow (k);
+                   }
+                 QuickSort (cols);
+                 size_t nu = 0;
+                 for (size_t j = 0; j < cols.Size(); j++)
+                   if (nu == 0 || cols[j] != cols[nu-1])
+                     cols[nu++] = cols[j];
+                 cols.SetSize (nu);
+                 
+                 if (pass == 0)
+                   cnt[I] = cols.Size();
+                 else
+                   cgraph->GetRowIndices(I) = cols;
+               }
+           },
+           TasksPerThread(4));
+        if (pass == 0)
+          cgraph = make_shared<MatrixGraph> (cnt, nc);
+      }
 
+    return cgraph;
+  }
 
-  template <> shared_ptr<BaseSparseMatrix>
-  SparseMatrixSymmetric<double,double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                    shared_ptr<BaseSparseMatrix> acmat ) const
+  template <typename TM>
+  bool GalerkinProduct (const SparseMatrixTM<TM> & mat, bool symmetric,
+                        const SparseMatrixTM<double> & prol, SparseMatrixTM<TM> & cmat)
   {
-    static Timer t ("sparsematrixsymmetric - restrict");
-    RegionTimer reg(t);
-    // new version
-    auto prolT = TransposeMatrix(prol);
-    auto full = MakeFullMatrix(*this);
-
-    auto prod1 = MatMult<double, double, double>(*full, prol);
-    auto prod = MatMult<double, double, double>(*prolT, *prod1);
-
-    auto prodhalf = GetSymmetricMatrix (*prod);
-    return prodhalf;
-
-
-#ifdef OLD
-
-    static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tbuild1 ("sparsematrix - restrict, build matrix1");
-    static Timer tbuild2 ("sparsematrix - restrict, build matrix2");
-    static Timer tbuild3 ("sparsematrix - restrict, build matrix3");
-    static Timer tbuild4 ("sparsematrix - restrict, build matrix4");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
+    static Timer t ("Galerkin product");
     RegionTimer reg(t);
-    
-    int n = this->Height();
 
-    SparseMatrixSymmetric<double,double>* cmat = 
-      dynamic_cast< SparseMatrixSymmetric<double,double>* > ( acmat );
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
-        tbuild1.Start();
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-
-	      for (int kk : prol.GetRowIndices(i))
-		for (int ll : prol.GetRowIndices(col))
-		  {
-                    /*
-		    if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-                    */
-                    INT<2> i2 = (kk<ll) ? INT<2>(kk,ll) : INT<2>(ll,kk);
-                    e2v.Append (i2);
-		  }
-	    }
+    if (prol.Height() != mat.Height() || prol.Width() != cmat.Height())
+      throw Exception ("GalerkinProduct: prolongation does not fit to matrix");
 
-	int nc = 0;
-        for (auto vpair : e2v)
-          nc = max2 (nc, vpair[1]);
-	nc++;
+    // dry pass: check the pattern of cmat before touching its values,
+    // the caller keeps the old matrix if it does not fit
+    atomic<bool> ok(true);
+    ParallelForRange
+      (IntRange(mat.Height()), [&] (IntRange r)
+       {
+         Array<int> cols;
+         for (int i : r)
+           {
+             if (!ok) return;
+             cols.SetSize0();
+             for (int k : mat.GetRowIndices(i))
+               for (int J : prol.GetRowIndices(k))
+                 cols.Append (J);
+             QuickSort (cols);
+
+             for (int I : prol.GetRowIndices(i))
+               for (size_t j = 0; j < cols.Size(); j++)
+                 {
+                   int J = cols[j];
+                   if (j > 0 && cols[j-1] == J) continue;
+                   if ( (!symmetric || J <= I) &&
+                        cmat.GetPositionTest (I, J) == numeric_limits<size_t>::max())
+                     ok = false;
+                   if ( (symmetric && J >= I) &&
+                        cmat.GetPositionTest (J, I) == numeric_limits<size_t>::max())
+                     ok = false;
+                 }
+           }
+       },
+       TasksPerThread(4));
+    if (!ok) return false;
 
-        tbuild1.Stop();
-        tbuild2.Start();
+    cmat.AsVector() = 0.0;
 
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
+    // row i of mat contributes prol(i,I) * (mat(i,:) * prol) to row I of cmat,
+    // for symmetric storage the strict lower part contributes also transposed
+    ParallelForRange
+      (IntRange(mat.Height()), [&] (IntRange r)
+       {
+         // row-sized sparse accumulator: the contributions of row i are
+         // collected, sorted by coarse column and summed up
+         Array<int> cols, index;
+         Array<TM> c1, c2, w1, w2;
 
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
+         auto add = [&] (int I, int J, const TM & val)
+           {
+             MyAtomicAdd (cmat[cmat.GetPosition (I, J)], val);
+           };
 
-        tbuild2.Stop();
-        tbuild3.Start();
-	
-	cnt = 0;
-	Array<int> marks(n);
-	marks = -1;
+         for (int i : r)
+           {
+             auto ci = mat.GetRowIndices(i);
+             auto vals = mat.GetRowValues(i);
+             cols.SetSize0();
+             c1.SetSize0();
+             c2.SetSize0();
+             for (size_t j = 0; j < ci.Size(); j++)
+               {
+                 int k = ci[j];
+                 auto pci = prol.GetRowIndices(k);
+                 auto pvals = prol.GetRowValues(k);
+                 for (size_t l = 0; l < pci.Size(); l++)
+                   {
+                     TM val = pvals[l] * vals[j];
+                     cols.Append (pci[l]);
+                     c1.Append (val);
+                     c2.Append ( (symmetric && k != i) ? val : TM(0.0) );
+                   }
+               }
 
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
+             index.SetSize (cols.Size());
+             for (size_t j = 0; j < index.Size(); j++)
+               index[j] = j;
+             QuickSortI (cols, index);
 
-        tbuild3.Stop();
-        tbuild4.Start();
+             size_t nu = 0;
+             w1.SetSize (cols.Size());
+             w2.SetSize (cols.Size());
+             for (size_t j = 0; j < index.Size(); j++)
+               {
+                 int J = cols[index[j]];
+                 if (nu > 0 && cols[index[nu-1]] == J)
+                   {
+                     w1[nu-1] += c1[index[j]];
+                     w2[nu-1] += c2[index[j]];
+                   }
+                 else
+                   {
+                     index[nu] = index[j];
+                     w1[nu] = c1[index[j]];
+                     w2[nu] = c2[index[j]];
+                     nu++;
+                   }
+               }
 
-	cmat = new SparseMatrixSymmetric<double,double> (cnt);
+             auto pci = prol.GetRowIndices(i);
+             auto pvals = prol.GetRowValues(i);
+             for (size_t l = 0; l < pci.Size(); l++)
+               {
+                 int I = pci[l];
+                 double p = pvals[l];
+                 for (size_t j = 0; j < nu; j++)
+                   {
+                     int J = cols[index[j]];
+                     if (!symmetric || J <= I)
+                       add (I, J, p * w1[j]);
+                     if (symmetric && J >= I)
+                       add (J, I, Trans (p * w2[j]));
+                   }
+               }
+           }
+       },
+       TasksPerThread(4));
 
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
+    return true;
+  }
 
-        tbuild4.Stop();
-      }
+  template NGS_DLL_HEADER bool GalerkinProduct<double>
+  (const SparseMatrixTM<double> & mat, bool symmetric,
+   const SparseMatrixTM<double> & prol, SparseMatrixTM<double> & cmat);
+  template NGS_DLL_HEADER bool GalerkinProduct<Complex>
+  (const SparseMatrixTM<Complex> & mat, bool symmetric,
+   const SparseMatrixTM<double> & prol, SparseMatrixTM<Complex> & cmat);
 
-    *cmat = 0.;
-    RegionTimer reg2(tcomp);
+  template <class TM, class TV>
+  shared_ptr<BaseSparseMatrix>
+  SparseMatrixSymmetric<TM,TV> :: Restrict (const SparseMatrixTM<double> & prol,
+					    shared_ptr<BaseSparseMatrix> acmat ) const
+  {
+    static Timer t ("sparsematrixsymmetric - restrict");
+    RegionTimer reg(t);
 
-    // #pragma omp parallel for	  
-    for (int i = 0; i < n; i++)
-      {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<double> mat_rval = this->GetRowValues(i);
+    // same graph as the old coarse matrix: only refill the values
+    auto cmat = dynamic_pointer_cast<SparseMatrixSymmetric<TM,TV>> (acmat);
+    if (cmat && cmat->Height() == prol.Width() && GalerkinProduct (*this, true, prol, *cmat))
+      return cmat;
 
-        for (int j = 0; j < mat_ri.Size(); j++)
-          {
-            int col = mat_ri[j];
-            double mat_val = mat_rval[j]; 
+    auto graph = GalerkinGraph (*this, true, prol);
+    cmat = make_shared<SparseMatrixSymmetric<TM,TV>> (*graph, true);
+    GalerkinProduct (*this, true, prol, *cmat);
+    return cmat;
+  }
+  
 
-            FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-            FlatArray<int> prol_colind = prol.GetRowIndices(col);
-            FlatVector<double> prol_rowval = prol.GetRowValues(i);
-            FlatVector<double> prol_colval = prol.GetRowValues(col);
 
-            for (int k = 0; k < prol_rowind.Size(); k++)
-              for (int l = 0; l < prol_colind.Size(); l++)
-                {
-                  int kk = prol_rowind[k];
-                  int ll = prol_colind[l];
-                  
-                  if ( kk>=ll && kk < cmat->Height() )
-                    {
-                      auto val = prol_rowval[k] * prol_colval[l] * mat_val;
-                      // #pragma omp atomic                      
-                      (*cmat)(kk,ll) += val;
-                    }
-                  
-                  if (ll >= kk && i != col && ll < cmat->Height() )
-                    {
-                      auto val = prol_colval[l] * prol_rowval[k] * Trans(mat_val);
-                      // #pragma omp atomic                      
-                      (*cmat)(ll,kk) += val;
-                    }
-                  
-                }
-          }
-      }
-    return cmat;
-#endif
 
-  }
 
 
 
@@ -2342,7 +2215,8 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset, nullptr, false,
+                                                         this->GetInverseType() == SPARSECHOLESKY_ND);
   }
 
   template <class TM, class TV>
@@ -2383,7 +2257,8 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters, false,
+                                                         this->GetInverseType() == SPARSECHOLESKY_ND);
   }
 
 
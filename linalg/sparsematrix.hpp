@@ -99,6 +99,9 @@ namespace ngla
     /// owner of arrays ?
     bool owner;
 
+    /// arrays restored from a mapped archive refer to this memory
+    shared_ptr<void> mapped_memory;
+
   public:
     /// arbitrary number of els/row
     MatrixGraph (const Array<int> & elsperrow, int awidth);
@@ -466,6 +469,8 @@ namespace ngla
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
+    /// SpMM for scalar real matrices
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
 
     virtual void MultAdd1 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
@@ -626,6 +631,8 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
+
 
     /*
       y += s L * x
@@ -688,6 +695,16 @@ namespace ngla
   shared_ptr<SparseMatrixTM<double>>
   MatMult (const SparseMatrix<double, double, double> & mata, const SparseMatrix<double, double, double> & matb);
 
+  /// graph of prol^T mat prol, only the lower part for symmetric storage
+  NGS_DLL_HEADER shared_ptr<MatrixGraph>
+  GalerkinGraph (const MatrixGraph & graph, bool symmetric, const SparseMatrixTM<double> & prol);
+
+  /// overwrites the values of cmat by prol^T mat prol, without forming mat*prol.
+  /// returns false and leaves cmat unchanged if the graph of cmat misses entries of the product
+  template <typename TM>
+  NGS_DLL_HEADER bool GalerkinProduct (const SparseMatrixTM<TM> & mat, bool symmetric,
+                                       const SparseMatrixTM<double> & prol, SparseMatrixTM<TM> & cmat);
+
 #ifdef GOLD
 #include <sparsematrix_spec.hpp>
 #endif
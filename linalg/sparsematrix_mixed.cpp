@@ -0,0 +1,149 @@
+/*********************************************************************/
+/* File:   sparsematrix_mixed.cpp                                    */
+/* Date:   18. Oct. 2026                                             */
+/*********************************************************************/
+
+/*
+   sparse matrix with reduced precision storage
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  template <typename TSTORE>
+  SparseMatrixMixed<TSTORE> :: SparseMatrixMixed (const SparseMatrix<double> & mat)
+  {
+    static Timer t("SparseMatrixMixed - ctor"); RegionTimer reg(t);
+
+    height = mat.Height();
+    width = mat.Width();
+    symmetric = dynamic_cast<const SparseMatrixSymmetric<double>*> (&mat) != nullptr;
+
+    firsti.SetSize (height+1);
+    for (size_t i = 0; i <= height; i++)
+      firsti[i] = mat.First(i);
+    colnr.SetSize (firsti[height]);
+    values.SetSize (firsti[height]);
+
+    ParallelFor (Range(height), [&] (size_t i)
+                 {
+                   auto ind = mat.GetRowIndices(i);
+                   auto vals = mat.GetRowValues(i);
+                   for (size_t k = 0; k < ind.Size(); k++)
+                     {
+                       colnr[firsti[i]+k] = ind[k];
+                       values[firsti[i]+k] = TSTORE(vals(k));
+                     }
+                 });
+
+    balance.Calc (height, [&] (size_t i) { return 5 + firsti[i+1]-firsti[i]; });
+  }
+
+
+  template <typename TSTORE>
+  AutoVector SparseMatrixMixed<TSTORE> :: CreateRowVector () const
+  {
+    return make_shared<VVector<double>> (width);
+  }
+
+  template <typename TSTORE>
+  AutoVector SparseMatrixMixed<TSTORE> :: CreateColVector () const
+  {
+    return make_shared<VVector<double>> (height);
+  }
+
+
+  template <typename TSTORE>
+  void SparseMatrixMixed<TSTORE> :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t(string("SparseMatrixMixed<") + (sizeof(TSTORE)==4 ? "float" : "bf16") + ">::MultAdd");
+    RegionTimer reg(t);
+
+    const double * px = x.FVDouble().Addr(0);
+    FlatVector<double> fy = y.FVDouble();
+
+    if (symmetric)
+      {
+        // lower triangle stored, diagonal is the last entry of the row
+        t.AddFlops (2*values.Size());
+        for (size_t i = 0; i < height; i++)
+          {
+            double sum = 0;
+            double sxi = s * px[i];
+            for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+              {
+                double val = values[j];
+                int col = colnr[j];
+                sum += val * px[col];
+                if (col != int(i))
+                  fy(col) += val * sxi;
+              }
+            fy(i) += s * sum;
+          }
+        return;
+      }
+
+    t.AddFlops (values.Size());
+    ParallelForRange
+      (balance, [&] (IntRange r)
+       {
+         for (size_t row : r)
+           fy(row) += s * RowTimesVector (row, px);
+       });
+  }
+
+
+  template <typename TSTORE>
+  void SparseMatrixMixed<TSTORE> :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    if (symmetric)
+      {
+        MultAdd (s, x, y);
+        return;
+      }
+
+    static Timer t(string("SparseMatrixMixed<") + (sizeof(TSTORE)==4 ? "float" : "bf16") + ">::MultTransAdd");
+    RegionTimer reg(t);
+    t.AddFlops (values.Size());
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fy = y.FVDouble();
+
+    for (size_t i = 0; i < height; i++)
+      {
+        double sxi = s * fx(i);
+        for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+          fy(colnr[j]) += double(values[j]) * sxi;
+      }
+  }
+
+
+  template <typename TSTORE>
+  ostream & SparseMatrixMixed<TSTORE> :: Print (ostream & ost) const
+  {
+    ost << "mixed precision matrix, storage = " << sizeof(TSTORE) << " bytes, h = " << height
+        << ", w = " << width << ", nze = " << values.Size()
+        << (symmetric ? ", symmetric" : "") << endl;
+    for (size_t i = 0; i < height; i++)
+      {
+        ost << "Row " << i << ":";
+        for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+          ost << "   " << colnr[j] << ": " << float(values[j]);
+        ost << "\n";
+      }
+    return ost;
+  }
+
+
+  template <typename TSTORE>
+  void SparseMatrixMixed<TSTORE> :: MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+  {
+    mu.Append (new MemoryUsageStruct ("SparseMatrixMixed", values.Size()*(sizeof(TSTORE)+sizeof(int)), 1));
+  }
+
+
+  template class SparseMatrixMixed<float>;
+  template class SparseMatrixMixed<bfloat16>;
+}
@@ -0,0 +1,93 @@
+#ifndef FILE_NGS_SPARSEMATRIX_MIXED
+#define FILE_NGS_SPARSEMATRIX_MIXED
+
+/**************************************************************************/
+/* File:   sparsematrix_mixed.hpp                                         */
+/* Date:   18. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     brain floating point: the upper 16 bits of a float.
+     Only used as storage format, arithmetic is done in float/double.
+  */
+  class bfloat16
+  {
+    uint16_t bits;
+  public:
+    bfloat16 () = default;
+    /// round to nearest even, NaN stays a (quiet) NaN
+    bfloat16 (float f)
+    {
+      uint32_t u;
+      memcpy (&u, &f, sizeof(u));
+      if ((u & 0x7fffffff) > 0x7f800000)
+        {
+          bits = (u >> 16) | 0x0040;
+          return;
+        }
+      u += 0x7fff + ((u >> 16) & 1);
+      bits = u >> 16;
+    }
+    operator float () const
+    {
+      uint32_t u = uint32_t(bits) << 16;
+      float f;
+      memcpy (&f, &u, sizeof(f));
+      return f;
+    }
+  };
+
+
+  /**
+     Sparse matrix with values stored in reduced precision (float or
+     bfloat16), products are accumulated in double.
+
+     Created from a SparseMatrix<double>, shares the sparsity pattern
+     layout (symmetric matrices stay in lower-triangular storage).
+     Intended as inner operator or preconditioner, combine with
+     IterativeRefinementSolver to get double precision results.
+  */
+  template <typename TSTORE>
+  class NGS_DLL_HEADER SparseMatrixMixed : public S_BaseMatrix<double>
+  {
+    size_t height, width;
+    bool symmetric;
+    Array<size_t> firsti;
+    Array<int> colnr;
+    Array<TSTORE> values;
+    /// balancing for multi-threading
+    Partitioning balance;
+
+  public:
+    SparseMatrixMixed (const SparseMatrix<double> & mat);
+
+    virtual int VHeight() const override { return height; }
+    virtual int VWidth() const override { return width; }
+    virtual size_t NZE () const override { return values.Size(); }
+    bool IsSymmetric () const { return symmetric; }
+
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
+
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual ostream & Print (ostream & ost) const override;
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const override;
+
+  private:
+    INLINE double RowTimesVector (size_t row, const double * px) const
+    {
+      double sum = 0;
+      for (size_t j = firsti[row]; j < firsti[row+1]; j++)
+        sum += double(values[j]) * px[colnr[j]];
+      return sum;
+    }
+  };
+
+}
+
+#endif
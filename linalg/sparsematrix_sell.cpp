@@ -0,0 +1,209 @@
+/*********************************************************************/
+/* File:   sparsematrix_sell.cpp                                     */
+/* Date:   18. Oct. 2026                                             */
+/*********************************************************************/
+
+/*
+   sparse matrix in SELL-C-sigma format
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  // load x[ind[0]], ..., x[ind[C-1]]
+  INLINE SIMD<double> GatherSIMD (const double * x, const int * ind)
+  {
+#if defined __AVX512F__
+    return _mm512_i32gather_pd (_mm256_loadu_si256((const __m256i*)ind), x, 8);
+#elif defined __AVX2__
+    return _mm256_i32gather_pd (x, _mm_loadu_si128((const __m128i*)ind), 8);
+#else
+    return SIMD<double> ([x,ind] (int i) { return x[ind[i]]; });
+#endif
+  }
+
+
+  SparseMatrixSELL :: SparseMatrixSELL (const SparseMatrix<double> & mat, int sigma)
+  {
+    static Timer t("SparseMatrixSELL - ctor"); RegionTimer reg(t);
+
+    height = mat.Height();
+    width = mat.Width();
+    sigma = max2(C, (sigma/C)*C);
+
+    // rows of the full matrix, symmetric matrices store only the lower part
+    bool symmetric = dynamic_cast<const SparseMatrixSymmetric<double>*> (&mat) != nullptr;
+    Array<int> cnt(height);
+    for (size_t i = 0; i < height; i++)
+      cnt[i] = mat.GetRowIndices(i).Size();
+    if (symmetric)
+      for (size_t i = 0; i < height; i++)
+        for (int j : mat.GetRowIndices(i))
+          if (j != int(i)) cnt[j]++;
+
+    Table<int> rowcols(cnt);
+    Table<double> rowvals(cnt);
+    cnt = 0;
+    for (size_t i = 0; i < height; i++)
+      {
+        auto ind = mat.GetRowIndices(i);
+        auto vals = mat.GetRowValues(i);
+        for (size_t k = 0; k < ind.Size(); k++)
+          {
+            rowcols[i][cnt[i]] = ind[k];
+            rowvals[i][cnt[i]++] = vals(k);
+            if (symmetric && ind[k] != int(i))
+              {
+                int j = ind[k];
+                rowcols[j][cnt[j]] = i;
+                rowvals[j][cnt[j]++] = vals(k);
+              }
+          }
+      }
+
+    nze = 0;
+    for (size_t i = 0; i < height; i++)
+      nze += cnt[i];
+
+    // sort rows by length within windows of sigma rows
+    size_t nchunks = (height+C-1) / C;
+    rownr.SetSize (nchunks*C);
+    for (size_t i = 0; i < rownr.Size(); i++)
+      rownr[i] = (i < height) ? int(i) : -1;
+    for (size_t first = 0; first < height; first += sigma)
+      {
+        size_t next = min2(first+sigma, height);
+        // keep original order for equal length, for locality in x
+        QuickSort (rownr.Range(first, next),
+                   [&] (int a, int b) { return cnt[a] > cnt[b] || (cnt[a] == cnt[b] && a < b); });
+      }
+
+    chunk_first.SetSize (nchunks+1);
+    chunk_len.SetSize (nchunks);
+    chunk_first[0] = 0;
+    for (size_t c = 0; c < nchunks; c++)
+      {
+        int len = 0;
+        for (int l = 0; l < C; l++)
+          if (rownr[c*C+l] != -1)
+            len = max2(len, cnt[rownr[c*C+l]]);
+        chunk_len[c] = len;
+        chunk_first[c+1] = chunk_first[c] + size_t(len)*C;
+      }
+
+    // padding entries multiply x[0] by 0
+    colnr.SetSize (chunk_first[nchunks]);
+    values.SetSize (chunk_first[nchunks]);
+    ParallelFor (Range(nchunks), [&] (size_t c)
+                 {
+                   for (int l = 0; l < C; l++)
+                     {
+                       int row = rownr[c*C+l];
+                       int len = (row != -1) ? cnt[row] : 0;
+                       for (int j = 0; j < chunk_len[c]; j++)
+                         {
+                           size_t pos = chunk_first[c] + j*C + l;
+                           colnr[pos] = (j < len) ? rowcols[row][j] : 0;
+                           values[pos] = (j < len) ? rowvals[row][j] : 0.0;
+                         }
+                     }
+                 });
+
+    balance.Calc (nchunks, [&] (size_t c) { return 5 + C*chunk_len[c]; });
+  }
+
+
+  AutoVector SparseMatrixSELL :: CreateRowVector () const
+  {
+    return make_shared<VVector<double>> (width);
+  }
+
+  AutoVector SparseMatrixSELL :: CreateColVector () const
+  {
+    return make_shared<VVector<double>> (height);
+  }
+
+
+  void SparseMatrixSELL :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    const double * px = x.FVDouble().Addr(0);
+    FlatVector<double> fy = y.FVDouble();
+
+    ParallelForRange
+      (balance, [&] (IntRange r)
+       {
+         for (size_t c : r)
+           {
+             SIMD<double> sum(0.0);
+             const int * pcol = colnr.Addr(chunk_first[c]);
+             const double * pval = values.Addr(chunk_first[c]);
+             for (int j = 0; j < chunk_len[c]; j++, pcol += C, pval += C)
+               sum += SIMD<double>(pval) * GatherSIMD(px, pcol);
+
+             for (int l = 0; l < C; l++)
+               {
+                 int row = rownr[c*C+l];
+                 if (row != -1)
+                   fy(row) += s * sum[l];
+               }
+           }
+       });
+  }
+
+
+  void SparseMatrixSELL :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    FlatVector<double> fx = x.FVDouble();
+    FlatVector<double> fy = y.FVDouble();
+
+    for (size_t c = 0; c < chunk_len.Size(); c++)
+      for (int l = 0; l < C; l++)
+        {
+          int row = rownr[c*C+l];
+          if (row == -1) continue;
+          double sx = s * fx(row);
+          for (int j = 0; j < chunk_len[c]; j++)
+            {
+              size_t pos = chunk_first[c] + j*C + l;
+              fy(colnr[pos]) += values[pos] * sx;
+            }
+        }
+  }
+
+
+  ostream & SparseMatrixSELL :: Print (ostream & ost) const
+  {
+    ost << "SELL-" << C << " matrix, h = " << height << ", w = " << width
+        << ", nze = " << nze << ", padded = " << values.Size() << endl;
+    for (size_t c = 0; c < chunk_len.Size(); c++)
+      for (int l = 0; l < C; l++)
+        {
+          int row = rownr[c*C+l];
+          if (row == -1) continue;
+          ost << "Row " << row << ":";
+          for (int j = 0; j < chunk_len[c]; j++)
+            {
+              size_t pos = chunk_first[c] + j*C + l;
+              if (values[pos] != 0.0)
+                ost << "   " << colnr[pos] << ": " << values[pos];
+            }
+          ost << "\n";
+        }
+    return ost;
+  }
+
+
+  void SparseMatrixSELL :: MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+  {
+    mu.Append (new MemoryUsageStruct ("SparseMatrixSELL", values.Size()*(sizeof(double)+sizeof(int)), 1));
+  }
+
+}
@@ -0,0 +1,62 @@
+#ifndef FILE_NGS_SPARSEMATRIX_SELL
+#define FILE_NGS_SPARSEMATRIX_SELL
+
+/**************************************************************************/
+/* File:   sparsematrix_sell.hpp                                          */
+/* Date:   18. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Sparse matrix in SELL-C-sigma (sliced ELLPACK) storage.
+
+     Rows are grouped into chunks of C = SIMD<double>::Size() rows. The
+     entries of a chunk are stored column by column, such that one SIMD
+     register processes one entry of C rows. Within windows of sigma rows,
+     rows are sorted by length to minimize the padding of the chunks.
+
+     Created from a SparseMatrix<double> (symmetric matrices are expanded),
+     provides MultAdd and MultTransAdd only.
+  */
+  class NGS_DLL_HEADER SparseMatrixSELL : public S_BaseMatrix<double>
+  {
+    size_t height, width;
+    size_t nze;
+    /// number of rows per chunk
+    static constexpr int C = SIMD<double>::Size();
+    /// first entry of chunk
+    Array<size_t> chunk_first;
+    /// padded row length of chunk
+    Array<int> chunk_len;
+    /// original row of chunk row, -1 for padding rows
+    Array<int> rownr;
+    /// column numbers, C entries per column of a chunk
+    Array<int> colnr;
+    Array<double> values;
+    /// balancing for multi-threading
+    Partitioning balance;
+
+  public:
+    SparseMatrixSELL (const SparseMatrix<double> & mat, int sigma = 256);
+
+    virtual int VHeight() const override { return height; }
+    virtual int VWidth() const override { return width; }
+    virtual size_t NZE () const override { return nze; }
+    /// including padding
+    size_t NZEPadded () const { return values.Size(); }
+
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
+
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual ostream & Print (ostream & ost) const override;
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const override;
+  };
+
+}
+
+#endif
@@ -15,6 +15,8 @@ namespace ngla
     TSCAL * pdata;
     int es;
     bool ownmem;
+    /// keeps a mapped archive alive which pdata refers to
+    shared_ptr<void> mapped_memory;
     
   public:
     S_BaseVectorPtr (size_t as, int aes, void * adata) throw()
@@ -41,6 +43,7 @@ namespace ngla
       this->size = as;
       pdata = new TSCAL[as*es];
       ownmem = true;
+      mapped_memory = nullptr;
     }
 
     void AssignMemory (size_t as, void * adata)
@@ -59,6 +62,9 @@ namespace ngla
       return pdata; 
     }
     
+    /// restores without copy from a mapped archive
+    NGS_DLL_HEADER virtual void DoArchive (Archive & ar);
+
     NGS_DLL_HEADER virtual AutoVector Range (size_t begin, size_t end) const;
     NGS_DLL_HEADER virtual AutoVector Range (T_Range<size_t> range) const;
 
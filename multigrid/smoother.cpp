@@ -151,6 +151,70 @@ namespace ngmg
 
 
 
+  ChebyshevSmoother :: 
+  ChebyshevSmoother  (const MeshAccess & ama,
+		      const BilinearForm & abiform, const Flags & aflags)
+    : Smoother(aflags), biform(abiform)
+  {
+    degree = int (flags.GetNumFlag ("chebyshevdegree", 3));
+    ratio = flags.GetNumFlag ("chebyshevratio", 10);
+    lanczossteps = int (flags.GetNumFlag ("lanczossteps", 10));
+    Update();
+  }
+
+  void ChebyshevSmoother :: Update (bool force_update)
+  {
+    static Timer t("ChebyshevSmoother::Update"); RegionTimer reg(t);
+    jac.SetSize (biform.GetNLevels());
+    lmax.SetSize (biform.GetNLevels());
+    for (int i = 0; i < biform.GetNLevels(); i++)
+      {
+        jac[i] = nullptr;
+        lmax[i] = 0;
+        if (!biform.GetMatrixPtr(i)) continue;
+
+        const BaseMatrix & mat = biform.GetMatrix(i);
+        if (mat.IsComplex())
+          throw Exception ("ChebyshevSmoother: complex matrices not supported");
+        jac[i] = dynamic_cast<const BaseSparseMatrix&> (mat)
+          .CreateJacobiPrecond(biform.GetFESpace()->GetFreeDofs());
+        // Lanczos underestimates
+        lmax[i] = 1.1 * EstimateMaxEigenvalue (mat, *jac[i], lanczossteps);
+      }
+  }
+
+  void ChebyshevSmoother :: PreSmooth (int level, BaseVector & u, 
+				       const BaseVector & f, int steps) const
+  {
+    static Timer t("ChebyshevSmoother::Smooth"); RegionTimer reg(t);
+    if (lmax[level] == 0) return;
+    ChebyshevSmooth (biform.GetMatrix(level), *jac[level], lmax[level], ratio, degree,
+                     u, f, steps);
+  }
+
+  void ChebyshevSmoother :: PostSmooth (int level, BaseVector & u, 
+					const BaseVector & f, int steps) const
+  {
+    // the polynomial smoother is symmetric
+    PreSmooth (level, u, f, steps);
+  }
+
+  void ChebyshevSmoother :: 
+  Residuum (int level, BaseVector & u, 
+	    const BaseVector & f, BaseVector & d) const
+  {
+    d = f - biform.GetMatrix(level) * u;
+  }
+  
+  AutoVector ChebyshevSmoother :: CreateVector(int level) const
+  {
+    return biform.GetMatrix(level).CreateVector();
+  }
+
+
+
+
+
   AnisotropicSmoother :: 
   AnisotropicSmoother  (const MeshAccess & ama,
 			const BilinearForm & abiform)
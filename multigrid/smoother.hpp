@@ -120,6 +120,48 @@ namespace ngmg
   };
 
 
+  /**
+     Chebyshev-Jacobi smoother.
+     A polynomial in D^{-1} A damping the eigenvalues in [lmax/ratio, lmax].
+     The largest eigenvalue is estimated by Lanczos. Needs only matrix-vector
+     products and vector updates, thus no coloring.
+     Flags: chebyshevdegree, chebyshevratio, lanczossteps.
+  */
+  class ChebyshevSmoother : public Smoother
+  {
+    ///
+    const BilinearForm & biform;
+    ///
+    Array<shared_ptr<BaseJacobiPrecond>> jac;
+    /// estimated largest eigenvalue of D^{-1} A, per level
+    Array<double> lmax;
+    ///
+    int degree;
+    ///
+    double ratio;
+    ///
+    int lanczossteps;
+
+  public:
+    ///
+    ChebyshevSmoother (const MeshAccess & ama,
+                       const BilinearForm & abiform, const Flags & aflags);
+    ///
+    virtual void Update (bool force_update = 0);
+    ///
+    virtual void PreSmooth (int level, ngla::BaseVector & u, 
+			    const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void PostSmooth (int level, ngla::BaseVector & u, 
+			     const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void Residuum (int level, ngla::BaseVector & u, 
+			   const ngla::BaseVector & f, ngla::BaseVector & d) const;
+    ///
+    virtual AutoVector CreateVector(int level) const;
+  };
+
+
   /**
      Anisotropic smoother.
      Common relaxation of vertically aligned nodes.
@@ -6,6 +6,13 @@
 
 #include <ngstd.hpp>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 namespace ngstd
 {
@@ -220,6 +227,137 @@ namespace ngstd
 
   
 
+  /* ******************* MappedOutArchive ******************* */
+
+  static const char mapped_archive_magic[8] = { 'N', 'G', 'S', 'M', 'A', 'P', '0', '1' };
+
+  MappedOutArchive :: MappedOutArchive (string filename)
+    : Archive(true), fout(make_shared<ofstream>(filename.c_str(), ios::binary))
+  {
+    if (!*fout)
+      throw Exception ("MappedOutArchive: cannot open file " + filename);
+    WriteBytes (mapped_archive_magic, sizeof(mapped_archive_magic));
+  }
+
+  void MappedOutArchive :: WriteBytes (const void * p, size_t n)
+  {
+    fout->write (static_cast<const char*> (p), n);
+    pos += n;
+  }
+
+  Archive & MappedOutArchive :: operator & (string & str)
+  {
+    size_t len = str.length();
+    WriteBytes (&len, sizeof(len));
+    WriteBytes (str.data(), len);
+    return *this;
+  }
+
+  Archive & MappedOutArchive :: operator & (char *& str)
+  {
+    size_t len = strlen (str);
+    WriteBytes (&len, sizeof(len));
+    WriteBytes (str, len);
+    return *this;
+  }
+
+  Archive & MappedOutArchive :: DoBulk (void * p, size_t n)
+  {
+    // pad to the alignment, such that the section can be used in place
+    char zeros[ALIGNMENT] = { 0 };
+    WriteBytes (zeros, (ALIGNMENT - pos % ALIGNMENT) % ALIGNMENT);
+    WriteBytes (p, n);
+    return *this;
+  }
+
+
+  /* ******************* MappedInArchive ******************* */
+
+  MappedInArchive :: MappedInArchive (string filename)
+    : Archive(false)
+  {
+#ifndef WIN32
+    int fd = open (filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw Exception ("MappedInArchive: cannot open file " + filename);
+    struct stat st;
+    fstat (fd, &st);
+    filesize = st.st_size;
+    if (filesize < sizeof(mapped_archive_magic))
+      {
+        close (fd);
+        throw Exception ("MappedInArchive: " + filename + " is not a mapped archive");
+      }
+
+    // private mapping: restored objects may modify their data, touched
+    // pages are copied on write and the file is never changed
+    void * ptr = mmap (nullptr, filesize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (ptr == MAP_FAILED)
+      throw Exception ("MappedInArchive: cannot map file " + filename);
+    size_t size = filesize;
+    mapping = shared_ptr<void> (ptr, [size] (void * p) { munmap (p, size); });
+#else
+    ifstream in(filename, ios::binary | ios::ate);
+    if (!in)
+      throw Exception ("MappedInArchive: cannot open file " + filename);
+    filesize = in.tellg();
+    if (filesize < sizeof(mapped_archive_magic))
+      throw Exception ("MappedInArchive: " + filename + " is not a mapped archive");
+    in.seekg (0);
+    void * ptr = _aligned_malloc (filesize, MappedOutArchive::ALIGNMENT);
+    in.read (static_cast<char*> (ptr), filesize);
+    mapping = shared_ptr<void> (ptr, [] (void * p) { _aligned_free (p); });
+#endif
+    base = static_cast<char*> (mapping.get());
+    if (memcmp (base, mapped_archive_magic, sizeof(mapped_archive_magic)) != 0)
+      throw Exception ("MappedInArchive: " + filename + " is not a mapped archive");
+    pos = sizeof(mapped_archive_magic);
+  }
+
+  char * MappedInArchive :: Take (size_t n)
+  {
+    if (pos + n > filesize)
+      throw Exception ("MappedInArchive: read beyond end of file");
+    char * p = base + pos;
+    pos += n;
+    return p;
+  }
+
+  Archive & MappedInArchive :: operator & (string & str)
+  {
+    size_t len;
+    Read (len);
+    str.assign (Take (len), len);
+    return *this;
+  }
+
+  Archive & MappedInArchive :: operator & (char *& str)
+  {
+    size_t len;
+    Read (len);
+    str = new char[len+1];
+    memcpy (str, Take (len), len);
+    str[len] = '\0';
+    return *this;
+  }
+
+  void * MappedInArchive :: MapBulk (size_t n)
+  {
+    size_t align = MappedOutArchive::ALIGNMENT;
+    pos = (pos + align-1) / align * align;
+    return Take (n);
+  }
+
+  Archive & MappedInArchive :: DoBulk (void * p, size_t n)
+  {
+    char * src = static_cast<char*> (MapBulk (n));
+    if (n) memcpy (p, src, n);
+    return *this;
+  }
+
+
+
   /* ******************* TextOutArchive ******************* */
   
 
@@ -108,9 +108,79 @@ namespace ngstd
 
 
 
+  /*
+    Binary archive with 64-byte aligned bulk sections for arrays.
+    Read by the MappedInArchive, which maps the file into memory
+    and restores bulk data without parsing and copying.
+   */
+  class MappedOutArchive : public Archive
+  {
+    shared_ptr<ostream> fout;
+    size_t pos = 0;
+  public:
+    enum { ALIGNMENT = 64 };
+    
+    MappedOutArchive (string filename);
+
+    virtual Archive & operator & (double & d) { return Write(d); }
+    virtual Archive & operator & (int & i) { return Write(i); }
+    virtual Archive & operator & (short & i) { return Write(i); }
+    virtual Archive & operator & (long & i) { return Write(i); }
+    virtual Archive & operator & (size_t & i) { return Write(i); }
+    virtual Archive & operator & (unsigned char & i) { return Write(i); }
+    virtual Archive & operator & (bool & b) { return Write(b); }
+    virtual Archive & operator & (string & str);
+    virtual Archive & operator & (char *& str);
+
+    virtual Archive & Do (double * d, size_t n) { return DoBulk (d, n*sizeof(double)); }
+    virtual Archive & Do (int * i, size_t n) { return DoBulk (i, n*sizeof(int)); }
+    virtual Archive & Do (long * i, size_t n) { return DoBulk (i, n*sizeof(long)); }
+    virtual Archive & Do (size_t * i, size_t n) { return DoBulk (i, n*sizeof(size_t)); }
+
+    virtual bool Mapped () const { return true; }
+    virtual Archive & DoBulk (void * p, size_t n);
 
+  private:
+    template <typename T>
+    Archive & Write (T x) { WriteBytes (&x, sizeof(T)); return *this; }
+    void WriteBytes (const void * p, size_t n);
+  };
 
 
+  class MappedInArchive : public Archive
+  {
+    shared_ptr<void> mapping;
+    char * base;
+    size_t filesize;
+    size_t pos = 0;
+  public:
+    MappedInArchive (string filename);
+
+    virtual Archive & operator & (double & d) { return Read(d); }
+    virtual Archive & operator & (int & i) { return Read(i); }
+    virtual Archive & operator & (short & i) { return Read(i); }
+    virtual Archive & operator & (long & i) { return Read(i); }
+    virtual Archive & operator & (size_t & i) { return Read(i); }
+    virtual Archive & operator & (unsigned char & i) { return Read(i); }
+    virtual Archive & operator & (bool & b) { return Read(b); }
+    virtual Archive & operator & (string & str);
+    virtual Archive & operator & (char *& str);
+
+    virtual Archive & Do (double * d, size_t n) { return DoBulk (d, n*sizeof(double)); }
+    virtual Archive & Do (int * i, size_t n) { return DoBulk (i, n*sizeof(int)); }
+    virtual Archive & Do (long * i, size_t n) { return DoBulk (i, n*sizeof(long)); }
+    virtual Archive & Do (size_t * i, size_t n) { return DoBulk (i, n*sizeof(size_t)); }
+
+    virtual bool Mapped () const { return true; }
+    virtual Archive & DoBulk (void * p, size_t n);
+    virtual void * MapBulk (size_t n);
+    virtual shared_ptr<void> GetMapping () const { return mapping; }
+
+  private:
+    template <typename T>
+    Archive & Read (T & x) { memcpy (&x, Take(sizeof(T)), sizeof(T)); return *this; }
+    char * Take (size_t n);
+  };
 
 
   
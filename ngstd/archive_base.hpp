@@ -56,6 +56,19 @@ namespace ngstd
     { for (size_t j = 0; j < n; j++) { (*this) & b[j]; }; return *this; };
 
 
+    /// archive with aligned bulk sections, which can be memory mapped for input
+    virtual bool Mapped () const { return false; }
+
+    /// write/read n bytes as one aligned bulk section
+    virtual Archive & DoBulk (void * p, size_t n)
+    { return Do (static_cast<unsigned char*> (p), n); }
+
+    /// pointer to the next bulk section within the mapped file, no copy
+    virtual void * MapBulk (size_t n) { return nullptr; }
+
+    /// mapped memory stays valid as long as a copy of this handle exists
+    virtual shared_ptr<void> GetMapping () const { return nullptr; }
+
     // nvirtual Archive & Do (string * str, size_t n)
     // { for (size_t j = 0; j < n; j++) { (*this) & str[j]; }; return *this; };
     // virtual Archive & operator & (char *& str) = 0;
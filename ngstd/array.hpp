@@ -1406,6 +1406,26 @@ namespace ngstd
     archive.Do (&a[0], a.Size());
     return archive;
   }
+
+  /*
+    Archive array as one aligned bulk section if the archive supports it.
+    Reading from a mapped archive lets the array refer to the mapped file
+    without copying, the caller keeps archive.GetMapping() alive.
+   */
+  template <typename T> 
+  Archive & DoMapped (Archive & archive, Array<T> & a)
+  {
+    if (!archive.Mapped())
+      return archive & a;
+
+    size_t size = a.Size();
+    archive & size;
+    if (archive.Output())
+      return archive.DoBulk (a.Size() ? &a[0] : nullptr, size*sizeof(T));
+
+    a = Array<T> (size, static_cast<T*> (archive.MapBulk (size*sizeof(T))));
+    return archive;
+  }
 }
 
 
@@ -5,6 +5,13 @@
 /**************************************************************************/
 
 #include <ngstd.hpp>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 /*
 #ifdef PARALLEL
 #include <mpi.h>
@@ -31,6 +38,101 @@ namespace ngstd
   size_t dummy_thread_flops[NgProfiler::SIZE];
   size_t * NgProfiler::thread_flops = dummy_thread_flops;
 
+  bool NgProfiler::use_hwcounters = false;
+  size_t NgProfiler::hwcounters[SIZE][NHWCOUNTERS];
+  size_t dummy_thread_hwcounters[NgProfiler::SIZE*NgProfiler::NHWCOUNTERS];
+  size_t * NgProfiler::thread_hwcounters = dummy_thread_hwcounters;
+
+
+#ifdef __linux__
+  // one perf_event group per thread, opened at first use
+  class ThreadHWCounters
+  {
+    int fd[NgProfiler::NHWCOUNTERS];
+    uint64_t ids[NgProfiler::NHWCOUNTERS];
+    int leader = -1;
+  public:
+    ThreadHWCounters ()
+    {
+      uint64_t config[NgProfiler::NHWCOUNTERS] =
+        { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+      for (int k = 0; k < NgProfiler::NHWCOUNTERS; k++)
+        {
+          perf_event_attr attr;
+          memset (&attr, 0, sizeof(attr));
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.size = sizeof(attr);
+          attr.config = config[k];
+          attr.exclude_kernel = 1;
+          attr.exclude_hv = 1;
+          attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+          fd[k] = syscall (__NR_perf_event_open, &attr, 0, -1, leader, 0);
+          if (k == 0) leader = fd[0];
+          if (leader == -1) break;
+          if (fd[k] == -1 || ioctl (fd[k], PERF_EVENT_IOC_ID, &ids[k]) == -1)
+            ids[k] = uint64_t(-1);
+        }
+    }
+
+    ~ThreadHWCounters ()
+    {
+      for (int k = NgProfiler::NHWCOUNTERS; k-- > 0; )
+        if (leader != -1 && fd[k] != -1) close (fd[k]);
+    }
+
+    bool Valid () const { return leader != -1; }
+
+    // false if the group of this thread could not be opened
+    bool Read (size_t * values)
+    {
+      for (int k = 0; k < NgProfiler::NHWCOUNTERS; k++)
+        values[k] = 0;
+      if (leader == -1) return false;
+
+      // layout: nr, { value, id } [nr]
+      uint64_t buf[1+2*NgProfiler::NHWCOUNTERS];
+      if (read (leader, buf, sizeof(buf)) < ssize_t(sizeof(uint64_t))) return false;
+
+      for (size_t i = 0; i < buf[0] && i < NgProfiler::NHWCOUNTERS; i++)
+        for (int k = 0; k < NgProfiler::NHWCOUNTERS; k++)
+          if (buf[2+2*i] == ids[k])
+            values[k] = buf[1+2*i];
+      return true;
+    }
+  };
+#endif
+
+  bool NgProfiler :: EnableHWCounters (bool enable)
+  {
+#ifdef __linux__
+    if (enable)
+      {
+        ThreadHWCounters test;
+        if (!test.Valid())
+          {
+            cerr << "hardware counters not available, check /proc/sys/kernel/perf_event_paranoid" << endl;
+            enable = false;
+          }
+      }
+    use_hwcounters = enable;
+#else
+    use_hwcounters = false;
+#endif
+    return use_hwcounters;
+  }
+
+  bool NgProfiler :: ReadHWCounters (size_t * values)
+  {
+#ifdef __linux__
+    thread_local ThreadHWCounters counters;
+    return counters.Read (values);
+#else
+    for (int k = 0; k < NHWCOUNTERS; k++)
+      values[k] = 0;
+    return false;
+#endif
+  }
+
   NgProfiler :: NgProfiler()
   {
     for (int i = 0; i < SIZE; i++)
@@ -38,6 +140,8 @@ namespace ngstd
 	tottimes[i] = 0;
 	usedcounter[i] = 0;
 	flops[i] = 0;
+        for (int k = 0; k < NHWCOUNTERS; k++)
+          hwcounters[i][k] = 0;
       }
 
     // total_timer = CreateTimer ("total CPU time");
@@ -131,6 +235,10 @@ namespace ngstd
 	    fprintf(prof,", MLoads = %6.2f",loads[i] / (double(tottimes[i])*fac) * 1e-6);
 	  if(stores[i])
 	    fprintf(prof,", MStores = %6.2f",stores[i] / (double(tottimes[i])*fac) * 1e-6);
+	  if(hwcounters[i][0])
+	    fprintf(prof,", cycles = %g, IPC = %4.2f, LLC misses = %g, GB/s = %6.2f",
+                    double(GetCycles(i)), double(GetInstructions(i))/GetCycles(i),
+                    double(GetLLCMisses(i)), GetBytes(i) / (double(tottimes[i])*fac) * 1e-9);
 	  if(usedcounter[i])
 	    fprintf(prof," %s",names[i].c_str());
 	  fprintf(prof,"\n");
@@ -172,6 +280,8 @@ namespace ngstd
           flops[i] = 0;
           loads[i] = 0;
           stores[i] = 0;
+          for (int k = 0; k < NHWCOUNTERS; k++)
+            hwcounters[i][k] = 0;
       }
   }
 
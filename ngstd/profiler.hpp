@@ -83,6 +83,12 @@ namespace ngstd
 
     NGS_DLL_HEADER static size_t * thread_times;
     NGS_DLL_HEADER static size_t * thread_flops;
+
+    /// hardware counters: cycles, instructions, last level cache misses
+    enum { NHWCOUNTERS = 3 };
+    NGS_DLL_HEADER static bool use_hwcounters;
+    NGS_DLL_HEADER static size_t hwcounters[SIZE][NHWCOUNTERS];
+    NGS_DLL_HEADER static size_t * thread_hwcounters;
   private:
 
     // int total_timer;
@@ -100,6 +106,28 @@ namespace ngstd
 
     NGS_DLL_HEADER static void Reset ();
 
+    /// use perf_event counters (Linux only), returns false if not available
+    NGS_DLL_HEADER static bool EnableHWCounters (bool enable = true);
+    /// current counter values of the calling thread,
+    /// returns false if the thread could not open its counters
+    NGS_DLL_HEADER static bool ReadHWCounters (size_t * values);
+
+    // threads without counters do not contribute to the sums
+    static void StartHWCounters (size_t * sum)
+    {
+      size_t values[NHWCOUNTERS];
+      if (!ReadHWCounters (values)) return;
+      for (int k = 0; k < NHWCOUNTERS; k++)
+        AsAtomic(sum[k]) -= values[k];
+    }
+
+    static void StopHWCounters (size_t * sum)
+    {
+      size_t values[NHWCOUNTERS];
+      if (!ReadHWCounters (values)) return;
+      for (int k = 0; k < NHWCOUNTERS; k++)
+        AsAtomic(sum[k]) += values[k];
+    }
 
 #ifndef NOPROFILE
 
@@ -114,6 +142,7 @@ namespace ngstd
       AsAtomic(tottimes[nr]) += -(time.tv_sec + 1e-6 * time.tv_usec);
       // #pragma omp atomic
       AsAtomic(counts[nr])++; 
+      if (use_hwcounters) StartHWCounters (hwcounters[nr]);
       VT_USER_START (const_cast<char*> (names[nr].c_str())); 
     }
 
@@ -124,17 +153,20 @@ namespace ngstd
       // tottimes[nr] += time.tv_sec + 1e-6 * time.tv_usec - starttimes[nr];
       // #pragma omp atomic
       AsAtomic(tottimes[nr]) += time.tv_sec + 1e-6 * time.tv_usec;
+      if (use_hwcounters) StopHWCounters (hwcounters[nr]);
       VT_USER_END (const_cast<char*> (names[nr].c_str())); 
     }
 
     static void StartThreadTimer (size_t nr, size_t tid)
     {
       thread_times[tid*SIZE+nr] -= __rdtsc();
+      if (use_hwcounters) StartHWCounters (&thread_hwcounters[(tid*SIZE+nr)*NHWCOUNTERS]);
     }
 
     static void StopThreadTimer (size_t nr, size_t tid)
     {
       thread_times[tid*SIZE+nr] += __rdtsc();
+      if (use_hwcounters) StopHWCounters (&thread_hwcounters[(tid*SIZE+nr)*NHWCOUNTERS]);
     }
 
     static void AddThreadFlops (size_t nr, size_t tid, size_t flops)
@@ -148,6 +180,7 @@ namespace ngstd
     static void StartTimer (int nr) 
     {
       starttimes[nr] = clock(); counts[nr]++; 
+      if (use_hwcounters) StartHWCounters (hwcounters[nr]);
       VT_USER_START (const_cast<char*> (names[nr].c_str())); 
     }
 
@@ -155,17 +188,20 @@ namespace ngstd
     static void StopTimer (int nr) 
     { 
       tottimes[nr] += clock()-starttimes[nr]; 
+      if (use_hwcounters) StopHWCounters (hwcounters[nr]);
       VT_USER_END (const_cast<char*> (names[nr].c_str())); 
     }
 
     static void StartThreadTimer (size_t nr, size_t tid)
     {
       thread_times[tid*SIZE+nr] -= __rdtsc();
+      if (use_hwcounters) StartHWCounters (&thread_hwcounters[(tid*SIZE+nr)*NHWCOUNTERS]);
     }
 
     static void StopThreadTimer (size_t nr, size_t tid)
     {
       thread_times[tid*SIZE+nr] += __rdtsc();
+      if (use_hwcounters) StopHWCounters (&thread_hwcounters[(tid*SIZE+nr)*NHWCOUNTERS]);
     }
 
     static void AddThreadFlops (size_t nr, size_t tid, size_t flops)
@@ -225,6 +261,12 @@ namespace ngstd
       return flops[nr];
     }
 
+    static size_t GetCycles (int nr) { return hwcounters[nr][0]; }
+    static size_t GetInstructions (int nr) { return hwcounters[nr][1]; }
+    static size_t GetLLCMisses (int nr) { return hwcounters[nr][2]; }
+    /// memory traffic estimated from last level cache misses
+    static size_t GetBytes (int nr) { return 64*hwcounters[nr][2]; }
+
     /// change name
     static void SetName (int nr, const string & name) { names[nr] = name; }
     static string GetName (int nr) { return names[nr]; }
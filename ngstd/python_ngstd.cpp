@@ -420,12 +420,24 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
                  timer["counts"] = py::int_(NgProfiler::GetCounts(i));
                  timer["flops"] = py::int_(NgProfiler::GetFlops(i));
                  timer["Gflop/s"] = py::float_(NgProfiler::GetFlops(i)/NgProfiler::GetTime(i)*1e-9);
+                 if (NgProfiler::GetCycles(i))
+                   {
+                     timer["cycles"] = py::int_(NgProfiler::GetCycles(i));
+                     timer["instructions"] = py::int_(NgProfiler::GetInstructions(i));
+                     timer["llc_misses"] = py::int_(NgProfiler::GetLLCMisses(i));
+                     timer["bytes"] = py::int_(NgProfiler::GetBytes(i));
+                     timer["GB/s"] = py::float_(NgProfiler::GetBytes(i)/NgProfiler::GetTime(i)*1e-9);
+                   }
                  timers.append(timer);
                }
 	     return timers;
 	   }
 	   );
 
+  m.def("EnableHardwareCounters", &NgProfiler::EnableHWCounters,
+        py::arg("enable")=true,
+        "Record cycles, instructions and last level cache misses per timer (Linux perf_event), returns False if not available");
+
   py::class_<Archive, shared_ptr<Archive>> (m, "Archive")
       /*
     .def("__init__", [](const string & filename, bool write,
@@ -446,8 +458,14 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
                            })
       */
       .def(py::init<> ([](const string & filename, bool write,
-                          bool binary) -> shared_ptr<Archive>
+                          bool binary, bool mapped) -> shared_ptr<Archive>
                        {
+                         if (mapped) {
+                           if (write)
+                             return make_shared<MappedOutArchive> (filename);
+                           else
+                             return make_shared<MappedInArchive> (filename);
+                         }
                          if(binary) {
                            if (write)
                              return make_shared<BinaryOutArchive> (filename);
@@ -460,7 +478,8 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
                            else
                              return make_shared<TextInArchive> (filename);
                          }
-                       }))
+                       }), py::arg("filename"), py::arg("write"), py::arg("binary"),
+           py::arg("mapped")=false)
     .def("__and__" , [](shared_ptr<Archive> & self, Array<int> & a) 
                                          { cout << "output array" << endl;
                                            *self & a; return self; })
@@ -475,6 +494,8 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
           ;
 
   m.def("SetNumThreads", &TaskManager::SetNumThreads );
+  m.def("SetWorkStealing", &TaskManager::SetWorkStealing, py::arg("use")=true,
+        "use per-thread work-stealing deques for parallel jobs, allows nested parallelism");
 
   // local TaskManager class to be used as context manager in Python
   class ParallelContextManager {
@@ -18,6 +18,7 @@ namespace ngstd
 {
   TaskManager * task_manager = nullptr;
   bool TaskManager :: use_paje_trace = false;
+  bool TaskManager :: use_work_stealing = getenv("NGS_WORK_STEALING") ? atoi(getenv("NGS_WORK_STEALING")) != 0 : false;
   int TaskManager :: max_threads = getenv("NGS_NUM_THREADS") ? atoi(getenv("NGS_NUM_THREADS")) : std::thread::hardware_concurrency();
   int TaskManager :: num_threads = 1;
 
@@ -53,6 +54,96 @@ namespace ngstd
   
   static mutex copyex_mutex;
 
+
+
+  /*
+    Work-stealing backend:
+
+    Every thread owns a (Chase-Lev) deque of task ranges. A job [0,ntasks)
+    is split recursively, the upper halves are pushed to the own deque
+    and processed later by the owner, or stolen from the top by idle
+    threads. Jobs created from inside a task are spawned the same way,
+    so nested parallelism is not serialized.
+  */
+
+  class WSJob
+  {
+  public:
+    const function<void(TaskInfo&)> * func;
+    int ntasks;
+    int jobnr;
+    atomic<int> pending;     // number of not yet finished tasks
+    Exception * ex = nullptr;
+  };
+
+  class WSTask
+  {
+  public:
+    WSJob * job;
+    int first, next;
+  };
+
+  class alignas(64) WSDeque : public AlignedAlloc<WSDeque>
+  {
+    static constexpr int64_t CAPACITY = 4096;   // power of 2
+    atomic<int64_t> top{0};
+    alignas(64) atomic<int64_t> bottom{0};
+    atomic<WSTask*> tasks[CAPACITY];
+  public:
+    // owner only, returns false if deque is full
+    bool Push (WSTask * task)
+    {
+      int64_t b = bottom.load(memory_order_relaxed);
+      int64_t t = top.load(memory_order_acquire);
+      if (b-t >= CAPACITY) return false;
+      tasks[b & (CAPACITY-1)].store(task, memory_order_relaxed);
+      atomic_thread_fence(memory_order_release);
+      bottom.store(b+1, memory_order_relaxed);
+      return true;
+    }
+
+    // owner only, LIFO end
+    WSTask * Pop ()
+    {
+      int64_t b = bottom.load(memory_order_relaxed)-1;
+      bottom.store(b, memory_order_relaxed);
+      atomic_thread_fence(memory_order_seq_cst);
+      int64_t t = top.load(memory_order_relaxed);
+      if (t > b)
+        {
+          bottom.store(b+1, memory_order_relaxed);
+          return nullptr;
+        }
+      WSTask * task = tasks[b & (CAPACITY-1)].load(memory_order_relaxed);
+      if (t == b)
+        {
+          // last entry, race against thieves
+          if (!top.compare_exchange_strong(t, t+1, memory_order_seq_cst, memory_order_relaxed))
+            task = nullptr;
+          bottom.store(b+1, memory_order_relaxed);
+        }
+      return task;
+    }
+
+    // any thread, FIFO end
+    WSTask * Steal ()
+    {
+      int64_t t = top.load(memory_order_acquire);
+      atomic_thread_fence(memory_order_seq_cst);
+      int64_t b = bottom.load(memory_order_acquire);
+      if (t >= b) return nullptr;
+      WSTask * task = tasks[t & (CAPACITY-1)].load(memory_order_relaxed);
+      if (!top.compare_exchange_strong(t, t+1, memory_order_seq_cst, memory_order_relaxed))
+        return nullptr;
+      return task;
+    }
+  };
+
+  static WSDeque * ws_deques = nullptr;
+  static atomic<int> ws_active_jobs{0};
+  static atomic<int> ws_jobnr{0};
+  static thread_local WSJob * ws_current_job = nullptr;
+
   int EnterTaskManager ()
   {
     if (task_manager)
@@ -117,6 +208,17 @@ namespace ngstd
     }
 
 
+  void TaskManager :: SetWorkStealing (bool use)
+  {
+    if (ws_active_jobs > 0 || (task_manager && func))
+      {
+        cerr << "Warning: can't switch work-stealing while a job is running!" << endl;
+        return;
+      }
+    use_work_stealing = use;
+  }
+
+
   TaskManager :: TaskManager()
     {
       num_threads = GetMaxThreads();
@@ -182,6 +284,8 @@ namespace ngstd
   {
     done = false;
 
+    ws_deques = new WSDeque[num_threads];
+
     for (int i = 1; i < num_threads; i++)
       {
         std::thread([this,i]() { this->Loop(i); }).detach();
@@ -195,12 +299,16 @@ namespace ngstd
     NgProfiler::thread_flops = new size_t[alloc_size];
     for (size_t i = 0; i < alloc_size; i++)
       NgProfiler::thread_flops[i] = 0;
+    NgProfiler::thread_hwcounters = new size_t[NgProfiler::NHWCOUNTERS*alloc_size];
+    for (size_t i = 0; i < NgProfiler::NHWCOUNTERS*alloc_size; i++)
+      NgProfiler::thread_hwcounters[i] = 0;
 
     while (active_workers < num_threads-1)
       ;
   }
   extern size_t dummy_thread_times[NgProfiler::SIZE];
   extern size_t dummy_thread_flops[NgProfiler::SIZE];
+  extern size_t dummy_thread_hwcounters[NgProfiler::SIZE*NgProfiler::NHWCOUNTERS];
 
   static size_t calibrate_init_tsc = __rdtsc();
   typedef std::chrono::system_clock TClock;
@@ -221,14 +329,21 @@ namespace ngstd
           if (!NgProfiler::usedcounter[j]) break;
           NgProfiler::tottimes[j] += 1.0/frequ * NgProfiler::thread_times[i*NgProfiler::SIZE+j];
           NgProfiler::flops[j] += NgProfiler::thread_flops[i*NgProfiler::SIZE+j];
+          for (int k = 0; k < NgProfiler::NHWCOUNTERS; k++)
+            NgProfiler::hwcounters[j][k] += NgProfiler::thread_hwcounters[(i*NgProfiler::SIZE+j)*NgProfiler::NHWCOUNTERS+k];
         }
     delete [] NgProfiler::thread_times;
     NgProfiler::thread_times = dummy_thread_times;
     delete [] NgProfiler::thread_flops;
     NgProfiler::thread_flops = dummy_thread_flops;
+    delete [] NgProfiler::thread_hwcounters;
+    NgProfiler::thread_hwcounters = dummy_thread_hwcounters;
     
     while (active_workers)
       ;
+
+    delete [] ws_deques;
+    ws_deques = nullptr;
   }
 
 
@@ -236,6 +351,12 @@ namespace ngstd
   void TaskManager :: CreateJob (const function<void(TaskInfo&)> & afunc,
                                  int antasks)
   {
+    if (use_work_stealing && num_threads > 1 && task_manager && !func)
+      {
+        CreateJobWorkStealing (afunc, antasks);
+        return;
+      }
+    
     if (num_threads == 1 || !task_manager || func)
       {
         if (startup_function) (*startup_function)();
@@ -324,6 +445,113 @@ namespace ngstd
 
     trace->StopJob();
   }
+
+
+
+  // execute tasks [first,next) of the job, push upper halves for thieves
+  static void WSExecute (WSTask * task, int thd, int nthreads,
+                         const function<void()> * startup_function,
+                         const function<void()> * cleanup_function)
+  {
+    WSJob & job = *task->job;
+    int first = task->first;
+    int next = task->next;
+    delete task;
+
+    WSDeque & mydeque = ws_deques[thd];
+    while (next-first > 1)
+      {
+        int mid = (first+next)/2;
+        WSTask * upper = new WSTask { &job, mid, next };
+        if (!mydeque.Push (upper))
+          {
+            delete upper;
+            break;
+          }
+        next = mid;
+      }
+
+    if (startup_function) (*startup_function)();
+
+    WSJob * outer_job = ws_current_job;
+    ws_current_job = &job;
+
+    TaskInfo ti;
+    ti.nthreads = nthreads;
+    ti.thread_nr = thd;
+    ti.ntasks = job.ntasks;
+    for (ti.task_nr = first; ti.task_nr < next; ti.task_nr++)
+      {
+        try
+          {
+            RegionTracer t(ti.thread_nr, job.jobnr, RegionTracer::ID_JOB, ti.task_nr);
+            (*job.func)(ti);
+          }
+        catch (Exception e)
+          {
+            lock_guard<mutex> guard(copyex_mutex);
+            if (!job.ex)
+              job.ex = new Exception (e);
+          }
+      }
+
+    ws_current_job = outer_job;
+
+    if (cleanup_function) (*cleanup_function)();
+
+    // job may be gone after this
+    job.pending.fetch_sub (next-first, memory_order_release);
+  }
+
+
+  void TaskManager :: CreateJobWorkStealing (const function<void(TaskInfo&)> & afunc,
+                                             int antasks)
+  {
+    bool toplevel = ws_current_job == nullptr;
+    int thd = thread_id;
+
+    WSJob job;
+    job.func = &afunc;
+    job.ntasks = antasks;
+    job.pending = antasks;
+    // nested jobs are traced as part of the outermost job
+    job.jobnr = toplevel ? ws_jobnr++ : ws_current_job->jobnr;
+
+    if (toplevel && thd == 0)
+      trace->StartJob(job.jobnr, afunc.target_type());
+
+    ws_active_jobs++;
+    WSExecute (new WSTask { &job, 0, antasks }, thd, num_threads,
+               startup_function, cleanup_function);
+
+    // Help with the remaining tasks of this job on my own deque. Tasks
+    // of enclosing jobs are not run here, they may rely on per-thread
+    // resources of the task we are nested in.
+    WSDeque & mydeque = ws_deques[thd];
+    while (job.pending.load(memory_order_acquire) > 0)
+      {
+        WSTask * task = mydeque.Pop();
+        if (task && task->job == &job)
+          WSExecute (task, thd, num_threads, startup_function, cleanup_function);
+        else
+          {
+            if (task) mydeque.Push (task);
+            _mm_pause();
+          }
+      }
+    ws_active_jobs--;
+
+    if (toplevel && thd == 0)
+      trace->StopJob();
+
+    if (job.ex)
+      {
+        Exception e(*job.ex);
+        delete job.ex;
+        throw e;
+      }
+  }
+
     
   void TaskManager :: Loop(int thd)
   {
@@ -374,6 +602,22 @@ namespace ngstd
 
         if (jobnr == jobdone)
           {
+            if (ws_active_jobs > 0)
+              {
+                // steal from the other threads, round robin
+                WSTask * task = nullptr;
+                for (int i = 1; i < thds && !task; i++)
+                  task = ws_deques[(thd+i) % thds].Steal();
+                if (task)
+                  {
+                    WSExecute (task, thd, thds, startup_function, cleanup_function);
+                    // process what was split off to my own deque
+                    while ( (task = ws_deques[thd].Pop()) )
+                      WSExecute (task, thd, thds, startup_function, cleanup_function);
+                    continue;
+                  }
+              }
+            
             // RegionTracer t(ti.thread_nr, tCASyield, ti.task_nr);            
             if(sleep)
               this_thread::sleep_for(chrono::microseconds(sleep_usecs));
@@ -544,6 +788,40 @@ namespace ngstd
     timings.push_back(make_tuple("ParallelJob 100 task/thread", time/steps*1e9));
 
     
+    bool prev_work_stealing = use_work_stealing;
+    use_work_stealing = true;
+    starttime = WallTime();
+    steps = 0;
+    do
+      {
+        for (size_t i = 0; i < 1000; i++)
+          ParallelJob ( [] (TaskInfo ti) { ; },
+                        TasksPerThread(100));
+        steps += 1000;
+        time = WallTime()-starttime;
+      }
+    while (time < maxtime);
+    timings.push_back(make_tuple("ParallelJob 100 task/thread, work-stealing", time/steps*1e9));
+
+    starttime = WallTime();
+    steps = 0;
+    do
+      {
+        for (size_t i = 0; i < 100; i++)
+          ParallelJob ( [] (TaskInfo ti)
+                        {
+                          ParallelJob ( [] (TaskInfo ti2) { ; },
+                                        TasksPerThread(1));
+                        },
+                        TasksPerThread(1));
+        steps += 100;
+        time = WallTime()-starttime;
+      }
+    while (time < maxtime);
+    timings.push_back(make_tuple("nested ParallelJob 1x1 task/thread, work-stealing", time/steps*1e9));
+    use_work_stealing = prev_work_stealing;
+
+    
     starttime = WallTime();
     steps = 0;
     do
@@ -73,6 +73,7 @@ namespace ngstd
 #endif
     
     static bool use_paje_trace;
+    static bool use_work_stealing;
   public:
     
     TaskManager();
@@ -97,6 +98,11 @@ namespace ngstd
     int GetNumNodes() const { return num_nodes; }
 
     static void SetPajeTrace (bool use)  { use_paje_trace = use; }
+
+    // distribute jobs via per-thread work-stealing deques,
+    // nested jobs are then executed in parallel as well
+    static void SetWorkStealing (bool use);
+    static bool GetWorkStealing () { return use_work_stealing; }
     
     NGS_DLL_HEADER static void CreateJob (const function<void(TaskInfo&)> & afunc, 
                     int antasks = task_manager->GetNumThreads());
@@ -109,6 +115,10 @@ namespace ngstd
     void Done() { done = true; }
     void Loop(int thread_num);
 
+  private:
+    static void CreateJobWorkStealing (const function<void(TaskInfo&)> & afunc, int antasks);
+  public:
+
     static list<tuple<string,double>> Timing ();
   };
 
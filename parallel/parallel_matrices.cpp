@@ -359,11 +359,74 @@ namespace ngla
     ; // delete &mat;
   }
 
+  template <typename TM>
+  static bool IsRowwiseSparseMatrix (const BaseMatrix & mat)
+  {
+    return typeid(mat) == typeid(SparseMatrix<TM>);
+  }
+
+  bool ParallelMatrix :: SplitRows () const
+  {
+    if (rows_split) return inner_rows != nullptr;
+    rows_split = true;
+
+    // MultAdd1 restricts to rows only for non-symmetric storage
+    const BaseMatrix & bmat = *mat;
+    if (! (IsRowwiseSparseMatrix<double> (bmat) ||
+           IsRowwiseSparseMatrix<Complex> (bmat) ||
+           IsRowwiseSparseMatrix<Mat<2> > (bmat) ||
+           IsRowwiseSparseMatrix<Mat<3> > (bmat) ||
+           IsRowwiseSparseMatrix<Mat<2,2,Complex> > (bmat) ||
+           IsRowwiseSparseMatrix<Mat<3,3,Complex> > (bmat)))
+      return false;
+
+    auto & graph = dynamic_cast<const BaseSparseMatrix&> (bmat);
+    size_t h = bmat.Height();
+    if (h != paralleldofs->GetNDofLocal() || size_t(bmat.Width()) != h)
+      return false;
+
+    static Timer t("ParallelMatrix::SplitRows");
+    RegionTimer reg(t);
+
+    inner_rows = make_shared<BitArray> (h);
+    interface_rows = make_shared<BitArray> (h);
+    inner_rows->Clear();
+    interface_rows->Clear();
+    
+    ParallelFor (h, [&] (size_t row)
+                 {
+                   bool inner = true;
+                   for (int col : graph.GetRowIndices(row))
+                     if (paralleldofs->GetDistantProcs(col).Size())
+                       inner = false;
+                   if (inner)
+                     inner_rows->Set(row);
+                   else
+                     interface_rows->Set(row);
+                 });
+    return true;
+  }
+
   void ParallelMatrix :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
-    x.Cumulate();
+    if (x.GetParallelStatus() != DISTRIBUTED || !SplitRows())
+      {
+        x.Cumulate();
+        y.Distribute();
+        mat->MultAdd (s, x, y);
+        return;
+      }
+
+    static Timer t("ParallelMatrix::MultAdd - overlapped");
+    RegionTimer reg(t);
+
+    // distributed values of non-interface dofs are already cumulated,
+    // so the interior rows don't have to wait for the exchange
+    x.StartCumulate();
     y.Distribute();
-    mat->MultAdd (s, x, y);
+    mat->MultAdd1 (s, x, y, inner_rows.get());
+    x.FinishCumulate();
+    mat->MultAdd1 (s, x, y, interface_rows.get());
   }
 
   void ParallelMatrix :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
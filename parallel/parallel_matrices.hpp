@@ -40,6 +40,12 @@ namespace ngla
   {
     shared_ptr<BaseMatrix> mat;
     // const ParallelDofs & pardofs;
+
+    /// rows not coupling to interface dofs, and the remaining rows
+    mutable shared_ptr<BitArray> inner_rows, interface_rows;
+    mutable bool rows_split = false;
+    /// interior rows can be applied while the exchange of x is in flight
+    bool SplitRows () const;
   public:
     ParallelMatrix (shared_ptr<BaseMatrix> amat, shared_ptr<ParallelDofs> apardofs);
     // : mat(*amat), pardofs(*apardofs) 
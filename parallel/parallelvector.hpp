@@ -23,6 +23,11 @@ namespace ngla
     mutable PARALLEL_STATUS status;
     shared_ptr<ParallelDofs> paralleldofs;    
 
+    /// requests of an interface exchange posted by StartCumulate
+    mutable Array<int> exprocs;
+    mutable Array<MPI_Request> sendrequest, recvrequest;
+    mutable bool cumulate_pending = false;
+
   public:
     ParallelBaseVector ()
     { ; }
@@ -69,6 +74,11 @@ namespace ngla
 
 
     virtual void Cumulate () const; 
+
+    /// post non-blocking interface exchange. Values must not be modified before FinishCumulate
+    virtual void StartCumulate () const;
+    /// complete the exchange and add up received values
+    virtual void FinishCumulate () const;
     
     virtual void Distribute() const = 0;
     // { cerr << "ERROR -- Distribute called for BaseVector, is not parallel" << endl; }
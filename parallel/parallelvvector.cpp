@@ -108,10 +108,20 @@ namespace ngla
 
   void ParallelBaseVector :: Cumulate () const
   {
-    if (status != DISTRIBUTED) return;
+    StartCumulate();
+    FinishCumulate();
+  }
+
+
+  void ParallelBaseVector :: StartCumulate () const
+  {
+    if (status != DISTRIBUTED || cumulate_pending) return;
     
+    static Timer t("ParallelBaseVector::StartCumulate");
+    RegionTimer reg(t);
+
     int ntasks = paralleldofs->GetNTasks();
-    Array<int> exprocs;
+    exprocs.SetSize0();
     for (int i = 0; i < ntasks; i++)
       if (paralleldofs -> GetExchangeDofs (i).Size())
 	exprocs.Append(i);
@@ -120,22 +130,38 @@ namespace ngla
     
     ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
     
-    Array<MPI_Request> sendrequest(nexprocs), recvrequest(nexprocs);
+    sendrequest.SetSize(nexprocs);
+    recvrequest.SetSize(nexprocs);
 
     for (int idest = 0; idest < nexprocs; idest ++ ) 
       constvec->ISend (exprocs[idest], sendrequest[idest] );
     for (int isender=0; isender < nexprocs; isender++)
       constvec -> IRecvVec (exprocs[isender], recvrequest[isender] );
-    
+
+    cumulate_pending = true;
+  }
+
+
+  void ParallelBaseVector :: FinishCumulate () const
+  {
+    if (!cumulate_pending) return;
+
+    static Timer t("ParallelBaseVector::FinishCumulate");
+    RegionTimer reg(t);
+
+    ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
+
+    // send buffer is the vector itself, must be free before adding
     MyMPI_WaitAll (sendrequest);
     
     // cumulate
-    for (int cntexproc=0; cntexproc < nexprocs; cntexproc++)
+    for (int cntexproc=0; cntexproc < exprocs.Size(); cntexproc++)
       {
 	int isender = MyMPI_WaitAny (recvrequest);
 	constvec->AddRecvValues(exprocs[isender]);
       } 
 
+    cumulate_pending = false;
     SetStatus(CUMULATED);
   }
 
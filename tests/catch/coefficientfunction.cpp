@@ -234,6 +234,21 @@ void TestCoefficientFunction(shared_ptr<CoefficientFunction> cf,
           WARN("SIMD not implemented");
         }
     }
+
+  SECTION("NonZeroPattern")
+    {
+      size_t dim = cf->Dimension();
+      Vector<bool> nz(dim), nzd(dim), nzdd(dim);
+      Vector<bool> c_nz(dim), c_nzd(dim), c_nzdd(dim);
+      cf->NonZeroPattern(ud, nz, nzd, nzdd);
+      c_cf_f->NonZeroPattern(ud, c_nz, c_nzd, c_nzdd);
+      for (size_t i = 0; i < dim; i++)
+        {
+          CHECK(nz(i) == c_nz(i));
+          CHECK(nzd(i) == c_nzd(i));
+          CHECK(nzdd(i) == c_nzdd(i));
+        }
+    }
 }
 
 
@@ -273,3 +288,5 @@ TEST_OPERATOR_COEFFICIENTFUNCTION(mat*xyz);
 
 auto longvec = MakeVectorialCoefficientFunction({x,y,z,x,y,z,z,x,y,x,x,x});
 // TEST_OPERATOR_COEFFICIENTFUNCTION(InnerProduct(longvec, longvec));
+// short-lived temporaries share slots in the compiled evaluation
+TEST_OPERATOR_COEFFICIENTFUNCTION((a*x+u)*(u*y+b) + (x*u+a)*(z*u));
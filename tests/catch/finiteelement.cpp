@@ -81,6 +81,7 @@ void TestFiniteElement(T fel)
                 {
                   SIMD_IntegrationRule simdir(fel.ElementType(),fel.Order());
                   Vector<SIMD<double>> simd_values(simdir.Size());
+                  simd_values = SIMD<double>(numeric_limits<double>::quiet_NaN());
 
                   try
                     {
@@ -90,6 +91,47 @@ void TestFiniteElement(T fel)
                         {
                           CHECK(L2Norm(values-avalues) < 1e-10);
                         }
+                      SECTION("SIMD padding", "[SIMD]")
+                        {
+                          // also the padding lanes are written
+                          FlatVector<> allvalues(simdir.Size()*SIMD<double>::Size(), (double*)&simd_values[0]);
+                          for (auto i : Range(values.Size(), allvalues.Size()))
+                            CHECK(std::isfinite(allvalues[i]));
+                        }
+                    }
+                  catch(Exception ex)
+                    {
+                      CHECK_THROWS_AS(throw ex, ExceptionNOSIMD);
+                      WARN("SIMD not implemented");
+                    }
+                }
+            }
+
+          SECTION ("EvaluateTrans", "[evaluate]")
+            {
+              Vector<> values(ir.Size()), coefs(fel.GetNDof());
+              for (auto i : Range(values.Size()))
+                values[i] = sin(0.7*i+0.3);
+
+              fel.EvaluateTrans(ir,values,coefs);
+
+              SECTION ("SIMD", "[SIMD]")
+                {
+                  SIMD_IntegrationRule simdir(fel.ElementType(),fel.Order());
+                  Vector<SIMD<double>> simd_values(simdir.Size());
+                  AFlatVector<double> avalues(simdir.GetNIP(),&simd_values[0]);
+                  Vector<> simd_coefs(fel.GetNDof());
+                  simd_values = SIMD<double>(0.0);
+                  avalues = values;
+                  simd_coefs = 0.0;
+
+                  try
+                    {
+                      fel.AddTrans(simdir,simd_values,simd_coefs);
+                      SECTION("SIMD correctness", "[SIMD]")
+                        {
+                          CHECK(L2Norm(coefs-simd_coefs) < 1e-10);
+                        }
                     }
                   catch(Exception ex)
                     {
@@ -127,3 +169,87 @@ TEST_CASE ("FiniteElement", "[fem][finiteelement]")
         });
     }
 }
+
+
+// B-matrices via the ReferenceShapeCache and directly, and the element matrices sum_ip w B^T B
+template <typename FEL, int D>
+void TestReferenceShapeCache (int order)
+{
+  LocalHeap lh(10000000);
+  ELEMENT_TYPE et = FEL(order).ElementType();
+  int nv = ElementTopology::GetNVertices(et);
+
+  FEL fel1(order), fel2(order), fel3(order);
+  int vn1[4] = { 5, 2, 9, 7 }, vn2[4] = { 13, 1, 99, 50 }, vn3[4] = { 1, 2, 3, 4 };
+  fel1.SetVertexNumbers (FlatArray<int>(nv, vn1));
+  fel2.SetVertexNumbers (FlatArray<int>(nv, vn2));
+  fel3.SetVertexNumbers (FlatArray<int>(nv, vn3));
+  REQUIRE (fel1.GetClassNr() == fel2.GetClassNr());
+  REQUIRE (fel1.GetClassNr() != fel3.GetClassNr());
+
+  Matrix<> pts1(nv, D), pts2(nv, D);
+  for (int i = 0; i < nv; i++)
+    for (int j = 0; j < D; j++)
+      {
+        pts1(i,j) = ElementTopology::GetVertices(et)[i][j] + 0.1*sin(3*i+j);
+        pts2(i,j) = 2*ElementTopology::GetVertices(et)[i][j] + 0.2*cos(i+2*j);
+      }
+  FE_ElementTransformation<D,D> trafo1(et, pts1), trafo2(et, pts2);
+
+  T_DifferentialOperator<DiffOpGradient<D>> grad;
+  T_DifferentialOperator<DiffOpId<D>> id;
+  ReferenceShapeCache cache;
+
+  auto check = [&] (const DifferentialOperator & diffop, size_t nr, const FiniteElement & fel,
+                    const ElementTransformation & trafo, const SIMD_IntegrationRule & ir)
+    {
+      HeapReset hr(lh);
+      auto & mir = trafo(ir, lh);
+      size_t h = diffop.Dim()*fel.GetNDof();
+      Matrix<SIMD<double>> bcache(h, ir.Size()), bdirect(h, ir.Size());
+      REQUIRE (cache.CalcMatrix (diffop, nr, fel, mir, bcache, lh));
+      diffop.CalcMatrix (fel, mir, bdirect);
+
+      int ndof = fel.GetNDof(), dim = diffop.Dim();
+      Matrix<> elcache(ndof), eldirect(ndof);
+      elcache = 0.0;
+      eldirect = 0.0;
+      for (size_t k = 0; k < ir.Size(); k++)
+        for (size_t l = 0; l < SIMD<double>::Size(); l++)
+          {
+            double w = mir[k].GetWeight()[l];
+            for (int i = 0; i < ndof; i++)
+              for (int j = 0; j < ndof; j++)
+                for (int c = 0; c < dim; c++)
+                  {
+                    elcache(i,j) += w * bcache(i*dim+c,k)[l] * bcache(j*dim+c,k)[l];
+                    eldirect(i,j) += w * bdirect(i*dim+c,k)[l] * bdirect(j*dim+c,k)[l];
+                  }
+          }
+      CHECK (L2Norm(elcache-eldirect) < 1e-12 * L2Norm(eldirect));
+    };
+
+  SIMD_IntegrationRule ir(et, 2*order), ir2(et, 2*order+3);
+  for (int nr = 0; nr < 2; nr++)
+    {
+      const DifferentialOperator & diffop = nr ? (const DifferentialOperator&)id : grad;
+      check (diffop, nr, fel1, trafo1, ir);        // computes the reference matrix
+      check (diffop, nr, fel2, trafo2, ir);        // same class, from the cache
+      check (diffop, nr, fel3, trafo1, ir);        // other class
+      check (diffop, nr, fel2, trafo2, ir2);       // other integration rule
+      ReferenceShapeCache::Invalidate();
+      check (diffop, nr, fel1, trafo2, ir);
+    }
+}
+
+TEST_CASE ("ReferenceShapeCache", "[fem]")
+{
+  for (int order : { 1, 2, 4, 6 })
+    SECTION ("order = " + std::to_string(order))
+      {
+        SECTION ("H1 trig") { TestReferenceShapeCache<H1<ET_TRIG>,2> (order); }
+        SECTION ("H1 tet") { TestReferenceShapeCache<H1<ET_TET>,3> (order); }
+        SECTION ("L2 trig") { TestReferenceShapeCache<L2<ET_TRIG>,2> (order); }
+        SECTION ("L2 tet") { TestReferenceShapeCache<L2<ET_TET>,3> (order); }
+      }
+}
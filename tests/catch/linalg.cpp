@@ -0,0 +1,391 @@
+#include "catch.hpp"
+#include <la.hpp>
+using namespace ngla;
+
+inline double & Entry (double & v, int a, int b) { return v; }
+template <int N>
+inline double & Entry (Mat<N,N> & v, int a, int b) { return v(a,b); }
+
+// 5-point stencil on a n x n grid, with a convection part for non-symmetric storage
+template <typename TM = double>
+shared_ptr<SparseMatrixTM<TM>> GridMatrix (int n, bool symmetric)
+{
+  int nd = n*n;
+  int bs = mat_traits<TM>::HEIGHT;
+  TableCreator<int> creator(2*nd);
+  for ( ; !creator.Done(); creator++)
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        {
+          int v = i*n+j;
+          if (j+1 < n) { creator.Add (2*v, v); creator.Add (2*v, v+1); }
+          if (i+1 < n) { creator.Add (2*v+1, v); creator.Add (2*v+1, v+n); }
+        }
+  Table<int> edges = creator.MoveTable();
+
+  shared_ptr<SparseMatrixTM<TM>> mat;
+  if (symmetric)
+    mat = make_shared<SparseMatrixSymmetric<TM>> (nd, edges);
+  else
+    mat = make_shared<SparseMatrix<TM>> (nd, edges, edges, false);
+
+  for (int v = 0; v < nd; v++)
+    for (int w : mat->GetRowIndices(v))
+      for (int a = 0; a < bs; a++)
+        for (int b = 0; b < bs; b++)
+          {
+            double val;
+            if (w == v)
+              val = (a == b) ? 4.1 : 0.3;
+            else if (a == b)
+              val = symmetric ? -1 : (w > v ? -1.2 : -0.8);
+            else
+              val = 0.1*(a+1) - 0.07*b;
+            Entry ((*mat)(v,w), a, b) = val;
+          }
+  return mat;
+}
+
+// the full matrix with scalar entries
+template <typename TM>
+Matrix<> Dense (const SparseMatrixTM<TM> & mat)
+{
+  int bs = mat_traits<TM>::HEIGHT;
+  bool symmetric = dynamic_cast<const SparseMatrixSymmetric<TM>*> (&mat) != nullptr;
+  Matrix<> dense(bs*mat.Height(), bs*mat.Width());
+  dense = 0.0;
+  for (int i = 0; i < mat.Height(); i++)
+    for (int j : mat.GetRowIndices(i))
+      {
+        TM val = mat(i,j);
+        for (int a = 0; a < bs; a++)
+          for (int b = 0; b < bs; b++)
+            {
+              dense(bs*i+a, bs*j+b) = Entry(val, a, b);
+              if (symmetric) dense(bs*j+b, bs*i+a) = Entry(val, a, b);
+            }
+      }
+  return dense;
+}
+
+// dense solve of the rows and columns in inner, zero elsewhere
+Vector<> DenseSolve (const SparseMatrixTM<double> & mat, const BitArray * inner, FlatVector<> b)
+{
+  int nd = mat.Height();
+  Matrix<> dense = Dense (mat);
+  Vector<> rhs = b;
+  for (int i = 0; i < nd; i++)
+    if (inner && !inner->Test(i))
+      {
+        dense.Row(i) = 0.0;
+        dense.Col(i) = 0.0;
+        dense(i,i) = 1;
+        rhs(i) = 0;
+      }
+  CalcInverse (dense);
+  Vector<> x = dense * rhs;
+  return x;
+}
+
+double InnerResidual (const SparseMatrixTM<double> & mat, const BitArray * inner,
+                      const BaseVector & x, const BaseVector & b)
+{
+  VVector<double> ax(x.Size());
+  mat.Mult (x, ax);
+  double sum = 0;
+  for (size_t i = 0; i < ax.Size(); i++)
+    if (!inner || inner->Test(i))
+      sum += sqr(b.FV<double>()(i) - ax(i));
+  return sqrt(sum);
+}
+
+TEST_CASE ("JacobiPrecond colored Gauss-Seidel", "[linalg]")
+{
+  int n = 12, nd = n*n;
+  for (bool symmetric : { false, true })
+    for (bool use_inner : { false, true })
+      SECTION (string(symmetric ? "symmetric" : "non-symmetric") + (use_inner ? ", inner" : ""))
+        {
+          auto mat = GridMatrix (n, symmetric);
+          shared_ptr<BitArray> inner;
+          if (use_inner)
+            {
+              inner = make_shared<BitArray> (nd);
+              inner->Set();
+              for (int j = 0; j < n; j++)
+                inner->Clear(j);          // bottom row as dirichlet boundary
+            }
+          auto pre = mat->CreateJacobiPrecond (inner);
+
+          VVector<double> b(nd), x(nd), xseq(nd);
+          for (int i = 0; i < nd; i++)
+            b(i) = sin(0.3*i) + 1;
+          Vector<> exact = DenseSolve (*mat, inner.get(), b.FV());
+
+          // the solution is a fixed point of the sweeps
+          RunWithTaskManager ( [&] ()
+            {
+              for (int back = 0; back < 2; back++)
+                {
+                  x.FV() = exact;
+                  if (back) pre->GSSmoothBack (x, b);
+                  else pre->GSSmooth (x, b);
+                  Vector<> diff = x.FV() - exact;
+                  CHECK (L2Norm(diff) < 1e-12 * L2Norm(exact));
+                }
+            });
+
+          // both converge. A symmetric colored sweep repeats the last color,
+          // it reduces the residual less than the lexicographic one
+          x = 0.0;
+          xseq = 0.0;
+          RunWithTaskManager ( [&] ()
+            {
+              for (int it = 0; it < 50; it++)
+                {
+                  pre->GSSmooth (x, b);
+                  pre->GSSmoothBack (x, b);
+                }
+            });
+          for (int it = 0; it < 50; it++)
+            {
+              pre->GSSmooth (xseq, b);
+              pre->GSSmoothBack (xseq, b);
+            }
+          VVector<double> zero(nd);
+          zero = 0.0;
+          double res0 = InnerResidual (*mat, inner.get(), zero, b);
+          double res = InnerResidual (*mat, inner.get(), x, b);
+          double resseq = InnerResidual (*mat, inner.get(), xseq, b);
+          CHECK (resseq < 1e-4 * res0);
+          CHECK (res < 1e-2 * res0);
+          if (inner)
+            for (int i = 0; i < nd; i++)
+              if (!inner->Test(i))
+                CHECK (x(i) == 0.0);
+        }
+}
+
+
+// prolongation with two coarse dofs per fine dof
+shared_ptr<SparseMatrix<double>> TestProlongation (int nd, int nc)
+{
+  Array<int> elsperrow(nd);
+  elsperrow = 2;
+  auto prol = make_shared<SparseMatrix<double>> (elsperrow, nc);
+  for (int i = 0; i < nd; i++)
+    {
+      int I = (i*nc) / nd;
+      prol->CreatePosition (i, I);
+      prol->CreatePosition (i, (I+1) % nc);
+    }
+  for (int i = 0; i < nd; i++)
+    {
+      int I = (i*nc) / nd;
+      (*prol)(i, I) = 0.75 + 0.01*(i%5);
+      (*prol)(i, (I+1) % nc) = 0.25;
+    }
+  return prol;
+}
+
+// compares with the dense product, expanding prol to the block size
+template <typename TM>
+double GalerkinError (const SparseMatrixTM<TM> & mat, const SparseMatrixTM<double> & prol,
+                      const SparseMatrixTM<TM> & cmat)
+{
+  int bs = mat_traits<TM>::HEIGHT;
+  Matrix<> dprol = Dense (prol);
+  Matrix<> p(bs*prol.Height(), bs*prol.Width());
+  p = 0.0;
+  for (int i = 0; i < prol.Height(); i++)
+    for (int j = 0; j < prol.Width(); j++)
+      for (int a = 0; a < bs; a++)
+        p(bs*i+a, bs*j+a) = dprol(i,j);
+  Matrix<> ap = Dense (mat) * p;
+  Matrix<> ptap = Trans(p) * ap;
+  Matrix<> diff = Dense (cmat) - ptap;
+  return L2Norm (diff) / L2Norm (ptap);
+}
+
+template <typename TM>
+void TestGalerkin (bool symmetric)
+{
+  int n = 9, nd = n*n, nc = 20;
+  auto mat = GridMatrix<TM> (n, symmetric);
+  auto prol = TestProlongation (nd, nc);
+
+  auto cmat = dynamic_pointer_cast<SparseMatrixTM<TM>> (mat->Restrict (*prol));
+  REQUIRE (cmat);
+  CHECK ( (dynamic_pointer_cast<SparseMatrixSymmetric<TM>> (cmat) != nullptr) == symmetric);
+  CHECK (GalerkinError (*mat, *prol, *cmat) < 1e-14);
+
+  // refill: same pattern, new values
+  for (int i = 0; i < nd; i++)
+    for (auto & val : mat->GetRowValues(i))
+      val *= 2+i%3;
+  auto cmat2 = dynamic_pointer_cast<SparseMatrixTM<TM>> (mat->Restrict (*prol, cmat));
+  CHECK (cmat2 == cmat);
+  CHECK (GalerkinError (*mat, *prol, *cmat2) < 1e-14);
+
+  // a coarse matrix with too small pattern is not reused
+  TableCreator<int> creator(nc);
+  for ( ; !creator.Done(); creator++)
+    for (int I = 0; I < nc; I++)
+      creator.Add (I, I);
+  Table<int> diag = creator.MoveTable();
+  shared_ptr<SparseMatrixTM<TM>> small;
+  if (symmetric)
+    small = make_shared<SparseMatrixSymmetric<TM>> (nc, diag);
+  else
+    small = make_shared<SparseMatrix<TM>> (nc, diag, diag, false);
+  for (int I = 0; I < nc; I++)
+    for (auto & val : small->GetRowValues(I))
+      val = 1.0*(I+1);
+  Matrix<> small_before = Dense (*small);
+  auto cmat3 = dynamic_pointer_cast<SparseMatrixTM<TM>> (mat->Restrict (*prol, small));
+  CHECK (cmat3 != small);
+  // the rejected matrix is not touched, others may still use it
+  Matrix<> small_diff = Dense (*small) - small_before;
+  CHECK (L2Norm (small_diff) == 0.0);
+  CHECK (GalerkinError (*mat, *prol, *cmat3) < 1e-14);
+}
+
+TEST_CASE ("Galerkin product", "[linalg]")
+{
+  for (bool symmetric : { false, true })
+    SECTION (symmetric ? "symmetric" : "non-symmetric")
+      {
+        RunWithTaskManager ( [&] ()
+          {
+            SECTION ("double") { TestGalerkin<double> (symmetric); }
+            SECTION ("Mat<2,2>") { TestGalerkin<Mat<2,2>> (symmetric); }
+            SECTION ("Mat<3,3>") { TestGalerkin<Mat<3,3>> (symmetric); }
+          });
+      }
+}
+
+
+TEST_CASE ("Chebyshev-Jacobi smoothing", "[linalg]")
+{
+  int n = 12, nd = n*n, degree = 3;
+  double ratio = 10;
+  auto mat = GridMatrix (n, true);
+  for (bool use_inner : { false, true })
+    SECTION (use_inner ? "inner" : "all dofs")
+      {
+        shared_ptr<BitArray> inner;
+        if (use_inner)
+          {
+            inner = make_shared<BitArray> (nd);
+            inner->Set();
+            for (int j = 0; j < n; j++)
+              inner->Clear(j);
+          }
+        auto jac = mat->CreateJacobiPrecond (inner);
+
+        // dense dinv a
+        Matrix<> dense = Dense (*mat);
+        Matrix<> dinva(nd, nd);
+        for (int i = 0; i < nd; i++)
+          {
+            double dinv = (!inner || inner->Test(i)) ? 1/dense(i,i) : 0;
+            dinva.Row(i) = dinv * dense.Row(i);
+          }
+
+        // the eigenvalues of dinv a are those of the symmetric
+        // (d^{-1/2} a d^{-1/2}) on the inner dofs
+        Matrix<> sym(nd, nd), evecs(nd, nd);
+        Vector<> lami(nd);
+        for (int i = 0; i < nd; i++)
+          for (int j = 0; j < nd; j++)
+            {
+              bool free = (!inner || inner->Test(i)) && (!inner || inner->Test(j));
+              sym(i,j) = free ? dense(i,j) / sqrt(dense(i,i)*dense(j,j)) : 0;
+            }
+        CalcEigenSystem (sym, lami, evecs);
+        double lmax_exact = 0;
+        for (int i = 0; i < nd; i++)
+          lmax_exact = max2 (lmax_exact, lami(i));
+
+        double lmax = EstimateMaxEigenvalue (*mat, *jac, 10);
+        CHECK (lmax <= lmax_exact * (1+1e-10));
+        CHECK (lmax > 0.9 * lmax_exact);
+        lmax *= 1.1;
+
+        // the error is multiplied by T_degree((theta-dinv a)/delta) / T_degree(sigma)
+        double lmin = lmax / ratio;
+        double theta = (lmax+lmin)/2, delta = (lmax-lmin)/2, sigma = theta/delta;
+        Matrix<> x = (-1/delta) * dinva;
+        for (int i = 0; i < nd; i++)
+          x(i,i) += theta/delta;
+        Matrix<> tkm1 = Identity(nd), tk = x;
+        double tsm1 = 1, ts = sigma;
+        for (int k = 1; k < degree; k++)
+          {
+            Matrix<> tkp1 = 2 * x * tk - tkm1;
+            tkm1 = tk;
+            tk = tkp1;
+            double tsp1 = 2*sigma*ts - tsm1;
+            tsm1 = ts;
+            ts = tsp1;
+          }
+        Matrix<> poly = (1/ts) * tk;
+
+        VVector<double> b(nd), u(nd);
+        for (int i = 0; i < nd; i++)
+          b(i) = sin(0.3*i) + 1;
+        // the smoother keeps the dirichlet values, they are consistent with b
+        Vector<> exact = DenseSolve (*mat, inner.get(), b.FV());
+        b.FV() = dense * exact;
+
+        RunWithTaskManager ( [&] ()
+          {
+            // the solution is a fixed point
+            u.FV() = exact;
+            ChebyshevSmooth (*mat, *jac, lmax, ratio, degree, u, b);
+            Vector<> diff = u.FV() - exact;
+            CHECK (L2Norm(diff) < 1e-12 * L2Norm(exact));
+
+            // one step applies the polynomial to the error
+            for (int i = 0; i < nd; i++)
+              u(i) = exact(i) + ((!inner || inner->Test(i)) ? cos(1.7*i) : 0);
+            Vector<> err = u.FV() - exact;
+            Vector<> expected = poly * err;
+            ChebyshevSmooth (*mat, *jac, lmax, ratio, degree, u, b);
+            Vector<> newerr = u.FV() - exact;
+            Vector<> diffpoly = newerr - expected;
+            CHECK (L2Norm(diffpoly) < 1e-10 * L2Norm(err));
+
+            // |p| <= 1 on [0, lmax], the energy norm of the error does not grow
+            Vector<> aerr = dense * err, anewerr = dense * newerr;
+            CHECK (InnerProduct (newerr, anewerr) <= InnerProduct (err, aerr));
+          });
+      }
+}
+
+
+TEST_CASE ("SparseCholesky with given analysis", "[linalg]")
+{
+  int n = 8, nd = n*n;
+  auto mat = GridMatrix (n, true);
+  auto analysis = SparseCholeskyAnalysis::Get (*mat);
+  RunWithTaskManager ( [&] ()
+    {
+      SparseCholesky<double> inv(*mat, analysis);
+      VVector<double> b(nd), x(nd);
+      for (int i = 0; i < nd; i++)
+        b(i) = sin(0.3*i) + 1;
+      x = inv * b;
+      CHECK (InnerResidual (*mat, nullptr, x, b) < 1e-10 * L2Norm (b.FV()));
+
+      // same size, different pattern
+      TableCreator<int> creator(nd);
+      for ( ; !creator.Done(); creator++)
+        for (int i = 0; i < nd; i++)
+          creator.Add (i, i);
+      Table<int> diag = creator.MoveTable();
+      auto dmat = make_shared<SparseMatrixSymmetric<double>> (nd, diag);
+      dmat->AsVector() = 1.0;
+      CHECK_THROWS_AS (SparseCholesky<double> (*dmat, analysis), Exception);
+    });
+}
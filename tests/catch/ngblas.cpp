@@ -48,6 +48,62 @@ TEST_CASE ("SubAtDB", "[ngblas]") {
     }
 }
 
+TEST_CASE ("CalcSchurComplement SIMD", "[ngblas]") {
+    constexpr size_t SW = SIMD<double>::Size();
+    for (int n = 1; n < 20; n++) {
+        for (int no = 0; no < n; no++) {
+            SECTION ("n = "+to_string(n)+", nouter = "+to_string(no)) {
+                // non-symmetric, diagonally dominant, different in every lane
+                Matrix<SIMD<double>> a(n,n);
+                for (int i = 0; i < n; i++)
+                    for (int j = 0; j < n; j++)
+                        a(i,j) = SIMD<double>([&] (int l) { return sin(3*i+5*j+l) + (i==j ? n : 0); });
+
+                Matrix<SIMD<double>> s = a, sinv = a;
+                SIMD<double> piv = CalcSchurComplement (s, no);
+                CalcSchurComplement (sinv, no, true);
+
+                int ni = n-no;
+                for (size_t l = 0; l < SW; l++) {
+                    Matrix<> d(ni,ni), b(no,ni), c(ni,no), schur(no,no);
+                    for (int i = 0; i < no; i++)
+                        for (int j = 0; j < no; j++)
+                            schur(i,j) = a(i,j)[l];
+                    for (int i = 0; i < ni; i++) {
+                        for (int j = 0; j < ni; j++)
+                            d(i,j) = a(no+i,no+j)[l];
+                        for (int j = 0; j < no; j++) {
+                            b(j,i) = a(j,no+i)[l];
+                            c(i,j) = a(no+i,j)[l];
+                        }
+                    }
+                    CalcInverse (d);
+                    Matrix<> dc = d * c;
+                    Matrix<> bd = b * d;
+                    schur -= b * dc;
+                    double err = 0, errinv = 0;
+                    for (int i = 0; i < no; i++)
+                        for (int j = 0; j < no; j++) {
+                            err = max(err, fabs(schur(i,j)-s(i,j)[l]));
+                            errinv = max(errinv, fabs(schur(i,j)-sinv(i,j)[l]));
+                        }
+                    for (int i = 0; i < ni; i++) {
+                        for (int j = 0; j < ni; j++)
+                            errinv = max(errinv, fabs(d(i,j)-sinv(no+i,no+j)[l]));
+                        for (int j = 0; j < no; j++) {
+                            errinv = max(errinv, fabs(dc(i,j)-sinv(no+i,j)[l]));
+                            errinv = max(errinv, fabs(bd(j,i)+sinv(j,no+i)[l]));
+                        }
+                    }
+                    CHECK(err < 1e-12 * n);
+                    CHECK(errinv < 1e-12 * n);
+                    CHECK(piv[l] > 0.1);
+                }
+            }
+        }
+    }
+}
+
 TEST_CASE ("SIMD<double>", "[simd]") {
     constexpr size_t N = SIMD<double>::Size();
     double src[N];
@@ -0,0 +1,93 @@
+#include "catch.hpp"
+#include <ngstd.hpp>
+using namespace ngstd;
+
+// runs alg with nthreads threads and the work-stealing backend
+void RunWorkStealing (int nthreads, function<void()> alg)
+{
+  int prev_threads = TaskManager::GetMaxThreads();
+  bool prev_ws = TaskManager::GetWorkStealing();
+  TaskManager::SetNumThreads (nthreads);
+  TaskManager::SetWorkStealing (true);
+  RunWithTaskManager (alg);
+  TaskManager::SetWorkStealing (prev_ws);
+  TaskManager::SetNumThreads (prev_threads);
+}
+
+TEST_CASE ("Work-stealing TaskManager", "[ngstd]")
+{
+  int nthreads = 4;
+
+  SECTION ("imbalanced ParallelFor")
+    {
+      size_t n = 1000;
+      Array<size_t> result(n);
+      result = 0;
+      Array<atomic<int>> tasks_of_thread(nthreads);
+      for (auto & c : tasks_of_thread) c = 0;
+
+      RunWorkStealing (nthreads, [&] ()
+        {
+          // all the work is in the lower range, which is started
+          // by the thread creating the job
+          ParallelFor (n, [&] (size_t i)
+                       {
+                         if (i < 20)
+                           this_thread::sleep_for (chrono::milliseconds(5));
+                         result[i] = i*i;
+                         tasks_of_thread[TaskManager::GetThreadId()]++;
+                       }, 100);
+        });
+
+      for (size_t i = 0; i < n; i++)
+        CHECK (result[i] == i*i);
+      int sum = 0;
+      for (auto & c : tasks_of_thread) sum += c;
+      CHECK (sum == n);
+      // the creating thread has id 0, tasks elsewhere were stolen
+      CHECK (tasks_of_thread[0] < n);
+    }
+
+  SECTION ("nested ParallelJob")
+    {
+      int nouter = 8, ninner = 200;
+      Array<atomic<int>> sums(nouter);
+      for (auto & s : sums) s = 0;
+      atomic<int> stolen(0);
+
+      RunWorkStealing (nthreads, [&] ()
+        {
+          ParallelJob ([&] (TaskInfo & ti)
+                       {
+                         int outer = ti.task_nr;
+                         int creator = TaskManager::GetThreadId();
+                         ParallelJob ([&] (TaskInfo & ti2)
+                                      {
+                                        if (outer == 0)
+                                          this_thread::sleep_for (chrono::microseconds(500));
+                                        if (ti2.thread_nr != creator) stolen++;
+                                        sums[outer] += ti2.task_nr;
+                                      }, ninner);
+                       }, nouter);
+        });
+
+      for (int i = 0; i < nouter; i++)
+        CHECK (sums[i] == ninner*(ninner-1)/2);
+      CHECK (stolen > 0);
+    }
+
+  SECTION ("exception")
+    {
+      RunWorkStealing (nthreads, [&] ()
+        {
+          CHECK_THROWS_AS (ParallelFor (100, [] (size_t i)
+                                        {
+                                          if (i == 77) throw Exception ("task 77");
+                                        }), Exception);
+          // the task manager is usable afterwards
+          atomic<int> cnt(0);
+          ParallelFor (100, [&] (size_t i) { cnt++; });
+          CHECK (cnt == 100);
+        });
+    }
+}
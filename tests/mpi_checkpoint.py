@@ -0,0 +1,27 @@
+# Call with:
+#   mpirun -np N ngspy mpi_checkpoint.py save|load filename
+# A checkpoint saved with N processes is loaded with any number of processes.
+
+import sys
+from ngsolve import *
+
+comm = MPI_Init()
+ngsglobals.msg_level = 1
+mode, filename = sys.argv[1], sys.argv[2]
+
+mesh = Mesh("pytest/square.vol.gz")
+fes = H1(mesh, order=4)
+# in the space, Set gives the same function for every partition
+exact = x*x*x*y + y*y - 2*x*y
+
+u = GridFunction(fes)
+if mode == "save":
+    u.Set(exact)
+    u.SaveCheckpoint(filename)
+else:
+    u.LoadCheckpoint(filename)
+    err = sqrt(Integrate((u-exact)*(u-exact), mesh))
+    if comm.rank == 0:
+        print("np =", comm.size, "L2-error:", err)
+    if err > 1e-12:
+        raise Exception("checkpoint " + filename + " not restored, error " + str(err))
@@ -1,4 +1,5 @@
 import pytest
+import os, shutil
 from netgen.geom2d import unit_square
 from netgen.csg import unit_cube
 from ngsolve import *
@@ -78,7 +79,98 @@ def test_code_generation_derivatives():
         vals -= vals_ref
         assert Norm(vals) < 1e-13
 
+def test_code_generation_deep_tree():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+
+    # many short-lived temporaries, evaluated in-process with re-used slots
+    cf = CoefficientFunction(1)
+    for i in range(30):
+        cf = sin(cf*x) + CoefficientFunction((x,y,i)).Norm() * cos(y+i)
+
+    f = cf.Compile()
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
+def timer_counts(name):
+    return sum(t["counts"] for t in Timers() if t["name"] == name)
+
+def cache_hits():
+    return timer_counts("CompiledCF::Cache hit")
+
+def test_code_generation_cache_pointers(tmpdir, monkeypatch):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    monkeypatch.setenv("NGS_COMPILE_CACHE", str(tmpdir.mkdir("cache")))
+    # the Parameter is accessed via a pointer variable of the library
+    p = Parameter(2.5)
+    cf = p*x+y
+    f = cf.Compile(True, wait=True)
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
+    # other compilations in between do not change the generated code
+    g = (Parameter(1)*y).Compile(True, wait=True)
+    hits = cache_hits()
+    p.Set(1.5)
+    f = cf.Compile(True, wait=True)
+    assert cache_hits() == hits+1
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
+@pytest.mark.skipif(os.name == "nt", reason="uses a shell script as compiler wrapper")
+def test_code_generation_cache(tmpdir, monkeypatch):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    cachedir = tmpdir.mkdir("cache")
+    monkeypatch.setenv("NGS_COMPILE_CACHE", str(cachedir))
+    cf = sin(x)*y+3.7
+
+    f = cf.Compile(True, wait=True)
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+    assert len(cachedir.listdir()) == 1
+
+    # same code and build configuration: loaded from the cache
+    hits = cache_hits()
+    f = cf.Compile(True, wait=True)
+    assert cache_hits() == hits+1
+    assert len(cachedir.listdir()) == 1
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
+    # a changed compiler wrapper invalidates the entry
+    ngscxx = shutil.which("ngscxx")
+    if ngscxx is None:
+        pytest.skip("ngscxx not found in PATH")
+    bindir = tmpdir.mkdir("bin")
+    wrapper = bindir.join("ngscxx")
+    wrapper.write('#!/bin/sh\n# other flags\nexec "{}" "$@"\n'.format(ngscxx))
+    wrapper.chmod(0o755)
+    monkeypatch.setenv("PATH", str(bindir) + os.pathsep + os.environ["PATH"])
+    hits = cache_hits()
+    f = cf.Compile(True, wait=True)
+    assert cache_hits() == hits
+    assert len(cachedir.listdir()) == 2
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
+def test_code_generation_interpreter_backend(monkeypatch):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    monkeypatch.setenv("NGS_COMPILE_BACKEND", "interpreter")
+    cf = exp(x)*y + CoefficientFunction((x,y)).Norm()
+
+    compiles = timer_counts("CompiledCF::Compile")
+    f = cf.Compile(True, wait=True)
+    assert timer_counts("CompiledCF::Compile") == compiles
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
+@pytest.mark.skipif(os.name == "nt", reason="hides the compiler via PATH")
+def test_code_generation_compiler_fallback(tmpdir, monkeypatch, capfd):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    monkeypatch.setenv("NGS_COMPILE_CACHE", "0")
+    monkeypatch.setenv("PATH", str(tmpdir.mkdir("empty")))
+    cf = cos(x)*y*y + 1.3
+
+    f = cf.Compile(True, wait=True)
+    err = capfd.readouterr().err
+    assert "Compilation of CoefficientFunction failed" in err
+    # evaluated in-process instead
+    assert (Integrate ( (cf-f)*(cf-f), mesh)<1e-13)
+
 if __name__ == "__main__":
+    test_code_generation_deep_tree()
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
     test_code_generation_volume_terms_complex()
@@ -99,7 +99,28 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_sparsematrix_sell():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=3)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    for symmetric in [False, True]:
+        a = BilinearForm(fes, symmetric=symmetric)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v)
+        a.Assemble()
+        sell = a.mat.ToSELL(sigma=32)
+        x = a.mat.CreateColVector()
+        x.FV().NumPy()[:] = np.random.rand(fes.ndof)
+        y1 = a.mat.CreateColVector()
+        y2 = a.mat.CreateColVector()
+        y1.data = a.mat * x
+        y2.data = sell * x
+        assert Norm(y1-y2) < 1e-10 * Norm(y1)
+        y1.data = a.mat.T * x
+        y2.data = sell.T * x
+        assert Norm(y1-y2) < 1e-10 * Norm(y1)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_sparsematrix_sell()
@@ -13,3 +13,176 @@ def test_multiple_meshes_refine():
 
     for v in range(mesh.nv):
         assert parents[v] == mesh.GetParentVertices(v)
+
+def test_geometry_cache():
+    geo = CSGeometry()
+    geo.Add(Sphere(Pnt(0,0,0),1))
+    mesh = Mesh(geo.GenerateMesh(maxh=0.5))
+    mesh.Curve(3)
+    fes = H1(mesh, order=3)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    ref = a.mat.AsVector().CreateVector()
+    ref.data = a.mat.AsVector()
+
+    budget = 100*1000*1000
+    mesh.SetGeometryCache(budget)
+    assert mesh.GeometryCacheUsed() == 0
+    for i in range(2):
+        a.Assemble()
+        assert 0 < mesh.GeometryCacheUsed() <= budget
+        diff = ref.CreateVector()
+        diff.data = ref - a.mat.AsVector()
+        assert Norm(diff) < 1e-12 * Norm(ref)
+
+    # a small budget is never exceeded, the other elements are computed
+    budget = 20000
+    mesh.SetGeometryCache(budget)
+    a.Assemble()
+    assert 0 < mesh.GeometryCacheUsed() <= budget
+    diff = ref.CreateVector()
+    diff.data = ref - a.mat.AsVector()
+    assert Norm(diff) < 1e-12 * Norm(ref)
+    mesh.SetGeometryCache(0)
+    assert mesh.GeometryCacheUsed() == 0
+
+vtu_types = { "Float32" : "<f4", "Int64" : "<i8", "UInt8" : "u1" }
+
+def read_vtu_block(data, offset, encoding, compressed):
+    """one array of the appended data, with UInt64 headers"""
+    import base64, struct, zlib
+    # bytes at position pos, header and data are base64 encoded separately
+    def read(pos, nbytes):
+        if encoding == "base64":
+            nchars = 4*((nbytes+2)//3)
+            return base64.b64decode(data[pos:pos+nchars])[:nbytes], nchars
+        return data[pos:pos+nbytes], nbytes
+    if not compressed:
+        head, n = read(offset, 8)
+        return read(offset+n, struct.unpack("<Q", head)[0])[0]
+    nblocks = struct.unpack("<3Q", read(offset, 24)[0])[0]
+    head, n = read(offset, 8*(3+nblocks))
+    sizes = struct.unpack("<%dQ" % nblocks, head[24:])
+    body, pos, result = read(offset+n, sum(sizes))[0], 0, b""
+    for size in sizes:
+        result += zlib.decompress(body[pos:pos+size])
+        pos += size
+    return result
+
+def read_vtu(filename):
+    """arrays of a vtu file by name, the points are called 'Points',
+    arrays of a time series by (name, timestep)"""
+    import re
+    import numpy as np
+    with open(filename, "rb") as f:
+        content = f.read()
+    start = content.index(b"<AppendedData")
+    xml = content[:start].decode()
+    encoding = re.match(rb'<AppendedData encoding="(\w+)"', content[start:]).group(1).decode()
+    data = content[content.index(b"_", start)+1:]
+    compressed = "compressor=" in xml
+    arrays = {}
+    for tag in re.findall(r'<DataArray [^>]*>', xml):
+        name = re.search(r'Name="([^"]*)"', tag)
+        name = name.group(1) if name else "Points"
+        timestep = re.search(r'TimeStep="(\d+)"', tag)
+        if timestep:
+            name = (name, int(timestep.group(1)))
+        dtype = vtu_types[re.search(r'type="(\w+)"', tag).group(1)]
+        offset = int(re.search(r'offset="(\d+)"', tag).group(1))
+        arrays[name] = np.frombuffer(read_vtu_block(data, offset, encoding, compressed), dtype=dtype)
+    return arrays
+
+def check_vtu_geometry(mesh, arrays):
+    """without subdivision, every tet is a cell through its vertices"""
+    import numpy as np
+    points = arrays["Points"].reshape((-1,3))
+    offsets = arrays["offsets"]
+    connectivity = arrays["connectivity"]
+    assert len(offsets) == mesh.ne
+    assert all(arrays["types"] == 10)
+    first = 0
+    for el, last in zip(mesh.Elements(VOL), offsets):
+        cellpoints = sorted(tuple(p) for p in points[connectivity[first:last]])
+        vertices = sorted(mesh[v].point for v in el.vertices)
+        assert np.allclose(cellpoints, vertices, atol=1e-6)
+        first = last
+    return points
+
+def vtu_compression_available(mesh):
+    try:
+        VTKOutput(ma=mesh, coefs=[], names=[], filename="vtutest", format="vtu", compress=True)
+        return True
+    except Exception:
+        return False
+
+def test_vtu_output():
+    import os
+    import numpy as np
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.5))
+    fes = H1(mesh, order=2)
+    gfu = GridFunction(fes)
+    gfu.Set(x*y)
+    # VTKOutput throws for compress=True if NGSolve is built without zlib
+    compress_options = [False, True] if vtu_compression_available(mesh) else [False]
+    for encoding in ["raw", "base64"]:
+        for compress in compress_options:
+            vtk = VTKOutput(ma=mesh, coefs=[gfu, grad(gfu)], names=["u", "gradu"], filename="vtuout",
+                            subdivision=0, format="vtu", encoding=encoding, compress=compress)
+            vtk.Do()
+            with open("vtuout.vtu", "rb") as f:
+                header = f.read(1000)
+            assert b'NumberOfCells="%d"' % mesh.ne in header
+            assert b'Name="gradu" NumberOfComponents="3"' in header
+            assert (b'compressor' in header) == compress
+
+            arrays = read_vtu("vtuout.vtu")
+            points = check_vtu_geometry(mesh, arrays)
+            px, py = points[:,0], points[:,1]
+            assert np.allclose(arrays["u"], px*py, atol=1e-5)
+            gradu = arrays["gradu"].reshape((-1,3))
+            assert np.allclose(gradu, np.stack([py, px, 0*px], axis=1), atol=1e-5)
+            os.remove("vtuout.vtu")
+
+def test_vtu_timeseries():
+    import os, re
+    import numpy as np
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.5))
+    fes = H1(mesh, order=1)
+    gfu = GridFunction(fes)
+    vtk = VTKOutput(ma=mesh, coefs=[gfu], names=["u"], filename="vtuseries", format="vtu")
+    nsteps = 30
+    for i in range(nsteps):
+        gfu.Set(i*x)
+        vtk.Do(time=0.1*i)
+
+    # one file, the geometry is stored once
+    assert not os.path.exists("vtuseries_1.vtu")
+    with open("vtuseries.pvd") as f:
+        pvd = f.read()
+    assert pvd.count("<DataSet") == nsteps
+    assert pvd.count('file="vtuseries.vtu"') == nsteps
+    arrays = read_vtu("vtuseries.vtu")
+    points = check_vtu_geometry(mesh, arrays)
+    for i in range(nsteps):
+        assert np.allclose(arrays[("u",i)], i*points[:,0], atol=1e-5)
+    with open("vtuseries.vtu", "rb") as f:
+        header = f.read().split(b"<AppendedData")[0].decode()
+    assert header.count('Name="connectivity"') == 1
+    times = [float(t) for t in re.search(r'TimeValues="([^"]*)"', header).group(1).split()]
+    assert np.allclose(times, [0.1*i for i in range(nsteps)])
+
+    # curving changes the geometry, a new series file starts
+    mesh.Curve(2)
+    vtk.Do(time=0.1*nsteps)
+    with open("vtuseries.pvd") as f:
+        pvd = f.read()
+    assert pvd.count('file="vtuseries_%d.vtu"' % nsteps) == 1
+    arrays = read_vtu("vtuseries_%d.vtu" % nsteps)
+    check_vtu_geometry(mesh, arrays)
+    assert ("u",0) in arrays and ("u",1) not in arrays
+
+    for name in ["vtuseries.pvd", "vtuseries.vtu", "vtuseries_%d.vtu" % nsteps]:
+        os.remove(name)
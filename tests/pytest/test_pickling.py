@@ -2,6 +2,7 @@ from netgen.geom2d import *
 from ngsolve import *
 import pickle
 import io
+import pytest
 
 def test_pickle_volume_fespaces():
     mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
@@ -182,6 +183,44 @@ def test_pickle_periodic():
 
     assert sqrt(Integrate((u-u2)*(u-u2),mesh)) < 1e-14
 
+def test_mapped_gridfunction(tmpdir):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    for complex in [False, True]:
+        fes = H1(mesh,order=3,complex=complex)
+        u = GridFunction(fes)
+        u.Set(x*y+1j*x if complex else x*y)
+        filename = str(tmpdir.join("u.ngm"))
+        u.Save(filename, mapped=True)
+        u2 = GridFunction(fes)
+        u2.Load(filename, mapped=True)
+        assert sqrt(Integrate(Norm(u-u2)**2,mesh)) < 1e-14
+        u2.vec[:] = 0
+        u3 = GridFunction(fes)
+        u3.Load(filename, mapped=True)
+        assert sqrt(Integrate(Norm(u-u3)**2,mesh)) < 1e-14
+
+def test_checkpoint_gridfunction(tmpdir):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh,order=4)
+    u = GridFunction(fes)
+    u.Set(sin(3*x)*y)
+    filename = str(tmpdir.join("u.ckpt"))
+    u.SaveCheckpoint(filename)
+    u2 = GridFunction(fes)
+    u2.LoadCheckpoint(filename)
+    assert sqrt(Integrate((u-u2)*(u-u2),mesh)) < 1e-14
+
+def test_checkpoint_nodeless_dofs(tmpdir):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = FESpace([H1(mesh,order=2), NumberSpace(mesh)])
+    u = GridFunction(fes)
+    filename = str(tmpdir.join("u.ckpt"))
+    # the number dof is not on a mesh node, it must not get lost silently
+    with pytest.raises(Exception, match="attached to mesh nodes"):
+        u.SaveCheckpoint(filename)
+    with pytest.raises(Exception, match="attached to mesh nodes"):
+        u.LoadCheckpoint(filename)
+
 
 if __name__ == "__main__":
     test_pickle_volume_fespaces()
@@ -44,5 +44,226 @@ def test_arnoldi():
 
 
 
+def test_mixed_precision_refinement():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    f.Assemble()
+    pre = Preconditioner(a, "local")
+    pre.Update()
+
+    for storage in ["float", "bf16"]:
+        amixed = a.mat.ToMixedPrecision(storage)
+        inner = CGSolver(amixed, pre.mat, printrates=False, precision=1e-3, maxsteps=500)
+        inv = IterativeRefinement(a.mat, inner, precision=1e-12, maxsteps=50)
+        gfu = GridFunction(fes)
+        gfu.vec.data = inv * f.vec
+        res = f.vec.CreateVector()
+        res.data = f.vec - a.mat * gfu.vec
+        assert Norm(res) < 1e-10 * Norm(f.vec)
+        assert inv.GetSteps() < 50
+
+def test_pipelined_cg():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    for complex in [False, True]:
+        fes = H1(mesh, order=3, complex=complex, dirichlet="left|bottom")
+        u,v = fes.TrialFunction(), fes.TestFunction()
+        a = BilinearForm(fes, symmetric=True)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v)
+        a.Assemble()
+        f = LinearForm(fes)
+        f += SymbolicLFI(v)
+        f.Assemble()
+        pre = Preconditioner(a, "local")
+        pre.Update()
+
+        gfu = GridFunction(fes)
+        gfu.vec.data = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-12, maxsteps=1000) * f.vec
+        inv = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-12, maxsteps=1000, pipelined=True)
+        gfu2 = GridFunction(fes)
+        gfu2.vec.data = inv * f.vec
+        gfu2.vec.data -= gfu.vec
+        assert Norm(gfu2.vec) < 1e-8 * Norm(gfu.vec)
+        assert inv.GetSteps() < 1000
+
+def test_block_solvers():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    b = BilinearForm(fes)
+    b += SymbolicBFI(grad(u)*grad(v)+(2*grad(u)[0]+grad(u)[1])*v+u*v)
+    b.Assemble()
+    pre = Preconditioner(a, "local")
+    pre.Update()
+
+    rhs = [x*v, y*v, v, x*y*v]
+    F = MultiVector(a.mat.CreateColVector(), len(rhs))
+    for i,r in enumerate(rhs):
+        f = LinearForm(fes)
+        f += SymbolicLFI(r)
+        f.Assemble()
+        F.SetVector(i, f.vec)
+
+    for mat, solver in [(a.mat, BlockCGSolver(a.mat, pre.mat, precision=1e-12, maxsteps=1000)),
+                        (b.mat, BlockGMRESSolver(b.mat, pre.mat, precision=1e-12, maxsteps=1000))]:
+        U = MultiVector(a.mat.CreateColVector(), len(rhs))
+        solver.Solve(F, U)
+        assert solver.GetSteps() < 1000
+        f = a.mat.CreateColVector()
+        gfu = GridFunction(fes)
+        for i in range(len(rhs)):
+            F.GetVector(i, f)
+            U.GetVector(i, gfu.vec)
+            res = f.CreateVector()
+            res.data = f - mat * gfu.vec
+            assert Norm(res) < 1e-8 * Norm(f)
+
+def test_chebyshev_smoother():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=1, dirichlet="left|bottom")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    pre = Preconditioner(a, "multigrid", smoother="chebyshev")
+    a.Assemble()
+    for l in range(3):
+        mesh.Refine()
+        fes.Update()
+        a.Assemble()
+    f.Assemble()
+
+    inv = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-10, maxsteps=200)
+    gfu = GridFunction(fes)
+    gfu.vec.data = inv * f.vec
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * gfu.vec
+    for i in range(fes.ndof):
+        if not fes.FreeDofs()[i]:
+            res[i] = 0
+    assert Norm(res) < 1e-8 * Norm(f.vec)
+    assert inv.GetSteps() < 50
+
+def test_amg_elasticity():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = VectorH1(mesh, order=2, dirichlet="left")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    eps = lambda w: 0.5*(grad(w)+grad(w).trans)
+    a = BilinearForm(fes)
+    a += SymbolicBFI(2*InnerProduct(eps(u),eps(v)) + div(u)*div(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(-v[1])
+    pre = Preconditioner(a, "saamg", rigidbodymodes=True)
+    a.Assemble()
+    f.Assemble()
+
+    inv = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-10, maxsteps=500)
+    gfu = GridFunction(fes)
+    gfu.vec.data = inv * f.vec
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * gfu.vec
+    for i in range(fes.ndof):
+        if not fes.FreeDofs()[i]:
+            res[i] = 0
+    assert Norm(res) < 1e-8 * Norm(f.vec)
+    assert inv.GetSteps() < 100
+
+def test_static_condensation():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    fes = H1(mesh, order=5, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    f = LinearForm(fes)
+    f += SymbolicLFI(x*v)
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    for symmetric in [True, False]:
+        form = grad(u)*grad(v)+u*v
+        # the default inverse may be sparsecholesky, which needs a symmetric matrix
+        inverse = "" if symmetric else "umfpack"
+        if not symmetric:
+            form = form + grad(u)[0]*v
+        a = BilinearForm(fes, symmetric=symmetric)
+        a += SymbolicBFI(form)
+        a.Assemble()
+        try:
+            inv = a.mat.Inverse(fes.FreeDofs(), inverse=inverse)
+        except Exception:
+            pytest.skip("umfpack not available, non-symmetric case not tested")
+        gfu.vec.data = inv * f.vec
+
+        ac = BilinearForm(fes, symmetric=symmetric, eliminate_internal=True)
+        ac += SymbolicBFI(form)
+        ac.Assemble()
+        rhs = f.vec.CreateVector()
+        rhs.data = f.vec
+        rhs.data += ac.harmonic_extension_trans * f.vec
+        gfuc = GridFunction(fes)
+        gfuc.vec.data = ac.mat.Inverse(fes.FreeDofs(True), inverse=inverse) * rhs
+        gfuc.vec.data += ac.harmonic_extension * gfuc.vec
+        gfuc.vec.data += ac.inner_solve * rhs
+        gfuc.vec.data -= gfu.vec
+        assert Norm(gfuc.vec) < 1e-10 * Norm(gfu.vec)
+
+def test_sparsecholesky():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    for order, complex in [(1, False), (3, False), (3, True)]:
+        fes = H1(mesh, order=order, complex=complex, dirichlet=".*")
+        u,v = fes.TrialFunction(), fes.TestFunction()
+        a = BilinearForm(fes, symmetric=True)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v)
+        a.Assemble()
+        f = LinearForm(fes)
+        f += SymbolicLFI(x*v)
+        f.Assemble()
+        for inverse in ["sparsecholesky", "sparsecholesky_nd"]:
+            gfu = GridFunction(fes)
+            gfu.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse=inverse) * f.vec
+            res = f.vec.CreateVector()
+            res.data = f.vec - a.mat * gfu.vec
+            for i in range(fes.ndof):
+                if not fes.FreeDofs()[i]:
+                    res[i] = 0
+            assert Norm(res) < 1e-10 * Norm(f.vec)
+
+def test_sparsecholesky_analysis():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    f.Assemble()
+
+    analysis = None
+    for c in [1, 10, 100]:
+        a = BilinearForm(fes, symmetric=True)
+        a += SymbolicBFI(grad(u)*grad(v)+c*u*v)
+        a.Assemble()
+        if analysis is None:
+            analysis = SparseCholeskyAnalysis(a.mat, fes.FreeDofs())
+        else:
+            assert SparseCholeskyAnalysis(a.mat, fes.FreeDofs()) is analysis
+        inv = SparseCholesky(a.mat, analysis)
+        gfu = GridFunction(fes)
+        gfu.vec.data = inv * f.vec
+        gfu2 = GridFunction(fes)
+        gfu2.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+        gfu2.vec.data -= gfu.vec
+        assert Norm(gfu2.vec) < 1e-10 * Norm(gfu.vec)
+
 if __name__ == "__main__":
     test_arnoldi()
+    test_mixed_precision_refinement()
+    test_sparsecholesky()
+    test_sparsecholesky_analysis()
@@ -0,0 +1,38 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+import pytest
+
+def assemble_laplace():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    a.Assemble()
+
+def test_timers_fields():
+    assemble_laplace()
+    timers = Timers()
+    assert len([t for t in timers if t["counts"] > 0]) > 0
+    for t in timers:
+        for key in ["name", "time", "counts", "flops", "Gflop/s"]:
+            assert key in t
+
+def test_hardware_counters():
+    available = EnableHardwareCounters()
+    try:
+        assemble_laplace()
+        counted = [t for t in Timers() if "cycles" in t]
+        if not available:
+            assert len(counted) == 0
+            pytest.skip("hardware counters not available")
+        assert len(counted) > 0
+        for t in counted:
+            for key in ["instructions", "llc_misses", "bytes", "GB/s"]:
+                assert key in t
+            assert t["bytes"] == 64 * t["llc_misses"]
+            # threads without counters must not add zeros to the sums
+            if t["cycles"] > 10**6:
+                assert 0.01 < t["instructions"] / t["cycles"] < 16
+    finally:
+        EnableHardwareCounters(False)
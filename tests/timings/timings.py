@@ -5,6 +5,7 @@ import multiprocessing
 from ngsolve import *
 import json
 import os
+import time
 ngsglobals.msg_level=0
 
 import argparse
@@ -45,6 +46,7 @@ else:
     timings = results["timings"]
     timings["FESpace"] = []
     timings["Element"] = []
+    timings["Assemble"] = []
 
 
 # test fespaces
@@ -81,6 +83,40 @@ for mesh in meshes:
                     timings["FESpace"].append(tim)
 
 
+# compare assembling with element coloring and in mesh order with atomic adds
+def TimeAssemble(fes, nocoloring, nruns=3):
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True, nocoloring=nocoloring)
+    a += SymbolicBFI(InnerProduct(u,v))
+    a.Assemble()
+    start = time.time()
+    for i in range(nruns):
+        a.Assemble()
+    return (time.time()-start)/nruns
+
+for mesh in meshes:
+    for order in orders:
+        for i in range(len(fes_types)):
+            fes = fes_types[i](mesh,order=order)
+            for nocoloring in [False, True]:
+                tim = {}
+                tim['dimension'] = mesh.dim
+                tim['fespace'] = fes_names[i]
+                tim['order'] = order
+                tim['name'] = "Assemble" + (" nocoloring" if nocoloring else "")
+                if args.sequential:
+                    tim['time'] = TimeAssemble(fes, nocoloring)
+                    tim['taskmanager'] = 0
+                    tim['nthreads'] = 1
+                    timings["Assemble"].append(dict(tim))
+                if args.parallel:
+                    with TaskManager():
+                        tim['time'] = TimeAssemble(fes, nocoloring)
+                    tim['taskmanager'] = 1
+                    tim['nthreads'] = ngsglobals.numthreads
+                    timings["Assemble"].append(dict(tim))
+
+
 orders = [1,2,4,8]
 mesh2 = Mesh(unit_square.GenerateMesh(maxh=3))
 mesh3 = Mesh(unit_cube.GenerateMesh(maxh=1))